@@ -0,0 +1,236 @@
+/*
+ * adxl345_spi.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * SPI (4-wire) backend for the ADXL345 accelerometer.  See adxl345_spi.h.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <util/delay.h>
+#include "spibus/spibus.h"
+#include "adxl345_spi.h"
+
+/* ADXL345 register addresses */
+#define ADXL_REG_DEVID       0x00
+#define ADXL_REG_THRESH_ACT  0x24
+#define ADXL_REG_ACT_INACT   0x27
+#define ADXL_REG_BW_RATE     0x2c
+#define ADXL_REG_POWER_CTL   0x2d
+#define ADXL_REG_INT_ENABLE  0x2e
+#define ADXL_REG_INT_MAP     0x2f
+#define ADXL_REG_INT_SOURCE  0x30
+#define ADXL_REG_DATA_FORMAT 0x31
+#define ADXL_REG_DATAX0      0x32
+#define ADXL_REG_FIFO_CTL    0x38
+#define ADXL_REG_FIFO_STATUS 0x39
+
+/* bits in the first byte of a SPI transaction */
+#define ADXL_SPI_READ       0x80 /* read, not write */
+#define ADXL_SPI_MULTI_BYTE 0x40 /* auto-increment the register address */
+
+/* the chip select pin */
+static volatile uint8_t *adxlCsPort;
+static uint8_t adxlCsMask;
+
+/* adxl345_spi_select(), adxl345_spi_deselect()
+
+   Take the bus and pull CS low, then raise CS and give the bus back.  If the
+   display is in the middle of a transfer, wait for it to finish.
+*/
+static void adxl345_spi_select(void)
+{
+  while(spibus_acquire(SPIBUS_OWNER_ACCEL) != SPIBUS_OK)
+  {
+  }
+  *adxlCsPort &= ~adxlCsMask;
+
+}/* end adxl345_spi_select() */
+
+static void adxl345_spi_deselect(void)
+{
+  *adxlCsPort |= adxlCsMask;
+  spibus_release(SPIBUS_OWNER_ACCEL);
+
+}/* end adxl345_spi_deselect() */
+
+/* adxl345_spi_init()
+
+   Set up the chip select pin and register the SPI settings.  Returns the DEVID
+   register.
+*/
+uint8_t adxl345_spi_init(volatile uint8_t *csPort, uint8_t csPin)
+{
+  adxlCsPort = csPort;
+  adxlCsMask = _BV(csPin);
+
+/* CS high (deselected), then make it an output.  The data direction register
+   sits one address below the port register. */
+  *adxlCsPort |= adxlCsMask;
+  *(adxlCsPort - 1) |= adxlCsMask;
+
+/* SPI mode 3, MSB first, F_CPU/4 = 4MHz (the ADXL345 maximum is 5MHz) */
+  spibus_register(SPIBUS_OWNER_ACCEL, _BV(SPE) | _BV(MSTR) | _BV(CPOL) | _BV(CPHA), 0);
+
+  return(adxl345_spi_readReg(ADXL_REG_DEVID));
+
+}/* end adxl345_spi_init() */
+
+/* adxl345_spi_writeReg()
+
+   Write one byte to a register.
+*/
+void adxl345_spi_writeReg(uint8_t reg, uint8_t data)
+{
+  adxl345_spi_select();
+  spibus_transfer(reg);
+  spibus_transfer(data);
+  adxl345_spi_deselect();
+
+}/* end adxl345_spi_writeReg() */
+
+/* adxl345_spi_readReg()
+
+   Read one byte from a register.
+*/
+uint8_t adxl345_spi_readReg(uint8_t reg)
+{
+  uint8_t data;
+
+  adxl345_spi_select();
+  spibus_transfer(reg | ADXL_SPI_READ);
+  data = spibus_transfer(0);
+  adxl345_spi_deselect();
+
+  return(data);
+
+}/* end adxl345_spi_readReg() */
+
+/* adxl345_spi_readRegs()
+
+   Burst read 'count' consecutive registers in a single chip select cycle.
+*/
+void adxl345_spi_readRegs(uint8_t reg, uint8_t *buf, uint8_t count)
+{
+  adxl345_spi_select();
+  spibus_transfer(reg | ADXL_SPI_READ | ADXL_SPI_MULTI_BYTE);
+  while(count--)
+  {
+    *buf++ = spibus_transfer(0);
+  }
+  adxl345_spi_deselect();
+
+}/* end adxl345_spi_readRegs() */
+
+void adxl345_spi_setDataFormat(uint8_t format)
+{
+  adxl345_spi_writeReg(ADXL_REG_DATA_FORMAT, format);
+
+}/* end adxl345_spi_setDataFormat() */
+
+void adxl345_spi_setBWRate(uint8_t rate)
+{
+  adxl345_spi_writeReg(ADXL_REG_BW_RATE, rate);
+
+}/* end adxl345_spi_setBWRate() */
+
+void adxl345_spi_setPowerControl(uint8_t control)
+{
+  adxl345_spi_writeReg(ADXL_REG_POWER_CTL, control);
+
+}/* end adxl345_spi_setPowerControl() */
+
+void adxl345_spi_setFifoControl(uint8_t control)
+{
+  adxl345_spi_writeReg(ADXL_REG_FIFO_CTL, control);
+
+}/* end adxl345_spi_setFifoControl() */
+
+/* adxl345_spi_setActivity()
+
+   Set the activity threshold and axes.  The inactivity half of ACT_INACT_CTL
+   isn't used and is cleared.
+*/
+void adxl345_spi_setActivity(uint8_t threshold, uint8_t control)
+{
+  adxl345_spi_writeReg(ADXL_REG_THRESH_ACT, threshold);
+  adxl345_spi_writeReg(ADXL_REG_ACT_INACT, control & 0xf0);
+
+}/* end adxl345_spi_setActivity() */
+
+/* adxl345_spi_setInterrupts()
+
+   Map the interrupts to their pins before enabling them, so none fires on the
+   wrong pin.
+*/
+void adxl345_spi_setInterrupts(uint8_t enable, uint8_t int2)
+{
+  adxl345_spi_writeReg(ADXL_REG_INT_MAP, int2);
+  adxl345_spi_writeReg(ADXL_REG_INT_ENABLE, enable);
+
+}/* end adxl345_spi_setInterrupts() */
+
+uint8_t adxl345_spi_getInterruptSource(void)
+{
+  return(adxl345_spi_readReg(ADXL_REG_INT_SOURCE));
+
+}/* end adxl345_spi_getInterruptSource() */
+
+/* adxl345_spi_getAccelData()
+
+   Burst read the six data registers.  Reading all six in one transaction
+   makes sure the three axes come from the same sample.
+*/
+void adxl345_spi_getAccelData(uint8_t *buf)
+{
+  adxl345_spi_readRegs(ADXL_REG_DATAX0, buf, 6);
+
+}/* end adxl345_spi_getAccelData() */
+
+/* adxl345_spi_getFifoEntries()
+
+   Returns the number of samples waiting in the FIFO.
+*/
+uint8_t adxl345_spi_getFifoEntries(void)
+{
+  return(adxl345_spi_readReg(ADXL_REG_FIFO_STATUS) & 0x3f);
+
+}/* end adxl345_spi_getFifoEntries() */
+
+/* adxl345_spi_readFifo()
+
+   Read up to 'max' samples out of the FIFO.  Each read of the data registers
+   pops one sample.  The datasheet asks for at least 5us between the end of one
+   data read and the start of the next FIFO read so the next sample can move
+   into the data registers.  The bus is released between samples so the
+   display can get in.
+*/
+uint8_t adxl345_spi_readFifo(int16_t *xyz, uint8_t max)
+{
+  uint8_t buf[6];
+  uint8_t entries, i;
+
+  entries = adxl345_spi_getFifoEntries();
+  if(entries > max)
+  {
+    entries = max;
+  }
+
+  for(i = 0; i < entries; i++)
+  {
+    adxl345_spi_getAccelData(buf);
+    *xyz++ = (int16_t)((uint16_t)buf[1] << 8 | buf[0]);
+    *xyz++ = (int16_t)((uint16_t)buf[3] << 8 | buf[2]);
+    *xyz++ = (int16_t)((uint16_t)buf[5] << 8 | buf[4]);
+    _delay_us(5);
+  }
+
+  return(entries);
+
+}/* end adxl345_spi_readFifo() */
@@ -0,0 +1,139 @@
+/*
+ * adxl345_spi.h
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * SPI (4-wire) backend for the ADXL345 accelerometer.  It takes the same
+ * register values as the I2C driver in adxl345.h, but talks to the chip over
+ * the shared SPI bus (see spibus.h), so it can sit on the same bus as the
+ * SSD1306 display.
+ *
+ * Over I2C at 400kHz the ADXL345 can't be read much faster than about 800Hz.
+ * Over SPI at 4MHz one six byte burst takes a few microseconds, so the chip can
+ * run at its full 3200Hz output data rate.  Use the on-chip FIFO in stream mode
+ * (32 samples, 10ms at 3200Hz) and drain it with adxl345_spi_readFifo() once
+ * per loop.
+ *
+ * The SPI lines are connected as follows:
+ *    SCK  - SCL
+ *    MOSI - SDA
+ *    MISO - SDO
+ *    CS   - any free port pin, passed to adxl345_spi_init()
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef ADXL345_SPI_H_
+#define ADXL345_SPI_H_
+
+#include <avr/io.h>
+#include "adxl345/adxl345.h"
+
+/* Output data rates of 100Hz and 3200Hz (BW_RATE register) */
+#ifndef ADXL_BW_RATE_0100
+#define ADXL_BW_RATE_0100 0x0a
+#endif
+#ifndef ADXL_BW_RATE_3200
+#define ADXL_BW_RATE_3200 0x0f
+#endif
+
+/* FIFO_CTL register values */
+#define ADXL_FIFO_CTL_BYPASS  0x00
+#define ADXL_FIFO_CTL_FIFO    0x40
+#define ADXL_FIFO_CTL_STREAM  0x80
+#define ADXL_FIFO_CTL_TRIGGER 0xc0
+
+/* ACT_INACT_CTL register, activity detection.  AC compares each axis with
+   its value when activity detection was turned on, so gravity doesn't count;
+   DC compares the axis itself. */
+#define ADXL_ACT_DC 0x00
+#define ADXL_ACT_AC 0x80
+#define ADXL_ACT_X  0x40
+#define ADXL_ACT_Y  0x20
+#define ADXL_ACT_Z  0x10
+
+/* interrupt sources, INT_ENABLE, INT_MAP and INT_SOURCE registers */
+#define ADXL_INT_DATA_READY 0x80
+#define ADXL_INT_ACTIVITY   0x10
+#define ADXL_INT_WATERMARK  0x02
+#define ADXL_INT_OVERRUN    0x01
+
+/* number of entries in the ADXL345 FIFO */
+#define ADXL_FIFO_SIZE 32
+
+/* Value of the DEVID register, returned by adxl345_spi_init() if the chip is
+   there. */
+#define ADXL_DEVID 0xe5
+
+/* adxl345_spi_init()
+
+   Set up the chip select pin and register the SPI settings (mode 3, F_CPU/4)
+   with the bus arbiter.  Returns the DEVID register, which should be
+   ADXL_DEVID.  The SPI bus must already be enabled as master.
+*/
+uint8_t adxl345_spi_init(volatile uint8_t *csPort, uint8_t csPin);
+
+/* register write and read, one byte */
+void adxl345_spi_writeReg(uint8_t reg, uint8_t data);
+uint8_t adxl345_spi_readReg(uint8_t reg);
+
+/* adxl345_spi_readRegs()
+
+   Burst read 'count' consecutive registers starting at 'reg' in a single
+   chip select cycle.
+*/
+void adxl345_spi_readRegs(uint8_t reg, uint8_t *buf, uint8_t count);
+
+/* Same as the I2C driver functions of the same name. */
+void adxl345_spi_setDataFormat(uint8_t format);
+void adxl345_spi_setBWRate(uint8_t rate);
+void adxl345_spi_setPowerControl(uint8_t control);
+void adxl345_spi_setFifoControl(uint8_t control);
+
+/* adxl345_spi_setActivity()
+
+   Set up activity detection.  'threshold' is in steps of 62.5mg whatever the
+   range, 'control' is ADXL_ACT_AC or ADXL_ACT_DC and the ADXL_ACT_X, _Y, _Z
+   axes to watch.  Activity is seen when any of the axes goes over the
+   threshold.
+*/
+void adxl345_spi_setActivity(uint8_t threshold, uint8_t control);
+
+/* adxl345_spi_setInterrupts()
+
+   Enable the ADXL_INT_ sources in 'enable'.  Those also in 'int2' go to the
+   INT2 pin, the rest to INT1.  The pins are active high.
+*/
+void adxl345_spi_setInterrupts(uint8_t enable, uint8_t int2);
+
+/* adxl345_spi_getInterruptSource()
+
+   Returns the ADXL_INT_ sources that have happened.  Reading it clears the
+   activity interrupt.
+*/
+uint8_t adxl345_spi_getInterruptSource(void);
+
+/* adxl345_spi_getAccelData()
+
+   Burst read the six data registers (X0, X1, Y0, Y1, Z0, Z1) into 'buf'.
+*/
+void adxl345_spi_getAccelData(uint8_t *buf);
+
+/* adxl345_spi_getFifoEntries()
+
+   Returns the number of samples waiting in the FIFO.
+*/
+uint8_t adxl345_spi_getFifoEntries(void);
+
+/* adxl345_spi_readFifo()
+
+   Read up to 'max' samples out of the FIFO into 'xyz', three int16_t (X, Y, Z)
+   per sample.  Returns the number of samples read.
+*/
+uint8_t adxl345_spi_readFifo(int16_t *xyz, uint8_t max);
+
+#endif /* ADXL345_SPI_H_ */
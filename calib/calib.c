@@ -0,0 +1,242 @@
+/*
+ * calib.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Calibration for three axis sensors.  See calib.h.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <avr/eeprom.h>
+#include "calib.h"
+
+/* Stored ahead of the data, change it if Calib_Data changes so old EEPROM
+   contents are not used. */
+#define CALIB_MAGIC 0xc1
+
+/* the calibration as stored in EEPROM */
+static uint8_t EEMEM calibMagic;
+static Calib_Data EEMEM calibData;
+static uint8_t EEMEM calibChecksum;
+
+/* calib_checksum()
+
+   Add up the bytes of the calibration data.
+*/
+static uint8_t calib_checksum(const Calib_Data *cal)
+{
+  const uint8_t *p = (const uint8_t *)cal;
+  uint8_t sum = CALIB_MAGIC;
+  uint8_t i;
+
+  for(i = 0; i < sizeof(Calib_Data); i++)
+  {
+    sum += *p++;
+  }
+
+  return(sum);
+
+}/* end calib_checksum() */
+
+/* calib_default_sensor()
+
+   Set the offsets of one sensor to 0 and its scales to 1.0.
+*/
+static void calib_default_sensor(Calib_Sensor *sensor)
+{
+  uint8_t i;
+
+  for(i = 0; i < 3; i++)
+  {
+    sensor->offset[i] = 0;
+    sensor->scale[i] = CALIB_SCALE_ONE;
+  }
+
+}/* end calib_default_sensor() */
+
+/* calib_default()
+
+   Set all offsets to 0 and all scales to 1.0.
+*/
+void calib_default(Calib_Data *cal)
+{
+  calib_default_sensor(&cal->accel);
+  calib_default_sensor(&cal->gyro);
+  calib_default_sensor(&cal->mag);
+
+}/* end calib_default() */
+
+/* calib_load()
+
+   Read the calibration from EEPROM.  Falls back to the defaults if it isn't
+   there.
+*/
+uint8_t calib_load(Calib_Data *cal)
+{
+  if(eeprom_read_byte(&calibMagic) == CALIB_MAGIC)
+  {
+    eeprom_read_block(cal, &calibData, sizeof(Calib_Data));
+
+    if(eeprom_read_byte(&calibChecksum) == calib_checksum(cal))
+    {
+      return(CALIB_OK);
+    }
+  }
+
+  calib_default(cal);
+
+  return(CALIB_ERROR);
+
+}/* end calib_load() */
+
+/* calib_save()
+
+   Write the calibration to EEPROM.
+*/
+void calib_save(const Calib_Data *cal)
+{
+  eeprom_update_byte(&calibMagic, CALIB_MAGIC);
+  eeprom_update_block(cal, &calibData, sizeof(Calib_Data));
+  eeprom_update_byte(&calibChecksum, calib_checksum(cal));
+
+}/* end calib_save() */
+
+/* calib_mean_start()
+
+   Clear the running sums.
+*/
+void calib_mean_start(Calib_Mean *mean)
+{
+  mean->sum[0] = mean->sum[1] = mean->sum[2] = 0;
+  mean->count = 0;
+
+}/* end calib_mean_start() */
+
+/* calib_mean_add()
+
+   Add one reading.
+*/
+void calib_mean_add(Calib_Mean *mean, const int16_t *xyz)
+{
+  mean->sum[0] += xyz[0];
+  mean->sum[1] += xyz[1];
+  mean->sum[2] += xyz[2];
+  mean->count++;
+
+}/* end calib_mean_add() */
+
+/* calib_mean_finish()
+
+   Set the offsets to the averages, rounded, and the scales to 1.0.
+*/
+void calib_mean_finish(const Calib_Mean *mean, Calib_Sensor *cal)
+{
+  int32_t half = mean->count / 2;
+  uint8_t i;
+
+  for(i = 0; i < 3; i++)
+  {
+    if(mean->count == 0)
+    {
+      cal->offset[i] = 0;
+    }
+    else if(mean->sum[i] < 0)
+    {
+      cal->offset[i] = (int16_t)((mean->sum[i] - half) / mean->count);
+    }
+    else
+    {
+      cal->offset[i] = (int16_t)((mean->sum[i] + half) / mean->count);
+    }
+    cal->scale[i] = CALIB_SCALE_ONE;
+  }
+
+}/* end calib_mean_finish() */
+
+/* calib_minmax_start()
+
+   Set the extremes so the first reading replaces them.
+*/
+void calib_minmax_start(Calib_MinMax *minmax)
+{
+  uint8_t i;
+
+  for(i = 0; i < 3; i++)
+  {
+    minmax->min[i] = 32767;
+    minmax->max[i] = -32768;
+  }
+
+}/* end calib_minmax_start() */
+
+/* calib_minmax_add()
+
+   Add one reading.
+*/
+void calib_minmax_add(Calib_MinMax *minmax, const int16_t *xyz)
+{
+  uint8_t i;
+
+  for(i = 0; i < 3; i++)
+  {
+    if(xyz[i] < minmax->min[i])
+    {
+      minmax->min[i] = xyz[i];
+    }
+    if(xyz[i] > minmax->max[i])
+    {
+      minmax->max[i] = xyz[i];
+    }
+  }
+
+}/* end calib_minmax_add() */
+
+/* calib_minmax_finish()
+
+   Work out the offsets and scales from the extremes.  Returns CALIB_ERROR,
+   and leaves 'cal' alone, if any axis didn't move enough to be measured or
+   would need a scale of more than 2.0.
+*/
+uint8_t calib_minmax_finish(const Calib_MinMax *minmax, int16_t target, Calib_Sensor *cal)
+{
+  int32_t range[3];
+  uint8_t i;
+
+  for(i = 0; i < 3; i++)
+  {
+    range[i] = ((int32_t)minmax->max[i] - minmax->min[i]) / 2;
+    if(range[i] < 8)
+    {
+      return(CALIB_ERROR);
+    }
+  }
+
+/* soft iron, bring every axis to the average */
+  if(target == 0)
+  {
+    target = (int16_t)((range[0] + range[1] + range[2]) / 3);
+  }
+
+  for(i = 0; i < 3; i++)
+  {
+    if(range[i] * 2 <= target)
+    {
+      return(CALIB_ERROR);
+    }
+  }
+
+  for(i = 0; i < 3; i++)
+  {
+    cal->offset[i] = (int16_t)(((int32_t)minmax->max[i] + minmax->min[i]) / 2);
+    cal->scale[i] = (int16_t)(((int32_t)target * CALIB_SCALE_ONE + range[i] / 2) / range[i]);
+  }
+
+  return(CALIB_OK);
+
+}/* end calib_minmax_finish() */
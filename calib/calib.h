@@ -0,0 +1,123 @@
+/*
+ * calib.h
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Calibration for three axis sensors.  Each axis gets a zero offset and a
+ * scale factor:
+ *
+ *    corrected = (raw - offset) * scale / 16384
+ *
+ * That corrects the gyro's zero rate bias, the accelerometer's zero-g offset
+ * and sensitivity, and the magnetometer's hard iron (offset) and soft iron
+ * (scale) errors.  Applying it costs one subtract and one 16x16 multiply per
+ * axis.
+ *
+ * The calibration values are worked out once with the accumulators below,
+ * then saved in EEPROM, so the sensors don't have to be calibrated every time
+ * the board is turned on.
+ *
+ *    gyro          - Calib_Mean, hold the board still
+ *    accelerometer - Calib_MinMax, hold the board still on each of its six
+ *                    faces (six point calibration)
+ *    magnetometer  - Calib_MinMax, turn the board through every direction
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef CALIB_H_
+#define CALIB_H_
+
+#include <avr/io.h>
+
+/* a scale of 1.0 */
+#define CALIB_SCALE_ONE 16384
+
+/* return values */
+#define CALIB_OK    0
+#define CALIB_ERROR 1
+
+/* the correction for one three axis sensor */
+typedef struct
+{
+  int16_t offset[3];
+  int16_t scale[3];
+} Calib_Sensor;
+
+/* the corrections for all three sensors, as stored in EEPROM */
+typedef struct
+{
+  Calib_Sensor accel;
+  Calib_Sensor gyro;
+  Calib_Sensor mag;
+} Calib_Data;
+
+/* running sum for averaging a sensor held still */
+typedef struct
+{
+  int32_t sum[3];
+  uint16_t count;
+} Calib_Mean;
+
+/* smallest and largest reading seen on each axis */
+typedef struct
+{
+  int16_t min[3];
+  int16_t max[3];
+} Calib_MinMax;
+
+/* calib_apply()
+
+   Correct a raw X, Y, Z reading in place.  Raw readings must stay within
+   +/-16383 of the offset, which covers every range of the three sensors.
+*/
+static inline void calib_apply(const Calib_Sensor *cal, int16_t *xyz)
+{
+  xyz[0] = (int16_t)(((int32_t)(int16_t)(xyz[0] - cal->offset[0]) * cal->scale[0]) >> 14);
+  xyz[1] = (int16_t)(((int32_t)(int16_t)(xyz[1] - cal->offset[1]) * cal->scale[1]) >> 14);
+  xyz[2] = (int16_t)(((int32_t)(int16_t)(xyz[2] - cal->offset[2]) * cal->scale[2]) >> 14);
+
+}/* end calib_apply() */
+
+/* calib_default()
+
+   Set all offsets to 0 and all scales to 1.0.
+*/
+void calib_default(Calib_Data *cal);
+
+/* calib_load(), calib_save()
+
+   Read and write the calibration in EEPROM.  calib_load() returns CALIB_ERROR
+   and sets the defaults if the EEPROM has never been written or is corrupt.
+   calib_save() only writes the bytes that changed.
+*/
+uint8_t calib_load(Calib_Data *cal);
+void calib_save(const Calib_Data *cal);
+
+/* calib_mean_start(), calib_mean_add(), calib_mean_finish()
+
+   Average readings of a sensor held still.  calib_mean_finish() sets the
+   offsets to the averages and the scales to 1.0 (for the gyro, whose scale
+   comes from its datasheet).
+*/
+void calib_mean_start(Calib_Mean *mean);
+void calib_mean_add(Calib_Mean *mean, const int16_t *xyz);
+void calib_mean_finish(const Calib_Mean *mean, Calib_Sensor *cal);
+
+/* calib_minmax_start(), calib_minmax_add(), calib_minmax_finish()
+
+   Track the extremes of each axis.  calib_minmax_finish() puts the offset of
+   each axis in the middle of its range and scales it so the range becomes
+   +/-'target'.  Pass 0 for 'target' to use the average range of the three
+   axes, which is what the magnetometer needs (the strength of the earth's
+   field varies from place to place).
+*/
+void calib_minmax_start(Calib_MinMax *minmax);
+void calib_minmax_add(Calib_MinMax *minmax, const int16_t *xyz);
+uint8_t calib_minmax_finish(const Calib_MinMax *minmax, int16_t target, Calib_Sensor *cal);
+
+#endif /* CALIB_H_ */
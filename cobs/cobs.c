@@ -0,0 +1,55 @@
+/*
+ * cobs.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Consistent Overhead Byte Stuffing.  See cobs.h.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include "cobs.h"
+
+/* cobs_encode()
+
+   Copy the bytes across, leaving a gap for the code byte in front of each
+   run.  A zero, or a run reaching 254 bytes, fills in the gap and starts a
+   new run.
+*/
+uint8_t cobs_encode(const uint8_t *src, uint8_t length, uint8_t *dst)
+{
+  uint8_t *start = dst;
+  uint8_t *code = dst++;
+  uint8_t count = 1;
+
+  while(length-- > 0)
+  {
+    if(*src == 0)
+    {
+      *code = count;
+      code = dst++;
+      count = 1;
+    }
+    else
+    {
+      *dst++ = *src;
+      if(++count == 0xff)
+      {
+        *code = count;
+        code = dst++;
+        count = 1;
+      }
+    }
+    src++;
+  }
+
+  *code = count;
+
+  return((uint8_t)(dst - start));
+
+}/* end cobs_encode() */
@@ -0,0 +1,41 @@
+/*
+ * cobs.h
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Consistent Overhead Byte Stuffing.  COBS rewrites a block of bytes so that
+ * it contains no zeros, which frees the zero byte to mark where one block ends
+ * and the next begins.  A receiver that starts listening part way through, or
+ * loses a byte, finds its place again at the next zero.  The cost is one
+ * extra byte for every 254, so a short record grows by just one byte, plus
+ * the zero that ends it.
+ *
+ * Each run of non-zero bytes is sent after a code byte holding its length
+ * plus one, and the zero that followed it is left out:
+ *
+ *    11 22 00 33  ->  03 11 22 02 33
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef COBS_H_
+#define COBS_H_
+
+#include <avr/io.h>
+
+/* the most bytes cobs_encode() writes for 'length' bytes in */
+#define COBS_ENCODED_MAX(length) ((length) + 1 + (length) / 254)
+
+/* cobs_encode()
+
+   Encode 'length' bytes from 'src', up to 253, into 'dst', which must hold
+   COBS_ENCODED_MAX(length) bytes.  Returns the number of bytes written.  The
+   zero that ends the frame isn't added.
+*/
+uint8_t cobs_encode(const uint8_t *src, uint8_t length, uint8_t *dst);
+
+#endif /* COBS_H_ */
@@ -0,0 +1,74 @@
+/*
+ * compass.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Tilt compensated compass heading.  See compass.h.
+ *
+ * The maths is from Freescale application note AN4248, with the sensor axes
+ * turned from X forward, Y left, Z up to the note's X forward, Y right,
+ * Z down.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include "cordic/cordic.h"
+#include "compass.h"
+
+/* compass_mul()
+
+   Multiply a sensor reading by a Q15 sine or cosine.
+*/
+static int32_t compass_mul(int32_t a, int16_t b)
+{
+  return((a * b) >> 15);
+
+}/* end compass_mul() */
+
+/* compass_atan2()
+
+   cordic_atan2() for 32-bit arguments.  Halve both until they fit in 16 bits,
+   which doesn't change the angle.
+*/
+static int16_t compass_atan2(int32_t y, int32_t x)
+{
+  while((y > 32767) || (y < -32767) || (x > 32767) || (x < -32767))
+  {
+    y >>= 1;
+    x >>= 1;
+  }
+
+  return(cordic_atan2((int16_t)y, (int16_t)x));
+
+}/* end compass_atan2() */
+
+/* compass_heading()
+
+   Returns the heading as a binary angle, 0 = magnetic north, clockwise.
+*/
+int16_t compass_heading(const int16_t *accel, const int16_t *mag)
+{
+  int16_t sinRoll, cosRoll, sinPitch, cosPitch;
+  int32_t t, magX, magY;
+
+/* roll, turning about the X axis */
+  cordic_sincos(cordic_atan2(accel[1], accel[2]), &sinRoll, &cosRoll);
+
+/* pitch, turning about the Y axis, using the Z axis reading corrected for
+   roll */
+  t = compass_mul(accel[1], sinRoll) + compass_mul(accel[2], cosRoll);
+  cordic_sincos(compass_atan2(accel[0], t), &sinPitch, &cosPitch);
+
+/* the magnetic field turned back to level */
+  t = compass_mul(mag[1], sinRoll) + compass_mul(mag[2], cosRoll);
+  magX = compass_mul(mag[0], cosPitch) - compass_mul(t, sinPitch);
+  magY = compass_mul(mag[1], cosRoll) - compass_mul(mag[2], sinRoll);
+
+  return(compass_atan2(magY, magX));
+
+}/* end compass_heading() */
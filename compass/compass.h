@@ -0,0 +1,46 @@
+/*
+ * compass.h
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Tilt compensated compass heading from an accelerometer and a magnetometer,
+ * worked out with the CORDIC routines in cordic.h.  The accelerometer gives
+ * the roll and pitch of the board, which are used to turn the magnetic field
+ * reading back to level before taking its angle.  This way the heading stays
+ * correct when the board isn't held flat.
+ *
+ * Both sensors must have their axes lined up, X forward, Y left and Z up, so
+ * the accelerometer reads +1g on Z when the board is level.  Note the HMC5883
+ * sends its axes in the order X, Z, Y.
+ *
+ * tools/cordic-test.c finds the heading within 1.5 degrees with the board
+ * rolled and pitched up to 60 degrees, on readings the size the ADXL345 and
+ * HMC5883 give.  Nearly all of that is the rounding of the readings to whole
+ * counts; the arithmetic on its own is good to about 0.1 degrees.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef COMPASS_H_
+#define COMPASS_H_
+
+#include <avr/io.h>
+
+/* compass_heading()
+
+   Returns the heading as a binary angle (see cordic.h), 0 = magnetic north,
+   increasing clockwise.  'accel' and 'mag' are raw X, Y, Z readings.
+*/
+int16_t compass_heading(const int16_t *accel, const int16_t *mag);
+
+/* COMPASS_DEGREES()
+
+   Convert a heading to whole degrees, 0 to 359.
+*/
+#define COMPASS_DEGREES(heading) ((uint16_t)(((uint32_t)(uint16_t)(heading) * 360) >> 16))
+
+#endif /* COMPASS_H_ */
@@ -0,0 +1,220 @@
+/*
+ * cordic.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Fixed-point CORDIC routines.  See cordic.h.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include "cordic.h"
+
+/* number of iterations, one for each entry in CORDIC_ATAN_TABLE */
+#define CORDIC_ITERATIONS 15
+
+/* Inputs are shifted up by this much so the small steps keep their
+   precision.  Inputs up to 65535 (17 bits with sign) grow by 1.65 times sqrt(2)
+   during the vectoring, so this is as far as they can go in 32 bits. */
+#define CORDIC_PRESCALE 13
+
+/* the CORDIC gain, 1/1.6468, in Q16 and Q30 */
+#define CORDIC_K_Q16 39797U
+#define CORDIC_K_Q30 652032874L
+
+/* atan(2^-i) as binary angles, i = 0 to 14 */
+static const int16_t CORDIC_ATAN_TABLE[CORDIC_ITERATIONS] PROGMEM =
+{
+  8192, 4836, 2555, 1297, 651, 326, 163, 81, 41, 20, 10, 5, 3, 1, 1
+};
+
+/* cordic_vectoring()
+
+   Rotate the vector (x, y) onto the X axis, adding up the angles turned
+   through.  Returns the length of the vector, corrected for the CORDIC gain,
+   and stores its angle in 'angle'.  x and y may be up to +/-65535, as long as
+   the length is no more than 65535.
+*/
+static uint32_t cordic_vectoring(int32_t x, int32_t y, int16_t *angle)
+{
+  int32_t xNew;
+  uint16_t z = 0;/* unsigned, so it wraps around at +/-180 degrees */
+  uint8_t i;
+
+  if((x == 0) && (y == 0))
+  {
+    *angle = 0;
+    return(0);
+  }
+
+/* CORDIC only converges within +/-90 degrees, so first turn vectors on the
+   left half plane through 180 degrees */
+  if(x < 0)
+  {
+    x = -x;
+    y = -y;
+    z = CORDIC_ANGLE_180;
+  }
+
+  x <<= CORDIC_PRESCALE;
+  y <<= CORDIC_PRESCALE;
+
+  for(i = 0; i < CORDIC_ITERATIONS; i++)
+  {
+    if(y > 0)/* turn clockwise */
+    {
+      xNew = x + (y >> i);
+      y -= x >> i;
+      z += pgm_read_word(&CORDIC_ATAN_TABLE[i]);
+    }
+    else/* turn anticlockwise */
+    {
+      xNew = x - (y >> i);
+      y += x >> i;
+      z -= pgm_read_word(&CORDIC_ATAN_TABLE[i]);
+    }
+    x = xNew;
+  }
+
+  *angle = (int16_t)z;
+
+/* x is now the length times the gain, remove both, rounding each time.  A
+   length of 65535 comes out of the shift as 107920, which times the gain in
+   Q16 only just fits in 32 bits. */
+  x = (x + (1L << (CORDIC_PRESCALE - 1))) >> CORDIC_PRESCALE;
+  return(((uint32_t)x * CORDIC_K_Q16 + 32768U) >> 16);
+
+}/* end cordic_vectoring() */
+
+/* cordic_atan2()
+
+   Returns the angle of the vector (x, y) as a binary angle.
+*/
+int16_t cordic_atan2(int16_t y, int16_t x)
+{
+  int16_t angle;
+
+  cordic_vectoring(x, y, &angle);
+
+  return(angle);
+
+}/* end cordic_atan2() */
+
+/* cordic_magnitude()
+
+   Returns the length of the vector (x, y).
+*/
+uint16_t cordic_magnitude(int16_t x, int16_t y)
+{
+  int16_t angle;
+
+  return((uint16_t)cordic_vectoring(x, y, &angle));
+
+}/* end cordic_magnitude() */
+
+/* cordic_magnitude3()
+
+   Returns the length of the vector (x, y, z).  The length of (x, y) can be up
+   to 46341, which still fits the vectoring input range.
+*/
+uint16_t cordic_magnitude3(int16_t x, int16_t y, int16_t z)
+{
+  int16_t angle;
+  uint32_t length;
+
+  length = cordic_vectoring(x, y, &angle);
+  length = cordic_vectoring((int32_t)length, z, &angle);
+
+  if(length > 65535)
+  {
+    length = 65535;
+  }
+
+  return((uint16_t)length);
+
+}/* end cordic_magnitude3() */
+
+/* cordic_polar()
+
+   Returns the length of (x, y) and stores its angle in 'angle'.
+*/
+uint16_t cordic_polar(int16_t x, int16_t y, int16_t *angle)
+{
+  return((uint16_t)cordic_vectoring(x, y, angle));
+
+}/* end cordic_polar() */
+
+/* cordic_sincos()
+
+   Sine and cosine of a binary angle in Q15.  Starts with a vector of length
+   1/gain on the X axis and rotates it through the angle, so it comes out at
+   (cos, sin) with length 1.
+*/
+void cordic_sincos(int16_t angle, int16_t *sine, int16_t *cosine)
+{
+  int32_t x = CORDIC_K_Q30, y = 0, xNew;
+  int16_t z = angle;
+  uint8_t flip = 0;
+  uint8_t i;
+
+/* CORDIC only converges within +/-90 degrees, so turn angles outside that
+   through 180 degrees and negate the answer */
+  if((z > CORDIC_ANGLE_90) || (z < -CORDIC_ANGLE_90))
+  {
+    z = (int16_t)((uint16_t)z + CORDIC_ANGLE_180);
+    flip = 1;
+  }
+
+  for(i = 0; i < CORDIC_ITERATIONS; i++)
+  {
+    if(z >= 0)/* turn anticlockwise */
+    {
+      xNew = x - (y >> i);
+      y += x >> i;
+      z -= pgm_read_word(&CORDIC_ATAN_TABLE[i]);
+    }
+    else/* turn clockwise */
+    {
+      xNew = x + (y >> i);
+      y -= x >> i;
+      z += pgm_read_word(&CORDIC_ATAN_TABLE[i]);
+    }
+    x = xNew;
+  }
+
+/* Q30 to Q15, rounded, 1.0 clipped to 32767 */
+  x = (x + 16384) >> 15;
+  y = (y + 16384) >> 15;
+  if(x > 32767)
+  {
+    x = 32767;
+  }
+  else if(x < -32767)
+  {
+    x = -32767;
+  }
+  if(y > 32767)
+  {
+    y = 32767;
+  }
+  else if(y < -32767)
+  {
+    y = -32767;
+  }
+
+  if(flip)
+  {
+    x = -x;
+    y = -y;
+  }
+
+  *sine = (int16_t)y;
+  *cosine = (int16_t)x;
+
+}/* end cordic_sincos() */
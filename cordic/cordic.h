@@ -0,0 +1,79 @@
+/*
+ * cordic.h
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Fixed-point CORDIC routines for angles and vector lengths from 16-bit sensor
+ * data.  CORDIC rotates a vector through a series of angles atan(2^-i), each
+ * step needing only shifts and adds, so there is no multiply, no division and
+ * no floating point anywhere in the loop.
+ *
+ * Angles are binary angles: a full circle is 65536, so an int16_t holds -180
+ * to +180 degrees with a resolution of 0.0055 degrees.  Convert to degrees
+ * with CORDIC_DEGREES().
+ *
+ * Accuracy, checked against the C maths library over the whole 16-bit input
+ * range by tools/cordic-test.c: angles within 4 LSB (0.02 degrees),
+ * magnitudes within 2 LSB (4 for cordic_magnitude3()), sine and cosine
+ * within 10 LSB of Q15 (0.0003).  Each call runs 15 iterations.  Most of
+ * the time goes into the variable 32-bit shifts, which the AVR does one bit at
+ * a time.  Expect around 2,000 cycles per call, against several thousand for
+ * avr-libc's floating point atan2() plus sqrt().  sensors-ahrs.c measures and
+ * displays the count for cordic_atan2().
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef CORDIC_H_
+#define CORDIC_H_
+
+#include <avr/io.h>
+
+/* binary angles for some common angles */
+#define CORDIC_ANGLE_90  16384
+#define CORDIC_ANGLE_180 32768U
+
+/* CORDIC_DEGREES()
+
+   Convert a binary angle to whole degrees (-180 to +179), rounded.
+*/
+#define CORDIC_DEGREES(angle) ((int16_t)(((int32_t)(angle) * 360 + 32768) >> 16))
+
+/* cordic_atan2()
+
+   Returns the angle of the vector (x, y), measured from the X axis towards the
+   Y axis, as a binary angle.  Same arguments as atan2() in the maths library.
+   Returns 0 for (0, 0).
+*/
+int16_t cordic_atan2(int16_t y, int16_t x);
+
+/* cordic_magnitude()
+
+   Returns the length of the vector (x, y), sqrt(x*x + y*y).
+*/
+uint16_t cordic_magnitude(int16_t x, int16_t y);
+
+/* cordic_magnitude3()
+
+   Returns the length of the vector (x, y, z).  The result is clipped to 65535.
+*/
+uint16_t cordic_magnitude3(int16_t x, int16_t y, int16_t z);
+
+/* cordic_polar()
+
+   Both of the above in one pass: returns the length of (x, y) and stores its
+   angle in 'angle'.
+*/
+uint16_t cordic_polar(int16_t x, int16_t y, int16_t *angle);
+
+/* cordic_sincos()
+
+   Sine and cosine of a binary angle in Q15 (32767 = 1.0).
+*/
+void cordic_sincos(int16_t angle, int16_t *sine, int16_t *cosine);
+
+#endif /* CORDIC_H_ */
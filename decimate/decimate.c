@@ -0,0 +1,132 @@
+/*
+ * decimate.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Decimation filters for three axis sensors.  See decimate.h.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include "decimate.h"
+
+/* decimate_avg_init()
+
+   Clear the sums and set the ratio.
+*/
+void decimate_avg_init(Decimate_Avg *filter, uint8_t shift)
+{
+  if(shift > DECIMATE_AVG_MAX_SHIFT)
+  {
+    shift = DECIMATE_AVG_MAX_SHIFT;
+  }
+
+  filter->sum[0] = filter->sum[1] = filter->sum[2] = 0;
+  filter->count = 0;
+  filter->shift = shift;
+
+}/* end decimate_avg_init() */
+
+/* decimate_avg_add()
+
+   Add one sample.  At the end of a block, output the sums shifted down,
+   rounded, and start the next block.
+*/
+uint8_t decimate_avg_add(Decimate_Avg *filter, const int16_t *xyz, int16_t *out)
+{
+  int32_t half;
+  uint8_t i;
+
+  filter->sum[0] += xyz[0];
+  filter->sum[1] += xyz[1];
+  filter->sum[2] += xyz[2];
+
+  if(++filter->count < ((uint32_t)1 << filter->shift))
+  {
+    return(DECIMATE_BUSY);
+  }
+
+  half = (filter->shift > 0) ? ((int32_t)1 << (filter->shift - 1)) : 0;
+  for(i = 0; i < 3; i++)
+  {
+    out[i] = (int16_t)((filter->sum[i] + half) >> filter->shift);
+    filter->sum[i] = 0;
+  }
+  filter->count = 0;
+
+  return(DECIMATE_READY);
+
+}/* end decimate_avg_add() */
+
+/* decimate_cic_init()
+
+   Clear the integrators and combs and set the ratio.
+*/
+void decimate_cic_init(Decimate_Cic *filter, uint8_t shift)
+{
+  uint8_t i;
+
+  if(shift > DECIMATE_CIC_MAX_SHIFT)
+  {
+    shift = DECIMATE_CIC_MAX_SHIFT;
+  }
+
+  for(i = 0; i < 3; i++)
+  {
+    filter->integ1[i] = 0;
+    filter->integ2[i] = 0;
+    filter->comb1[i] = 0;
+    filter->comb2[i] = 0;
+  }
+  filter->count = 0;
+  filter->shift = shift;
+
+}/* end decimate_cic_init() */
+
+/* decimate_cic_add()
+
+   Add one sample to the two integrators.  At the end of a block, run the last
+   integrator through the two combs, each of which subtracts its input from the
+   previous block, and shift out the gain of 2^(2 * shift).
+*/
+uint8_t decimate_cic_add(Decimate_Cic *filter, const int16_t *xyz, int16_t *out)
+{
+  uint32_t diff1, diff2;
+  uint8_t shift;
+  uint8_t i;
+
+  for(i = 0; i < 3; i++)
+  {
+    filter->integ1[i] += (uint32_t)(int32_t)xyz[i];
+    filter->integ2[i] += filter->integ1[i];
+  }
+
+  if(++filter->count < ((uint16_t)1 << filter->shift))
+  {
+    return(DECIMATE_BUSY);
+  }
+
+  shift = filter->shift * 2;
+  for(i = 0; i < 3; i++)
+  {
+    diff1 = filter->integ2[i] - filter->comb1[i];
+    filter->comb1[i] = filter->integ2[i];
+    diff2 = diff1 - filter->comb2[i];
+    filter->comb2[i] = diff1;
+
+    if(shift > 0)
+    {
+      diff2 += (uint32_t)1 << (shift - 1);
+    }
+    out[i] = (int16_t)((int32_t)diff2 >> shift);
+  }
+  filter->count = 0;
+
+  return(DECIMATE_READY);
+
+}/* end decimate_cic_add() */
@@ -0,0 +1,81 @@
+/*
+ * decimate.h
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Decimation filters for three axis sensors.  A sensor is sampled faster than
+ * its data is needed, and the filter turns every 2^shift samples into one
+ * output with less noise.  Averaging N samples of uncorrelated noise divides
+ * it by sqrt(N), so a ratio of 16 takes 2 bits of noise off the reading.
+ *
+ * There are two filters:
+ *
+ *    Decimate_Avg - moving average over blocks of 2^shift samples (a first
+ *                   order CIC).  Cheapest, one 32-bit add per axis per sample.
+ *    Decimate_Cic - second order CIC (cascaded integrator comb).  Two 32-bit
+ *                   adds per axis per sample.  Its response falls off twice as
+ *                   fast, so noise above the output rate is less likely to
+ *                   alias down into the result.
+ *
+ * Both only add, subtract and shift; nothing multiplies or divides.  The
+ * state is a fixed size, independent of the ratio.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef DECIMATE_H_
+#define DECIMATE_H_
+
+#include <avr/io.h>
+
+/* largest shift for each filter, the sum must fit 32 bits */
+#define DECIMATE_AVG_MAX_SHIFT 15
+#define DECIMATE_CIC_MAX_SHIFT 8
+
+/* decimate_*_add() return values */
+#define DECIMATE_BUSY  0
+#define DECIMATE_READY 1
+
+/* moving average state */
+typedef struct
+{
+  int32_t sum[3];
+  uint16_t count;
+  uint8_t shift;
+} Decimate_Avg;
+
+/* second order CIC state.  The integrators are left to wrap around; the comb
+   differences come out right anyway, as long as the output fits in 32 bits. */
+typedef struct
+{
+  uint32_t integ1[3];
+  uint32_t integ2[3];
+  uint32_t comb1[3];
+  uint32_t comb2[3];
+  uint16_t count;
+  uint8_t shift;
+} Decimate_Cic;
+
+/* decimate_avg_init(), decimate_avg_add()
+
+   Start a moving average with a ratio of 2^shift, then add samples to it.
+   decimate_avg_add() returns DECIMATE_READY and writes the average to 'out'
+   once every 2^shift samples, otherwise it returns DECIMATE_BUSY and leaves
+   'out' alone.  'out' may be the same array as 'xyz'.
+*/
+void decimate_avg_init(Decimate_Avg *filter, uint8_t shift);
+uint8_t decimate_avg_add(Decimate_Avg *filter, const int16_t *xyz, int16_t *out);
+
+/* decimate_cic_init(), decimate_cic_add()
+
+   The same for the second order CIC.  The first output is only settled after
+   two blocks of samples.
+*/
+void decimate_cic_init(Decimate_Cic *filter, uint8_t shift);
+uint8_t decimate_cic_add(Decimate_Cic *filter, const int16_t *xyz, int16_t *out);
+
+#endif /* DECIMATE_H_ */
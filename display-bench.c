@@ -0,0 +1,185 @@
+/*
+ * display-bench.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Measures how fast the I2C display transport (display/display_i2c.h) sends
+ * the sensors-i2c.c screen.  The results go out the serial port at 115200
+ * baud, in bytes per second on the bus and frames per second:
+ *
+ *    full   - the whole screen, 1024 bytes, every frame
+ *    fields - all eleven numbers change every frame, the worst case for the
+ *             sensors screen
+ *    still  - nothing changes, the board lying on the bench
+ *
+ * No sensors are needed, the numbers are made up.  Only the display has to be
+ * on the I2C bus.  Build it again with DISPLAY_I2C_TWBR=0 to see what 1MHz
+ * gives.
+ *
+ * Timer 1 runs at F_CPU/64, 4us a count, and each frame is timed on its own,
+ * drawing and sending, so the count never overflows.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <stdlib.h>/* for ultoa() */
+#include "uart/uart.h"
+#include "i2c/i2c.h"
+#include "display/display.h"
+#include "display/display_i2c.h"
+#include "display/display_field.h"
+
+/* Timer 1 counts per second */
+#define TICKS_PER_SECOND (F_CPU / 64)
+
+/* frames in each test */
+#define BENCH_FRAMES 32
+
+/* the tests */
+#define BENCH_FULL   0
+#define BENCH_FIELDS 1
+#define BENCH_STILL  2
+
+/* Function prototypes */
+void run_bench(const char *label, uint8_t test);
+void print_rate(const char *label, uint32_t count, uint32_t ticks);
+
+/* the fields of the sensors screen, three to a row then heading and mg */
+static Display_Field fields[11];
+
+/* Start of code */
+int main(void)
+{
+  uint8_t i;
+
+/* initialize the UART so we can see the results */
+  uart_init(115200, USART_CHAR_SZ_EIGHT, USART_PARITY_NONE, USART_STOP_BIT_ONE);
+
+/* initialize and start up the I2C system */
+  i2c_init(400000UL);
+
+/* Timer 1 counts at F_CPU/64, no interrupts */
+  TCCR1A = 0;
+  TCCR1B = _BV(CS11) | _BV(CS10);
+
+/* Initialize the display and draw the labels of the sensors-i2c.c screen. */
+  display_i2c_init();
+  display_i2c_flip_vertical();
+  display_init();
+  display_set_text_size(2);
+  display_draw_filled_rectangle(0, 0, 127, 20, DISPLAY_WHITE);
+  display_set_text_colour(DISPLAY_BLACK);
+  display_set_cursor(21, 2);
+  display_putStr("SENSORS");
+  display_set_text_colour(DISPLAY_WHITE);
+  display_set_text_size(1);
+  display_set_cursor(0, 27);
+  display_putStr("Acc:");
+  display_set_cursor(0, 37);
+  display_putStr("Gyr:");
+  display_set_cursor(0, 47);
+  display_putStr("Mag:");
+  display_set_cursor(0, 57);
+  display_putStr("Hdg:");
+  display_set_cursor(64, 57);
+  display_putStr("mg:");
+  display_i2c_update();
+
+  for(i = 0; i < 9; i++)
+  {
+    display_field_init(&fields[i], 28 + 36 * (i % 3), 27 + 10 * (i / 3), 4, DISPLAY_FIELD_HEX, DISPLAY_FIELD_NO_SCALE);
+  }
+  display_field_init(&fields[9], 28, 57, 3, DISPLAY_FIELD_UDEC, DISPLAY_FIELD_NO_SCALE);
+  display_field_init(&fields[10], 88, 57, 5, DISPLAY_FIELD_DEC, DISPLAY_FIELD_NO_SCALE);
+
+#ifdef DISPLAY_I2C_TWBR
+  uart_putstr("display TWBR set by DISPLAY_I2C_TWBR\r\n");
+#else
+  uart_putstr("display at the bus rate, 400kHz\r\n");
+#endif
+
+  run_bench("full:   ", BENCH_FULL);
+  run_bench("fields: ", BENCH_FIELDS);
+  run_bench("still:  ", BENCH_STILL);
+
+/* wait here forever */
+  while(1)
+  {
+  }/* end while() */
+
+}/* end main() */
+
+/* run_bench()
+ *
+ * Draw and send BENCH_FRAMES frames of one test, adding up the bytes sent and
+ * the time taken, then print the rates.
+ */
+void run_bench(const char *label, uint8_t test)
+{
+  uint32_t bytes = 0, ticks = 0;
+  uint16_t startCount, value = 0x1234;
+  uint8_t frame, i;
+
+  for(frame = 0; frame < BENCH_FRAMES; frame++)
+  {
+    startCount = TCNT1;
+
+    switch(test)
+    {
+      case BENCH_FULL:
+        display_mark_dirty(0, 0, DISPLAY_MAX_X, DISPLAY_MAX_Y);
+        break;
+
+      case BENCH_FIELDS:
+      /* step every field to a new value with every digit different */
+        for(i = 0; i < 11; i++)
+        {
+          value += 0x1111;
+          display_field_set(&fields[i], (i < 9) ? value : (value & 0xff));
+        }
+        break;
+
+      default:
+        for(i = 0; i < 11; i++)
+        {
+          display_field_set(&fields[i], fields[i].value);
+        }
+        break;
+
+    }/* end switch(test) */
+
+    bytes += display_i2c_update();
+    ticks += (uint16_t)(TCNT1 - startCount);
+  }
+
+  uart_putstr(label);
+  print_rate(" bytes/s ", bytes, ticks);
+  print_rate(" frames/s ", BENCH_FRAMES, ticks);
+  uart_putstr("\r\n");
+
+}/* end run_bench() */
+
+/* print_rate()
+ *
+ * Send a count per second and a label to the serial port.
+ */
+void print_rate(const char *label, uint32_t count, uint32_t ticks)
+{
+  char str[11];
+
+/* both scaled down by 16 so the product fits 32 bits */
+  ticks /= 16;
+  if(ticks == 0)
+  {
+    ticks = 1;
+  }
+
+  uart_putstr(ultoa(count * (TICKS_PER_SECOND / 16) / ticks, str, 10));
+  uart_putstr(label);
+
+}/* end print_rate() */
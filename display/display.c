@@ -0,0 +1,457 @@
+/*
+ * display.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Frame buffer graphics for a 128x64 SSD1306 OLED display.  See display.h.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <stdlib.h>
+#include "display.h"
+#include "display_font.h"
+
+uint8_t display_buffer[DISPLAY_PAGES][DISPLAY_WIDTH];
+
+/* The dirty window of each page.  A clean page has its start past its end. */
+static uint8_t dirtyStart[DISPLAY_PAGES];
+static uint8_t dirtyEnd[DISPLAY_PAGES];
+
+/* Pages being sent in the background, bit 0 for page 0.  Cleared by the
+   transport's interrupt as each page goes. */
+static volatile uint8_t pageLock;
+
+/* text settings */
+static uint8_t cursorX, cursorY;
+static uint8_t textSize = 1;
+static uint8_t textColour = DISPLAY_WHITE;
+
+/* display_mark()
+
+   Add column 'x' of 'page' to the page's dirty window.
+*/
+static inline void display_mark(uint8_t page, uint8_t x)
+{
+  if(x < dirtyStart[page])
+  {
+    dirtyStart[page] = x;
+  }
+  if(x > dirtyEnd[page])
+  {
+    dirtyEnd[page] = x;
+  }
+
+}/* end display_mark() */
+
+/* display_write_bits()
+
+   Replace the bits of one frame buffer byte picked out by 'mask' with the
+   same bits of 'bits'.  Marks the column dirty only if the byte changed.
+*/
+static void display_write_bits(uint8_t page, uint8_t x, uint8_t mask, uint8_t bits)
+{
+  uint8_t old, value;
+
+/* wait for the transport to finish with this page */
+  while(pageLock & (1 << page))
+  {
+  }
+
+  old = display_buffer[page][x];
+  value = (old & ~mask) | (bits & mask);
+
+  if(value != old)
+  {
+    display_buffer[page][x] = value;
+    display_mark(page, x);
+  }
+
+}/* end display_write_bits() */
+
+/* display_write_byte()
+
+   Set the bits of one frame buffer byte picked out by 'mask' to 'colour'.
+*/
+static inline void display_write_byte(uint8_t page, uint8_t x, uint8_t mask, uint8_t colour)
+{
+  display_write_bits(page, x, mask, (colour == DISPLAY_BLACK) ? 0x00 : 0xff);
+
+}/* end display_write_byte() */
+
+/* display_init()
+
+   Clear the buffer, mark it all dirty and reset the text settings.
+*/
+void display_init(void)
+{
+  uint8_t page, x;
+
+  for(page = 0; page < DISPLAY_PAGES; page++)
+  {
+    for(x = 0; x < DISPLAY_WIDTH; x++)
+    {
+      display_buffer[page][x] = 0;
+    }
+    dirtyStart[page] = 0;
+    dirtyEnd[page] = DISPLAY_MAX_X;
+  }
+
+  cursorX = cursorY = 0;
+  textSize = 1;
+  textColour = DISPLAY_WHITE;
+
+}/* end display_init() */
+
+/* display_clear()
+
+   Set every pixel to black.
+*/
+void display_clear(void)
+{
+  display_draw_filled_rectangle(0, 0, DISPLAY_MAX_X, DISPLAY_MAX_Y, DISPLAY_BLACK);
+
+}/* end display_clear() */
+
+/* display_draw_pixel()
+
+   Set one pixel to 'colour'.
+*/
+void display_draw_pixel(uint8_t x, uint8_t y, uint8_t colour)
+{
+  if((x < DISPLAY_WIDTH) && (y < DISPLAY_HEIGHT))
+  {
+    display_write_byte(y >> 3, x, _BV(y & 7), colour);
+  }
+
+}/* end display_draw_pixel() */
+
+/* display_draw_line()
+
+   Bresenham's line algorithm, stepping one pixel at a time along the longer
+   axis.
+*/
+void display_draw_line(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t colour)
+{
+  int16_t dx = abs((int16_t)x1 - x0);
+  int16_t dy = -abs((int16_t)y1 - y0);
+  int8_t sx = (x0 < x1) ? 1 : -1;
+  int8_t sy = (y0 < y1) ? 1 : -1;
+  int16_t err = dx + dy;
+  int16_t err2;
+
+  while(1)
+  {
+    display_draw_pixel(x0, y0, colour);
+
+    if((x0 == x1) && (y0 == y1))
+    {
+      break;
+    }
+
+    err2 = err * 2;
+    if(err2 >= dy)
+    {
+      err += dy;
+      x0 += sx;
+    }
+    if(err2 <= dx)
+    {
+      err += dx;
+      y0 += sy;
+    }
+  }
+
+}/* end display_draw_line() */
+
+/* display_draw_filled_rectangle()
+
+   Fill a rectangle a page at a time, one byte per column in each page.
+*/
+void display_draw_filled_rectangle(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t colour)
+{
+  uint8_t page, lastPage, mask, x, temp;
+
+  if(x0 > x1)
+  {
+    temp = x0;
+    x0 = x1;
+    x1 = temp;
+  }
+  if(y0 > y1)
+  {
+    temp = y0;
+    y0 = y1;
+    y1 = temp;
+  }
+  if((x0 > DISPLAY_MAX_X) || (y0 > DISPLAY_MAX_Y))
+  {
+    return;
+  }
+  if(x1 > DISPLAY_MAX_X)
+  {
+    x1 = DISPLAY_MAX_X;
+  }
+  if(y1 > DISPLAY_MAX_Y)
+  {
+    y1 = DISPLAY_MAX_Y;
+  }
+
+  lastPage = y1 >> 3;
+  for(page = y0 >> 3; page <= lastPage; page++)
+  {
+  /* the rows of this page inside the rectangle */
+    mask = 0xff;
+    if(page == (y0 >> 3))
+    {
+      mask &= 0xff << (y0 & 7);
+    }
+    if(page == lastPage)
+    {
+      mask &= 0xff >> (7 - (y1 & 7));
+    }
+
+    for(x = x0; x <= x1; x++)
+    {
+      display_write_byte(page, x, mask, colour);
+    }
+  }
+
+}/* end display_draw_filled_rectangle() */
+
+/* display_set_cursor()
+
+   Move the text cursor.
+*/
+void display_set_cursor(uint8_t x, uint8_t y)
+{
+  cursorX = x;
+  cursorY = y;
+
+}/* end display_set_cursor() */
+
+/* display_set_text_size()
+
+   Set the text magnification, 1 or more.
+*/
+void display_set_text_size(uint8_t size)
+{
+  textSize = (size > 0) ? size : 1;
+
+}/* end display_set_text_size() */
+
+/* display_set_text_colour()
+
+   Set the colour of the text, the background is the other colour.
+*/
+void display_set_text_colour(uint8_t colour)
+{
+  textColour = colour;
+
+}/* end display_set_text_colour() */
+
+/* display_blit_char()
+
+   Draw one size 1 character cell at the cursor a column at a time.  A font
+   column is already laid out like a frame buffer byte, so if the cell sits on
+   a page it is copied straight in.  Otherwise it straddles two pages, and the
+   column is shifted down into the first page and up into the second, each
+   written through a mask that leaves the pixels outside the cell alone.
+*/
+static void display_blit_char(const uint8_t *glyph)
+{
+  uint8_t page = cursorY >> 3;
+  uint8_t shift = cursorY & 7;
+  uint8_t x = cursorX;
+  uint8_t column, i;
+
+  for(i = 0; i < DISPLAY_CELL_WIDTH; i++, x++)
+  {
+    if(x >= DISPLAY_WIDTH)
+    {
+      return;
+    }
+
+  /* the last column of the cell is the gap between characters */
+    column = (i < DISPLAY_FONT_WIDTH) ? pgm_read_byte(&glyph[i]) : 0;
+    if(textColour == DISPLAY_BLACK)
+    {
+      column = ~column;
+    }
+
+    if(shift == 0)
+    {
+      display_write_bits(page, x, 0xff, column);
+    }
+    else
+    {
+      display_write_bits(page, x, 0xff << shift, column << shift);
+      if(page < DISPLAY_PAGES - 1)
+      {
+        display_write_bits(page + 1, x, 0xff >> (8 - shift), column >> (8 - shift));
+      }
+    }
+  }
+
+}/* end display_blit_char() */
+
+/* display_putChar()
+
+   Draw one character cell at the cursor and move the cursor to the next
+   cell.  Size 1 text goes through display_blit_char(), larger sizes are drawn
+   pixel by pixel.
+*/
+void display_putChar(char c)
+{
+  const uint8_t *glyph;
+  uint8_t column, bits, row, i, j;
+  uint8_t x, y;
+
+  if(c == '\n')
+  {
+    cursorX = 0;
+    cursorY += DISPLAY_CELL_HEIGHT * textSize;
+    return;
+  }
+
+  glyph = display_font_glyph(c);
+
+  if(textSize == 1)
+  {
+    if(cursorY < DISPLAY_HEIGHT)
+    {
+      display_blit_char(glyph);
+    }
+    cursorX += DISPLAY_CELL_WIDTH;
+    return;
+  }
+
+  for(column = 0; column < DISPLAY_CELL_WIDTH; column++)
+  {
+  /* the last column of the cell is the gap between characters */
+    bits = (column < DISPLAY_FONT_WIDTH) ? pgm_read_byte(&glyph[column]) : 0;
+
+    for(row = 0; row < DISPLAY_CELL_HEIGHT; row++)
+    {
+      for(i = 0; i < textSize; i++)
+      {
+        x = cursorX + column * textSize + i;
+        for(j = 0; j < textSize; j++)
+        {
+          y = cursorY + row * textSize + j;
+          display_draw_pixel(x, y, (bits & 1) ? textColour : !textColour);
+        }
+      }
+      bits >>= 1;
+    }
+  }
+
+  cursorX += DISPLAY_CELL_WIDTH * textSize;
+
+}/* end display_putChar() */
+
+/* display_putStr()
+
+   Draw a string at the cursor.
+*/
+void display_putStr(const char *str)
+{
+  while(*str)
+  {
+    display_putChar(*str++);
+  }
+
+}/* end display_putStr() */
+
+/* display_putField()
+
+   Draw a string in a field 'width' characters wide.  Shorter strings are
+   padded with spaces, which draws over any characters left from a longer
+   string, longer ones are cut off.
+*/
+void display_putField(const char *str, uint8_t width)
+{
+  while(width-- > 0)
+  {
+    if(*str)
+    {
+      display_putChar(*str++);
+    }
+    else
+    {
+      display_putChar(' ');
+    }
+  }
+
+}/* end display_putField() */
+
+/* display_mark_dirty()
+
+   Mark a rectangle as changed.
+*/
+void display_mark_dirty(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1)
+{
+  uint8_t page;
+
+  if(x1 > DISPLAY_MAX_X)
+  {
+    x1 = DISPLAY_MAX_X;
+  }
+  if(y1 > DISPLAY_MAX_Y)
+  {
+    y1 = DISPLAY_MAX_Y;
+  }
+
+  for(page = y0 >> 3; page <= (y1 >> 3); page++)
+  {
+    display_mark(page, x0);
+    display_mark(page, x1);
+  }
+
+}/* end display_mark_dirty() */
+
+/* display_get_dirty()
+
+   Hand the dirty window of 'page' to a transport and mark the page clean.
+*/
+uint8_t display_get_dirty(uint8_t page, uint8_t *x0, uint8_t *x1)
+{
+  if(dirtyStart[page] > dirtyEnd[page])
+  {
+    return(DISPLAY_CLEAN);
+  }
+
+  *x0 = dirtyStart[page];
+  *x1 = dirtyEnd[page];
+  dirtyStart[page] = DISPLAY_WIDTH;
+  dirtyEnd[page] = 0;
+
+  return(DISPLAY_DIRTY);
+
+}/* end display_get_dirty() */
+
+/* display_lock_pages()
+
+   Lock the pages in 'mask'.
+*/
+void display_lock_pages(uint8_t mask)
+{
+  pageLock = mask;
+
+}/* end display_lock_pages() */
+
+/* display_unlock_page()
+
+   Unlock one page.  A single byte write, so it is safe from an interrupt.
+*/
+void display_unlock_page(uint8_t page)
+{
+  pageLock &= ~(1 << page);
+
+}/* end display_unlock_page() */
@@ -0,0 +1,168 @@
+/*
+ * display.h
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Frame buffer graphics for a 128x64 SSD1306 OLED display.  Drawing only
+ * changes the copy of the display in RAM.  One of the transports,
+ * display_spi.h or display_i2c.h, sends the changes to the display.
+ *
+ * The buffer is laid out the way the SSD1306 wants it: eight pages of 128
+ * bytes, each byte a column of 8 pixels with the top pixel in bit 0.
+ *
+ * Every page keeps track of the first and last column that has changed since
+ * it was last sent (its dirty window).  A pixel only counts as changed if its
+ * value really changed, so redrawing the same text over itself costs nothing.
+ * The transports send just the dirty windows, using the SSD1306 column and
+ * page address commands to put each window in the right place.  A screen of
+ * sensor readings where a few digits change each time sends a few dozen bytes
+ * instead of 1024.
+ *
+ * A transport that sends in the background (display_spi_start()) locks the
+ * pages it still has to send.  Drawing into a locked page waits until the
+ * page has gone, so the display never shows a half drawn page and no second
+ * frame buffer is needed.  Drawing into a page that has already been sent,
+ * or one that had no changes, goes ahead at once.  Don't draw with
+ * interrupts disabled while a background update is running.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef DISPLAY_H_
+#define DISPLAY_H_
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+
+/* size of the display */
+#define DISPLAY_WIDTH  128
+#define DISPLAY_HEIGHT 64
+#define DISPLAY_PAGES  (DISPLAY_HEIGHT / 8)
+#define DISPLAY_MAX_X  (DISPLAY_WIDTH - 1)
+#define DISPLAY_MAX_Y  (DISPLAY_HEIGHT - 1)
+
+/* pixel colours */
+#define DISPLAY_BLACK 0
+#define DISPLAY_WHITE 1
+
+/* display_get_dirty() return values */
+#define DISPLAY_CLEAN 0
+#define DISPLAY_DIRTY 1
+
+/* SSD1306 commands used by the transports */
+#define SSD1306_SET_COLUMN_ADDR 0x21
+#define SSD1306_SET_PAGE_ADDR   0x22
+#define SSD1306_SEG_REMAP_0     0xa0
+#define SSD1306_SEG_REMAP_127   0xa1
+#define SSD1306_COM_SCAN_INC    0xc0
+#define SSD1306_COM_SCAN_DEC    0xc8
+
+/* SSD1306 scrolling.  The one column scrolls shift part of the display RAM by
+   one column each time they are sent, see display_chart.h. */
+#define SSD1306_SCROLL_RIGHT_ONE  0x2c
+#define SSD1306_SCROLL_LEFT_ONE   0x2d
+#define SSD1306_DEACTIVATE_SCROLL 0x2e
+
+/* The commands that set up the display: horizontal addressing mode (needed
+   for the column and page windows), charge pump on, display on.  In
+   display_ssd1306.c, which every program using the display links. */
+#define DISPLAY_SSD1306_INIT_LENGTH 25
+extern const uint8_t display_ssd1306_init[DISPLAY_SSD1306_INIT_LENGTH] PROGMEM;
+
+/* the frame buffer */
+extern uint8_t display_buffer[DISPLAY_PAGES][DISPLAY_WIDTH];
+
+/* display_init()
+
+   Clear the frame buffer and mark the whole screen dirty, so the first update
+   sends all of it.  Sets the cursor to (0, 0) and white text of size 1.
+*/
+void display_init(void);
+
+/* display_clear()
+
+   Set every pixel to black.
+*/
+void display_clear(void);
+
+/* display_draw_pixel()
+
+   Set one pixel to 'colour'.  Pixels off the screen are ignored.
+*/
+void display_draw_pixel(uint8_t x, uint8_t y, uint8_t colour);
+
+/* display_draw_line()
+
+   Draw a line from (x0, y0) to (x1, y1), both ends included.
+*/
+void display_draw_line(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t colour);
+
+/* display_draw_filled_rectangle()
+
+   Fill the rectangle with corners (x0, y0) and (x1, y1), both included.
+   Writes whole bytes where it can, so it is much faster than drawing pixels.
+*/
+void display_draw_filled_rectangle(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t colour);
+
+/* display_set_cursor(), display_set_text_size(), display_set_text_colour()
+
+   Text is drawn with a 5x7 font in a 6x8 cell, with the top left corner of
+   the cell at the cursor.  Size 2 doubles the cell in both directions.  The
+   whole cell is drawn, the character in 'colour' on the opposite colour, so
+   new text covers up old text.
+*/
+void display_set_cursor(uint8_t x, uint8_t y);
+void display_set_text_size(uint8_t size);
+void display_set_text_colour(uint8_t colour);
+
+/* display_putChar(), display_putStr()
+
+   Draw a character or string at the cursor and move the cursor along.  '\n'
+   moves it to the start of the next line.
+
+   Size 1 text is copied into the frame buffer a font column at a time, one
+   byte write per column when the cursor's y is a multiple of 8, two masked
+   writes otherwise.  That takes roughly 400 to 700 cycles a character,
+   against about 3,000 for setting the 48 pixels of the cell one by one (the
+   way larger sizes are still drawn).
+*/
+void display_putChar(char c);
+void display_putStr(const char *str);
+
+/* display_putField()
+
+   Draw a string in a fixed width field of 'width' characters, padded with
+   spaces.  A number that gets shorter overwrites its old digits in the same
+   pass, with no separate erase.
+*/
+void display_putField(const char *str, uint8_t width);
+
+/* display_mark_dirty()
+
+   Mark a rectangle as changed.  Only needed by code that writes to
+   display_buffer directly.
+*/
+void display_mark_dirty(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1);
+
+/* display_get_dirty()
+
+   Used by the transports.  If any of 'page' has changed, stores its first and
+   last changed column in 'x0' and 'x1', marks the page clean and returns
+   DISPLAY_DIRTY.  Otherwise returns DISPLAY_CLEAN.
+*/
+uint8_t display_get_dirty(uint8_t page, uint8_t *x0, uint8_t *x1);
+
+/* display_lock_pages(), display_unlock_page()
+
+   Used by the transports.  Lock the pages in 'mask' (bit 0 is page 0) before
+   sending them in the background, unlock each one once it has been sent.
+   display_unlock_page() may be called from an interrupt.
+*/
+void display_lock_pages(uint8_t mask);
+void display_unlock_page(uint8_t page);
+
+#endif /* DISPLAY_H_ */
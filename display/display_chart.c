@@ -0,0 +1,342 @@
+/*
+ * display_chart.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * A strip chart scrolled by the display.  See display_chart.h.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include "display.h"
+#include "display_chart.h"
+
+/* Moves the chart towards column x0.  In display RAM that is a left scroll
+   whichever way the display is mounted. */
+#define DISPLAY_CHART_SCROLL SSD1306_SCROLL_LEFT_ONE
+
+/* columns sent at a time while redrawing */
+#define DISPLAY_CHART_CHUNK 16
+
+/* display_chart_width(), display_chart_height()
+
+   The size of the chart in columns and rows.
+*/
+static inline uint8_t display_chart_width(const Display_Chart *chart)
+{
+  return(chart->x1 - chart->x0 + 1);
+
+}/* end display_chart_width() */
+
+static inline uint8_t display_chart_height(const Display_Chart *chart)
+{
+  return((chart->page1 - chart->page0 + 1) * 8);
+
+}/* end display_chart_height() */
+
+/* display_chart_row()
+
+   The row of the chart a value falls on, 0 at the top, clipped to the chart.
+*/
+static uint8_t display_chart_row(const Display_Chart *chart, int16_t value)
+{
+  int32_t row = ((int32_t)value - chart->low) >> chart->shift;
+  uint8_t height = display_chart_height(chart);
+
+  if(row < 0)
+  {
+    row = 0;
+  }
+  else if(row >= height)
+  {
+    row = height - 1;
+  }
+
+  return(height - 1 - (uint8_t)row);
+
+}/* end display_chart_row() */
+
+/* display_chart_byte()
+
+   The byte of one page of one column, the bar from 'top' to 'bottom'.  'page'
+   counts from the top of the chart.
+*/
+static uint8_t display_chart_byte(uint8_t top, uint8_t bottom, uint8_t page)
+{
+  int8_t first = (int8_t)(top - page * 8);
+  int8_t last = (int8_t)(bottom - page * 8);
+
+  if((last < 0) || (first > 7))
+  {
+    return(0);
+  }
+  if(first < 0)
+  {
+    first = 0;
+  }
+  if(last > 7)
+  {
+    last = 7;
+  }
+
+  return((uint8_t)((0xff << first) & (0xff >> (7 - last))));
+
+}/* end display_chart_byte() */
+
+/* display_chart_column()
+
+   The byte of one page of the column at 'index' in the ring.  An empty column
+   is blank.
+*/
+static uint8_t display_chart_column(const Display_Chart *chart, uint8_t index, uint8_t page)
+{
+  if(chart->min[index] > chart->max[index])
+  {
+    return(0);
+  }
+
+  return(display_chart_byte(display_chart_row(chart, chart->max[index]),
+                            display_chart_row(chart, chart->min[index]), page));
+
+}/* end display_chart_column() */
+
+/* display_chart_window()
+
+   Send the commands that set the column and page window.
+*/
+static void display_chart_window(const Display_Chart *chart, uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1)
+{
+  uint8_t commands[6];
+
+  commands[0] = SSD1306_SET_COLUMN_ADDR;
+  commands[1] = x0;
+  commands[2] = x1;
+  commands[3] = SSD1306_SET_PAGE_ADDR;
+  commands[4] = page0;
+  commands[5] = page1;
+  chart->command(commands, 6);
+
+}/* end display_chart_window() */
+
+/* display_chart_scale()
+
+   Find the extremes of the chart and check they still fit the scale.  If they
+   don't, or they take up less than a quarter of it, pick a new scale with the
+   chart half full and centred.  Returns 1 if the scale changed.
+*/
+static uint8_t display_chart_scale(Display_Chart *chart)
+{
+  uint8_t width = display_chart_width(chart);
+  uint8_t height = display_chart_height(chart);
+  int16_t min = 32767, max = -32768;
+  int32_t span, range, low;
+  uint8_t i;
+
+  for(i = 0; i < width; i++)
+  {
+    if(chart->min[i] < min)
+    {
+      min = chart->min[i];
+    }
+    if(chart->max[i] > max)
+    {
+      max = chart->max[i];
+    }
+  }
+
+  if(min > max)/* empty */
+  {
+    chart->chartMin = chart->chartMax = 0;
+    return(0);
+  }
+  chart->chartMin = min;
+  chart->chartMax = max;
+
+  span = (int32_t)max - min + 1;
+  range = (int32_t)height << chart->shift;
+
+  if((min >= chart->low) && ((int32_t)max - chart->low < range) &&
+     ((chart->shift == 0) || (span * 4 > range)))
+  {
+    return(0);
+  }
+
+/* the smallest scale the chart fills no more than half of */
+  chart->shift = 0;
+  while(((int32_t)height << chart->shift) < span * 2)
+  {
+    chart->shift++;
+  }
+  range = (int32_t)height << chart->shift;
+
+/* centred, but kept where the whole scale is inside the int16_t range, or
+   starts at its bottom if it is bigger, so 'low' can't wrap around and fail
+   the test above for every column */
+  low = (((int32_t)min + max) - range) / 2;
+  if(low > 32768L - range)
+  {
+    low = 32768L - range;
+  }
+  if(low < -32768L)
+  {
+    low = -32768L;
+  }
+  chart->low = (int16_t)low;
+
+  return(1);
+
+}/* end display_chart_scale() */
+
+/* display_chart_init()
+
+   Fill in the chart, empty every column and clear it on the display.
+*/
+void display_chart_init(Display_Chart *chart, uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1,
+                        uint8_t samplesPerColumn, Display_Chart_Send command, Display_Chart_Send data)
+{
+  uint8_t i, stop = SSD1306_DEACTIVATE_SCROLL;
+
+  if(x1 - x0 + 1 > DISPLAY_CHART_MAX_WIDTH)
+  {
+    x1 = x0 + DISPLAY_CHART_MAX_WIDTH - 1;
+  }
+
+  chart->command = command;
+  chart->data = data;
+  chart->x0 = x0;
+  chart->x1 = x1;
+  chart->page0 = page0;
+  chart->page1 = page1;
+  chart->samplesPerColumn = samplesPerColumn;
+  chart->sampleCount = 0;
+  chart->newest = 0;
+  chart->chartMin = chart->chartMax = 0;
+  chart->low = 0;
+  chart->shift = 0;
+
+  for(i = 0; i < DISPLAY_CHART_MAX_WIDTH; i++)
+  {
+    chart->min[i] = 32767;
+    chart->max[i] = -32768;
+  }
+
+  chart->command(&stop, 1);
+  display_chart_redraw(chart);
+
+}/* end display_chart_init() */
+
+/* display_chart_redraw()
+
+   Send the chart a page at a time, oldest column first, a chunk of columns
+   at a time so no page sized buffer is needed.
+*/
+uint16_t display_chart_redraw(Display_Chart *chart)
+{
+  uint8_t chunk[DISPLAY_CHART_CHUNK];
+  uint8_t width = display_chart_width(chart);
+  uint8_t page, column, index, count;
+
+  for(page = chart->page0; page <= chart->page1; page++)
+  {
+    display_chart_window(chart, chart->x0, chart->x1, page, page);
+
+    index = chart->newest;
+    count = 0;
+    for(column = 0; column < width; column++)
+    {
+      if(++index == width)
+      {
+        index = 0;
+      }
+      chunk[count] = display_chart_column(chart, index, page - chart->page0);
+      if(++count == DISPLAY_CHART_CHUNK)
+      {
+        chart->data(chunk, count);
+        count = 0;
+      }
+    }
+    if(count > 0)
+    {
+      chart->data(chunk, count);
+    }
+  }
+
+  return((uint16_t)(chart->page1 - chart->page0 + 1) * (6 + width));
+
+}/* end display_chart_redraw() */
+
+/* display_chart_add()
+
+   Collect the sample into the column.  When the column is full put it in the
+   ring in place of the oldest, then either redraw with a new scale or scroll
+   and send just the new column.
+*/
+uint16_t display_chart_add(Display_Chart *chart, int16_t sample)
+{
+  uint8_t commands[8];
+  uint8_t column[8];
+  uint8_t pages = chart->page1 - chart->page0 + 1;
+  uint8_t page;
+
+  if((chart->sampleCount == 0) || (sample < chart->sampleMin))
+  {
+    chart->sampleMin = sample;
+  }
+  if((chart->sampleCount == 0) || (sample > chart->sampleMax))
+  {
+    chart->sampleMax = sample;
+  }
+  if(++chart->sampleCount < chart->samplesPerColumn)
+  {
+    return(0);
+  }
+  chart->sampleCount = 0;
+
+  if(++chart->newest == display_chart_width(chart))
+  {
+    chart->newest = 0;
+  }
+  chart->min[chart->newest] = chart->sampleMin;
+  chart->max[chart->newest] = chart->sampleMax;
+
+  if(display_chart_scale(chart))
+  {
+    return(display_chart_redraw(chart));
+  }
+
+  commands[0] = DISPLAY_CHART_SCROLL;
+  commands[1] = 0x00;
+  commands[2] = chart->page0;
+  commands[3] = 0x01;
+  commands[4] = chart->page1;
+  commands[5] = 0x00;
+  commands[6] = chart->x0;
+  commands[7] = chart->x1;
+  chart->command(commands, 8);
+
+  for(page = 0; page < pages; page++)
+  {
+    column[page] = display_chart_column(chart, chart->newest, page);
+  }
+  display_chart_window(chart, chart->x1, chart->x1, chart->page0, chart->page1);
+  chart->data(column, pages);
+
+  return(8 + 6 + pages);
+
+}/* end display_chart_add() */
+
+/* display_chart_get_extremes()
+
+   Returns what display_chart_scale() found.
+*/
+void display_chart_get_extremes(const Display_Chart *chart, int16_t *min, int16_t *max)
+{
+  *min = chart->chartMin;
+  *max = chart->chartMax;
+
+}/* end display_chart_get_extremes() */
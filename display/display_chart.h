@@ -0,0 +1,106 @@
+/*
+ * display_chart.h
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * A scrolling strip chart drawn straight on the display, for watching a
+ * signal such as vibration over the last few seconds.  The newest column is
+ * on the right.  Each new column is added like this:
+ *
+ *    - one SSD1306 one column scroll command (8 bytes) moves the chart one
+ *      column to the left inside the display itself
+ *    - a one column window (6 bytes) and the new column (one byte per page)
+ *      are written at the right hand edge
+ *
+ * A five page chart costs 19 bytes per column however wide it is, against
+ * 640 bytes to send the whole chart again.  Nothing goes through the frame
+ * buffer, so the chart's pages must not be drawn with display.h, and it works
+ * with display_list.h as well.
+ *
+ * Each column covers several samples and shows their smallest and largest
+ * values as a vertical bar, so short peaks are never lost between columns.
+ * The vertical scale follows the signal.  When a new column doesn't fit, or
+ * everything on the chart fits in a quarter of its height, the scale is
+ * worked out again so the chart is half full, and the whole chart is
+ * redrawn.  With the factor of two either way that happens rarely.
+ *
+ * The one column scroll commands (2Ch and 2Dh) are in later revisions of the
+ * SSD1306 datasheet.  The controller needs two frames (about 20ms at the
+ * clock set up by display_init()) between them, so add columns no faster than
+ * 50 a second.  The continuous scroll (26h, 27h and 2Fh) isn't used, it moves
+ * at a rate set in frames rather than with the samples.  If the chart runs
+ * the wrong way with the display flipped, swap the scroll command in
+ * display_chart.c.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef DISPLAY_CHART_H_
+#define DISPLAY_CHART_H_
+
+#include <avr/io.h>
+
+/* the widest chart */
+#define DISPLAY_CHART_MAX_WIDTH 128
+
+/* Sends bytes to the display as commands or as data, for example
+   display_spi_send_commands() and display_spi_send_data(). */
+typedef void (*Display_Chart_Send)(const uint8_t *bytes, uint8_t length);
+
+/* one chart */
+typedef struct
+{
+  Display_Chart_Send command, data;
+  uint8_t x0, x1, page0, page1;
+
+/* the column being collected */
+  uint8_t samplesPerColumn, sampleCount;
+  int16_t sampleMin, sampleMax;
+
+/* the columns on the chart, a ring with the newest at 'newest', and the
+   extremes of all of them */
+  uint8_t newest;
+  int16_t min[DISPLAY_CHART_MAX_WIDTH], max[DISPLAY_CHART_MAX_WIDTH];
+  int16_t chartMin, chartMax;
+
+/* the scale, a row is 2^shift counts and the bottom row starts at 'low' */
+  int16_t low;
+  uint8_t shift;
+} Display_Chart;
+
+/* display_chart_init()
+
+   Set up an empty chart on columns 'x0' to 'x1' and pages 'page0' to 'page1'
+   (eight rows to a page), with 'samplesPerColumn' samples in each column.
+   Clears that part of the display.
+*/
+void display_chart_init(Display_Chart *chart, uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1,
+                        uint8_t samplesPerColumn, Display_Chart_Send command, Display_Chart_Send data);
+
+/* display_chart_add()
+
+   Add a sample.  Once a column is full it goes on the chart.  Returns the
+   number of bytes sent to the display: 0 until a column is full, then
+   8 + 6 + one per page, or the whole chart if the scale changed.
+*/
+uint16_t display_chart_add(Display_Chart *chart, int16_t sample);
+
+/* display_chart_redraw()
+
+   Clear the chart area and draw every column again.  Returns the number of
+   bytes sent.
+*/
+uint16_t display_chart_redraw(Display_Chart *chart);
+
+/* display_chart_get_extremes()
+
+   The smallest and largest sample on the chart.  Both are 0 while the chart
+   is empty.
+*/
+void display_chart_get_extremes(const Display_Chart *chart, int16_t *min, int16_t *max);
+
+#endif /* DISPLAY_CHART_H_ */
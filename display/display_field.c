@@ -0,0 +1,95 @@
+/*
+ * display_field.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Numeric fields that are only redrawn when their value changes.  See
+ * display_field.h.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include "fmt/fmt.h"
+#include "display.h"
+#include "display_field.h"
+
+/* display_field_init()
+
+   Fill in the field, not yet drawn.
+*/
+void display_field_init(Display_Field *field, uint8_t x, uint8_t y, uint8_t width, uint8_t format, int16_t scale)
+{
+  if(width > DISPLAY_FIELD_MAX_WIDTH)
+  {
+    width = DISPLAY_FIELD_MAX_WIDTH;
+  }
+
+  field->x = x;
+  field->y = y;
+  field->width = width;
+  field->format = format;
+  field->scale = scale;
+  field->value = 0;
+  field->drawn = 0;
+
+}/* end display_field_init() */
+
+/* display_field_set()
+
+   Scale the value and compare it with the one on the screen.  Only if it is
+   different, format it and draw it.
+*/
+uint8_t display_field_set(Display_Field *field, int16_t value)
+{
+  char str[DISPLAY_FIELD_MAX_WIDTH + 1];
+
+  if(field->scale != DISPLAY_FIELD_NO_SCALE)
+  {
+    value = fmt_scale(value, field->scale);
+  }
+
+  if(field->drawn && (value == field->value))
+  {
+    return(0);
+  }
+
+  switch(field->format)
+  {
+    case DISPLAY_FIELD_HEX:
+      fmt_hex16(value, str);
+      break;
+
+    case DISPLAY_FIELD_UDEC:
+      fmt_udec16(value, field->width, str);
+      break;
+
+    default:
+      fmt_dec16(value, field->width, str);
+      break;
+
+  }/* end switch(field->format) */
+
+  display_set_cursor(field->x, field->y);
+  display_putField(str, field->width);
+
+  field->value = value;
+  field->drawn = 1;
+
+  return(1);
+
+}/* end display_field_set() */
+
+/* display_field_invalidate()
+
+   Forget what the field shows.
+*/
+void display_field_invalidate(Display_Field *field)
+{
+  field->drawn = 0;
+
+}/* end display_field_invalidate() */
@@ -0,0 +1,75 @@
+/*
+ * display_field.h
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Numeric fields on the display that are only redrawn when their value
+ * changes.  Each field remembers the last value it drew.  Setting it to the
+ * same value again returns straight away, with no formatting, no drawing and
+ * nothing marked for sending.  A board sitting still costs a compare per
+ * field per frame, and the update sends nothing.
+ *
+ * A field can scale its value to physical units (see FMT_SCALE() in
+ * fmt/fmt.h).  The scaled value is what gets compared, so sensor noise smaller
+ * than one displayed unit doesn't cause a redraw either.
+ *
+ * Fields are drawn in the text size and colour set at the time, see
+ * display.h.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef DISPLAY_FIELD_H_
+#define DISPLAY_FIELD_H_
+
+#include <avr/io.h>
+
+/* formats */
+#define DISPLAY_FIELD_HEX  0 /* 4 hex digits, width 4 */
+#define DISPLAY_FIELD_DEC  1 /* signed decimal, right justified */
+#define DISPLAY_FIELD_UDEC 2 /* unsigned decimal, right justified */
+
+/* no scaling, for display_field_init() */
+#define DISPLAY_FIELD_NO_SCALE 0
+
+/* the widest field, in characters */
+#define DISPLAY_FIELD_MAX_WIDTH 7
+
+/* one field */
+typedef struct
+{
+  uint8_t x, y;
+  uint8_t width;
+  uint8_t format;
+  int16_t scale;
+  int16_t value;
+  uint8_t drawn;
+} Display_Field;
+
+/* display_field_init()
+
+   Set up a field 'width' characters wide with its top left corner at (x, y).
+   'scale' is from FMT_SCALE() or DISPLAY_FIELD_NO_SCALE.  Nothing is drawn
+   until the first display_field_set().
+*/
+void display_field_init(Display_Field *field, uint8_t x, uint8_t y, uint8_t width, uint8_t format, int16_t scale);
+
+/* display_field_set()
+
+   Show 'value' in the field.  Returns 1 if the field was redrawn, 0 if it
+   already showed that value.
+*/
+uint8_t display_field_set(Display_Field *field, int16_t value);
+
+/* display_field_invalidate()
+
+   Make the next display_field_set() redraw the field, for after the screen
+   has been cleared or drawn over.
+*/
+void display_field_invalidate(Display_Field *field);
+
+#endif /* DISPLAY_FIELD_H_ */
@@ -0,0 +1,50 @@
+/*
+ * display_font.h
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * 5x7 font for printable ASCII, ' ' to '~'.  Each character is five bytes,
+ * one per column from left to right, top pixel in bit 0, the same layout as
+ * the SSD1306 display memory.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef DISPLAY_FONT_H_
+#define DISPLAY_FONT_H_
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+
+#define DISPLAY_FONT_FIRST  ' '
+#define DISPLAY_FONT_LAST   '~'
+#define DISPLAY_FONT_WIDTH  5
+#define DISPLAY_FONT_HEIGHT 7
+
+/* size of a character cell, including the space to the right and below */
+#define DISPLAY_CELL_WIDTH  6
+#define DISPLAY_CELL_HEIGHT 8
+
+extern const uint8_t display_font[(DISPLAY_FONT_LAST - DISPLAY_FONT_FIRST + 1) * DISPLAY_FONT_WIDTH] PROGMEM;
+
+/* display_font_glyph()
+
+   Returns the address in flash of the five columns of 'c'.  Characters
+   outside the font are drawn as a space.
+*/
+static inline const uint8_t *display_font_glyph(char c)
+{
+  if((c < DISPLAY_FONT_FIRST) || (c > DISPLAY_FONT_LAST))
+  {
+    c = ' ';
+  }
+
+  return(&display_font[(uint8_t)(c - DISPLAY_FONT_FIRST) * DISPLAY_FONT_WIDTH]);
+
+}/* end display_font_glyph() */
+
+#endif /* DISPLAY_FONT_H_ */
@@ -0,0 +1,179 @@
+/*
+ * display_i2c.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * I2C transport for the SSD1306 display: setting it up and sending bytes and
+ * pages straight to it.  Sending the frame buffer is in display_i2c_frame.c.
+ * See display_i2c.h.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include "display.h"
+#include "display_i2c.h"
+
+#ifdef DISPLAY_I2C_TWBR
+/* the bit rate of whoever else uses the bus, put back after each transfer */
+static uint8_t savedTwbr;
+#endif
+
+/* display_i2c_clock_begin(), display_i2c_clock_end()
+
+   If DISPLAY_I2C_TWBR is defined, switch the TWI to that bit rate for the
+   display and back again afterwards.  Otherwise do nothing.
+*/
+void display_i2c_clock_begin(void)
+{
+#ifdef DISPLAY_I2C_TWBR
+  savedTwbr = TWBR;
+  TWBR = DISPLAY_I2C_TWBR;
+#endif
+
+}/* end display_i2c_clock_begin() */
+
+void display_i2c_clock_end(void)
+{
+#ifdef DISPLAY_I2C_TWBR
+  TWBR = savedTwbr;
+#endif
+
+}/* end display_i2c_clock_end() */
+
+/* display_i2c_write()
+
+   Send one byte and wait for it to go.
+*/
+void display_i2c_write(uint8_t data)
+{
+  TWDR = data;
+  TWCR = _BV(TWINT) | _BV(TWEN);
+  loop_until_bit_is_set(TWCR, TWINT);
+
+}/* end display_i2c_write() */
+
+/* display_i2c_start()
+
+   Send a start condition, the display's address and a control byte.
+*/
+void display_i2c_start(uint8_t control)
+{
+  TWCR = _BV(TWINT) | _BV(TWSTA) | _BV(TWEN);
+  loop_until_bit_is_set(TWCR, TWINT);
+
+  display_i2c_write(DISPLAY_I2C_ADDRESS << 1);
+  display_i2c_write(control);
+
+}/* end display_i2c_start() */
+
+/* display_i2c_stop()
+
+   Send a stop condition and wait for it to finish.
+*/
+void display_i2c_stop(void)
+{
+  TWCR = _BV(TWINT) | _BV(TWSTO) | _BV(TWEN);
+  loop_until_bit_is_clear(TWCR, TWSTO);
+
+}/* end display_i2c_stop() */
+
+/* display_i2c_init()
+
+   Send the set up commands in one transfer.
+*/
+void display_i2c_init(void)
+{
+  uint8_t i;
+
+  display_i2c_clock_begin();
+  display_i2c_start(SSD1306_CONTROL_COMMAND);
+  for(i = 0; i < DISPLAY_SSD1306_INIT_LENGTH; i++)
+  {
+    display_i2c_write(pgm_read_byte(&display_ssd1306_init[i]));
+  }
+  display_i2c_stop();
+  display_i2c_clock_end();
+
+}/* end display_i2c_init() */
+
+/* display_i2c_flip_vertical()
+
+   Reverse both the column and the row scan direction.
+*/
+void display_i2c_flip_vertical(void)
+{
+  display_i2c_clock_begin();
+  display_i2c_start(SSD1306_CONTROL_COMMAND);
+  display_i2c_write(SSD1306_SEG_REMAP_0);
+  display_i2c_write(SSD1306_COM_SCAN_INC);
+  display_i2c_stop();
+  display_i2c_clock_end();
+
+}/* end display_i2c_flip_vertical() */
+
+/* display_i2c_write_page()
+
+   Send a whole page from 'data'.
+*/
+void display_i2c_write_page(uint8_t page, const uint8_t *data)
+{
+  uint8_t x;
+
+  display_i2c_clock_begin();
+  display_i2c_start(SSD1306_CONTROL_COMMAND);
+  display_i2c_write(SSD1306_SET_COLUMN_ADDR);
+  display_i2c_write(0);
+  display_i2c_write(DISPLAY_MAX_X);
+  display_i2c_write(SSD1306_SET_PAGE_ADDR);
+  display_i2c_write(page);
+  display_i2c_write(page);
+  display_i2c_stop();
+
+  display_i2c_start(SSD1306_CONTROL_DATA);
+  for(x = 0; x < DISPLAY_WIDTH; x++)
+  {
+    display_i2c_write(*data++);
+  }
+  display_i2c_stop();
+  display_i2c_clock_end();
+
+}/* end display_i2c_write_page() */
+
+/* display_i2c_send()
+
+   Send bytes in one transfer, after a control byte saying what they are.
+*/
+static void display_i2c_send(uint8_t control, const uint8_t *bytes, uint8_t length)
+{
+  display_i2c_clock_begin();
+  display_i2c_start(control);
+  while(length-- > 0)
+  {
+    display_i2c_write(*bytes++);
+  }
+  display_i2c_stop();
+  display_i2c_clock_end();
+
+}/* end display_i2c_send() */
+
+/* display_i2c_send_commands(), display_i2c_send_data()
+
+   Send bytes as commands or as display data.
+*/
+void display_i2c_send_commands(const uint8_t *commands, uint8_t length)
+{
+  display_i2c_send(SSD1306_CONTROL_COMMAND, commands, length);
+
+}/* end display_i2c_send_commands() */
+
+void display_i2c_send_data(const uint8_t *data, uint8_t length)
+{
+  display_i2c_send(SSD1306_CONTROL_DATA, data, length);
+
+}/* end display_i2c_send_data() */
@@ -0,0 +1,99 @@
+/*
+ * display_i2c.h
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * I2C transport for the SSD1306 display.  Sends the dirty windows of the frame
+ * buffer in display.h.  The TWI must already be set up, i2c_init() does that.
+ *
+ * At 400kHz each byte takes about 23us on the bus, so sending a full frame
+ * takes about 25ms.  Sending only the dirty windows usually cuts that to a
+ * millisecond or two.
+ *
+ * Each window is one transfer of commands and one of data, with no limit on
+ * the length of the data.  Dirty windows on neighbouring pages are sent as
+ * one window when that is cheaper, so a full frame is two transfers rather
+ * than sixteen.
+ *
+ * The SSD1306 accepts Fast-mode Plus, 1MHz.  Build with DISPLAY_I2C_TWBR set
+ * to the TWBR value for the display (0 gives F_CPU/16, 1MHz at 16MHz) and the
+ * display is sent at that rate, the bit rate going back to what i2c_init()
+ * set after each transfer so the other devices on the bus aren't affected.
+ * 1MHz is beyond the ATmega328's rated 400kHz and needs stronger pull ups
+ * (2.2k or less), so check it on the bench first.  display-bench.c measures
+ * the difference.
+ *
+ * display_i2c_update() is in display_i2c_frame.c, the rest in display_i2c.c,
+ * with the set up commands in display_ssd1306.c.  A program that only uses
+ * display_i2c_write_page() or the send functions, with display_list.h or
+ * display_chart.h, links display_i2c.c and display_ssd1306.c and leaves out
+ * the frame buffer.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef DISPLAY_I2C_H_
+#define DISPLAY_I2C_H_
+
+#include <avr/io.h>
+
+/* 7-bit I2C address of the display */
+#define DISPLAY_I2C_ADDRESS 0x3c
+
+/* The control byte that follows the address says what the rest of the
+   transfer is. */
+#define SSD1306_CONTROL_COMMAND 0x00
+#define SSD1306_CONTROL_DATA    0x40
+
+/* display_i2c_init()
+
+   Send the SSD1306 set up commands.
+*/
+void display_i2c_init(void);
+
+/* display_i2c_flip_vertical()
+
+   Turn the picture upside down, for displays mounted the other way up.
+*/
+void display_i2c_flip_vertical(void);
+
+/* display_i2c_update()
+
+   Send every dirty window to the display.  Returns the number of bytes sent,
+   addresses and commands included.
+*/
+uint16_t display_i2c_update(void);
+
+/* display_i2c_write_page()
+
+   Send 128 bytes from 'data' straight to one page of the display, without
+   using the frame buffer.  For display_list.h.
+*/
+void display_i2c_write_page(uint8_t page, const uint8_t *data);
+
+/* display_i2c_send_commands(), display_i2c_send_data()
+
+   Send 'length' bytes straight to the display as commands or as display
+   data, each in one transfer, without using the frame buffer.  For
+   display_chart.h.
+*/
+void display_i2c_send_commands(const uint8_t *commands, uint8_t length);
+void display_i2c_send_data(const uint8_t *data, uint8_t length);
+
+/* display_i2c_clock_begin(), display_i2c_clock_end(), display_i2c_start(),
+   display_i2c_write(), display_i2c_stop()
+
+   Used by display_i2c_frame.c.  Switch to the display's bit rate and back,
+   start a transfer with a control byte, send one byte, and end the transfer.
+*/
+void display_i2c_clock_begin(void);
+void display_i2c_clock_end(void);
+void display_i2c_start(uint8_t control);
+void display_i2c_write(uint8_t data);
+void display_i2c_stop(void);
+
+#endif /* DISPLAY_I2C_H_ */
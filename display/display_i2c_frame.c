@@ -0,0 +1,129 @@
+/*
+ * display_i2c_frame.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Sending the frame buffer in display.h over the I2C transport.  See
+ * display_i2c.h.  It is apart from display_i2c.c so that a program that only
+ * sends pages or bytes of its own doesn't link the frame buffer.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include "display.h"
+#include "display_i2c.h"
+
+/* What a window costs on top of its data, in bytes on the bus: one transfer
+   of six commands and the start of the data transfer, with their start and
+   stop conditions counted as a byte each. */
+#define DISPLAY_I2C_WINDOW_COST 14
+
+/* display_i2c_window()
+
+   Set the column and page window and send the frame buffer bytes inside it,
+   all of them in a single data transfer.  The display fills the window a page
+   at a time.  Returns the number of bytes sent.
+*/
+static uint16_t display_i2c_window(uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1)
+{
+  uint8_t page, x;
+
+  display_i2c_start(SSD1306_CONTROL_COMMAND);
+  display_i2c_write(SSD1306_SET_COLUMN_ADDR);
+  display_i2c_write(x0);
+  display_i2c_write(x1);
+  display_i2c_write(SSD1306_SET_PAGE_ADDR);
+  display_i2c_write(page0);
+  display_i2c_write(page1);
+  display_i2c_stop();
+
+  display_i2c_start(SSD1306_CONTROL_DATA);
+  for(page = page0; page <= page1; page++)
+  {
+    for(x = x0; x <= x1; x++)
+    {
+      display_i2c_write(display_buffer[page][x]);
+    }
+  }
+  display_i2c_stop();
+
+/* two address and control bytes for each of the two transfers */
+  return(4 + 6 + (uint16_t)(page1 - page0 + 1) * (x1 - x0 + 1));
+
+}/* end display_i2c_window() */
+
+/* display_i2c_update()
+
+   Take the dirty windows of all the pages.  Runs of dirty pages are sent as
+   one window covering all of them, as long as the clean bytes that brings in
+   cost less than setting up another window would.  A full frame goes in one
+   data transfer of 1024 bytes.
+*/
+uint16_t display_i2c_update(void)
+{
+  uint8_t x0[DISPLAY_PAGES], x1[DISPLAY_PAGES];
+  uint16_t bytes = 0, merged, separate;
+  uint8_t page, first, left, right;
+
+  for(page = 0; page < DISPLAY_PAGES; page++)
+  {
+    if(display_get_dirty(page, &x0[page], &x1[page]) == DISPLAY_CLEAN)
+    {
+      x0[page] = DISPLAY_WIDTH;
+      x1[page] = 0;
+    }
+  }
+
+  display_i2c_clock_begin();
+
+  page = 0;
+  while(page < DISPLAY_PAGES)
+  {
+    if(x0[page] > x1[page])
+    {
+      page++;
+      continue;
+    }
+
+  /* grow the window down over the following dirty pages while that's
+     cheaper */
+    first = page;
+    left = x0[page];
+    right = x1[page];
+    while((page + 1 < DISPLAY_PAGES) && (x0[page + 1] <= x1[page + 1]))
+    {
+      separate = (uint16_t)(page - first + 1) * (right - left + 1) +
+                 (x1[page + 1] - x0[page + 1] + 1) + DISPLAY_I2C_WINDOW_COST;
+      merged = (uint16_t)(page - first + 2) *
+               ((x1[page + 1] > right ? x1[page + 1] : right) -
+                (x0[page + 1] < left ? x0[page + 1] : left) + 1);
+      if(merged > separate)
+      {
+        break;
+      }
+
+      page++;
+      if(x0[page] < left)
+      {
+        left = x0[page];
+      }
+      if(x1[page] > right)
+      {
+        right = x1[page];
+      }
+    }
+
+    bytes += display_i2c_window(left, right, first, page);
+    page++;
+  }
+
+  display_i2c_clock_end();
+
+  return(bytes);
+
+}/* end display_i2c_update() */
@@ -0,0 +1,374 @@
+/*
+ * display_list.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Drawing without a frame buffer.  See display_list.h.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <stdlib.h>
+#include "display.h"
+#include "display_font.h"
+#include "display_list.h"
+
+/* item types */
+#define DISPLAY_LIST_RECT   0
+#define DISPLAY_LIST_LINE   1
+#define DISPLAY_LIST_TEXT   2
+#define DISPLAY_LIST_TEXT_P 3
+
+/* One thing to draw.  For text, (x0, y0) is the top left corner and x1 is
+   the size. */
+typedef struct
+{
+  uint8_t type;
+  uint8_t colour;
+  uint8_t x0, y0, x1, y1;
+  const char *str;
+} Display_ListItem;
+
+static Display_ListItem list[DISPLAY_LIST_MAX];
+static uint8_t listLength;
+
+/* one page of the display, drawn then sent */
+static uint8_t pageBuf[DISPLAY_WIDTH];
+
+/* display_list_add()
+
+   Fill in the next item, returns its position or DISPLAY_LIST_FULL.
+*/
+static uint8_t display_list_add(uint8_t type, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t colour, const char *str)
+{
+  Display_ListItem *item;
+
+  if(listLength == DISPLAY_LIST_MAX)
+  {
+    return(DISPLAY_LIST_FULL);
+  }
+
+  item = &list[listLength];
+  item->type = type;
+  item->colour = colour;
+  item->x0 = x0;
+  item->y0 = y0;
+  item->x1 = x1;
+  item->y1 = y1;
+  item->str = str;
+
+  return(listLength++);
+
+}/* end display_list_add() */
+
+/* display_list_write()
+
+   Replace the bits of buf[x] picked out by 'mask' with 'bits'.
+*/
+static inline void display_list_write(uint8_t *buf, uint8_t x, uint8_t mask, uint8_t bits)
+{
+  buf[x] = (buf[x] & ~mask) | (bits & mask);
+
+}/* end display_list_write() */
+
+/* display_list_render_rect()
+
+   Fill the columns of the rectangle with the rows of it on this page.
+*/
+static void display_list_render_rect(const Display_ListItem *item, uint8_t page, uint8_t *buf)
+{
+  uint8_t top = page * 8;
+  uint8_t mask = 0xff;
+  uint8_t x;
+
+  if((item->y0 > top + 7) || (item->y1 < top))
+  {
+    return;
+  }
+
+  if(item->y0 > top)
+  {
+    mask &= 0xff << (item->y0 - top);
+  }
+  if(item->y1 < top + 7)
+  {
+    mask &= 0xff >> (top + 7 - item->y1);
+  }
+
+  for(x = item->x0; (x <= item->x1) && (x < DISPLAY_WIDTH); x++)
+  {
+    display_list_write(buf, x, mask, (item->colour == DISPLAY_BLACK) ? 0 : 0xff);
+  }
+
+}/* end display_list_render_rect() */
+
+/* display_list_render_line()
+
+   Walk the whole line with Bresenham's algorithm, the same as
+   display_draw_line(), and keep the pixels on this page.
+*/
+static void display_list_render_line(const Display_ListItem *item, uint8_t page, uint8_t *buf)
+{
+  uint8_t x0 = item->x0, y0 = item->y0;
+  uint8_t x1 = item->x1, y1 = item->y1;
+  uint8_t top = page * 8;
+  int16_t dx = abs((int16_t)x1 - x0);
+  int16_t dy = -abs((int16_t)y1 - y0);
+  int8_t sx = (x0 < x1) ? 1 : -1;
+  int8_t sy = (y0 < y1) ? 1 : -1;
+  int16_t err = dx + dy;
+  int16_t err2;
+
+/* skip lines that miss the page */
+  if(((y0 < top) && (y1 < top)) || ((y0 > top + 7) && (y1 > top + 7)))
+  {
+    return;
+  }
+
+  while(1)
+  {
+    if(((y0 >> 3) == page) && (x0 < DISPLAY_WIDTH))
+    {
+      display_list_write(buf, x0, _BV(y0 & 7), (item->colour == DISPLAY_BLACK) ? 0 : 0xff);
+    }
+
+    if((x0 == x1) && (y0 == y1))
+    {
+      break;
+    }
+
+    err2 = err * 2;
+    if(err2 >= dy)
+    {
+      err += dy;
+      x0 += sx;
+    }
+    if(err2 <= dx)
+    {
+      err += dx;
+      y0 += sy;
+    }
+  }
+
+}/* end display_list_render_line() */
+
+/* display_list_render_text()
+
+   Draw the character cells that cross this page.  Each column of a cell is
+   built as one value 8 * size bits high, with every font pixel repeated
+   'size' times, then shifted to where the cell sits on the page.
+*/
+static void display_list_render_text(const Display_ListItem *item, uint8_t page, uint8_t *buf)
+{
+  const char *str = item->str;
+  uint8_t size = item->x1;
+  uint8_t height = DISPLAY_CELL_HEIGHT * size;
+  int16_t offset = (int16_t)item->y0 - page * 8;
+  uint32_t cellMask, column;
+  const uint8_t *glyph;
+  uint8_t x = item->x0;
+  uint8_t bits, mask, c, i, j, k;
+
+  if((offset >= 8) || (offset + height <= 0))
+  {
+    return;
+  }
+
+  cellMask = ((uint32_t)1 << height) - 1;
+
+  while(1)
+  {
+    c = (item->type == DISPLAY_LIST_TEXT_P) ? pgm_read_byte(str) : *str;
+    str++;
+    if(c == 0)
+    {
+      break;
+    }
+
+    glyph = display_font_glyph(c);
+
+    for(i = 0; i < DISPLAY_CELL_WIDTH; i++)
+    {
+    /* the last column of the cell is the gap between characters */
+      bits = (i < DISPLAY_FONT_WIDTH) ? pgm_read_byte(&glyph[i]) : 0;
+
+    /* stretch the column to the text size */
+      column = 0;
+      for(j = DISPLAY_CELL_HEIGHT; j-- > 0;)
+      {
+        for(k = 0; k < size; k++)
+        {
+          column = (column << 1) | ((bits >> j) & 1);
+        }
+      }
+
+      if(item->colour == DISPLAY_BLACK)
+      {
+        column = ~column & cellMask;
+      }
+
+    /* the 8 rows of the column on this page */
+      if(offset >= 0)
+      {
+        bits = (uint8_t)(column << offset);
+        mask = (uint8_t)(cellMask << offset);
+      }
+      else
+      {
+        bits = (uint8_t)(column >> -offset);
+        mask = (uint8_t)(cellMask >> -offset);
+      }
+
+      for(k = 0; k < size; k++)
+      {
+        if(x >= DISPLAY_WIDTH)
+        {
+          return;
+        }
+        display_list_write(buf, x++, mask, bits);
+      }
+    }
+  }
+
+}/* end display_list_render_text() */
+
+/* display_list_clear()
+
+   Empty the list.
+*/
+void display_list_clear(void)
+{
+  listLength = 0;
+
+}/* end display_list_clear() */
+
+/* display_list_add_rect()
+
+   Add a filled rectangle, corners in either order.
+*/
+uint8_t display_list_add_rect(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t colour)
+{
+  if(x0 > x1)
+  {
+    return(display_list_add_rect(x1, y0, x0, y1, colour));
+  }
+  if(y0 > y1)
+  {
+    return(display_list_add_rect(x0, y1, x1, y0, colour));
+  }
+
+  return(display_list_add(DISPLAY_LIST_RECT, x0, y0, x1, y1, colour, 0));
+
+}/* end display_list_add_rect() */
+
+/* display_list_add_line()
+
+   Add a line.
+*/
+uint8_t display_list_add_line(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t colour)
+{
+  return(display_list_add(DISPLAY_LIST_LINE, x0, y0, x1, y1, colour, 0));
+
+}/* end display_list_add_line() */
+
+/* display_list_add_text()
+
+   Add text from a string in RAM.
+*/
+uint8_t display_list_add_text(uint8_t x, uint8_t y, uint8_t size, uint8_t colour, const char *str)
+{
+  if(size > DISPLAY_LIST_MAX_TEXT_SIZE)
+  {
+    size = DISPLAY_LIST_MAX_TEXT_SIZE;
+  }
+
+  return(display_list_add(DISPLAY_LIST_TEXT, x, y, (size > 0) ? size : 1, 0, colour, str));
+
+}/* end display_list_add_text() */
+
+/* display_list_add_text_P()
+
+   Add text from a string in flash.
+*/
+uint8_t display_list_add_text_P(uint8_t x, uint8_t y, uint8_t size, uint8_t colour, const char *str)
+{
+  uint8_t index = display_list_add_text(x, y, size, colour, str);
+
+  if(index != DISPLAY_LIST_FULL)
+  {
+    list[index].type = DISPLAY_LIST_TEXT_P;
+  }
+
+  return(index);
+
+}/* end display_list_add_text_P() */
+
+/* display_list_render_page()
+
+   Clear the page, then draw every item on it.
+*/
+void display_list_render_page(uint8_t page, uint8_t *buf)
+{
+  const Display_ListItem *item;
+  uint8_t i;
+
+  for(i = 0; i < DISPLAY_WIDTH; i++)
+  {
+    buf[i] = 0;
+  }
+
+  for(i = 0; i < listLength; i++)
+  {
+    item = &list[i];
+    switch(item->type)
+    {
+      case DISPLAY_LIST_RECT:
+        display_list_render_rect(item, page, buf);
+        break;
+
+      case DISPLAY_LIST_LINE:
+        display_list_render_line(item, page, buf);
+        break;
+
+      default:
+        display_list_render_text(item, page, buf);
+        break;
+
+    }/* end switch(item->type) */
+  }
+
+}/* end display_list_render_page() */
+
+/* display_list_send(), display_list_send_over()
+
+   Draw and send the pages one at a time through the one page buffer,
+   letting 'drawOver' add to each page before it goes.
+*/
+void display_list_send(void (*writePage)(uint8_t page, const uint8_t *data))
+{
+  display_list_send_over(writePage, 0);
+
+}/* end display_list_send() */
+
+void display_list_send_over(void (*writePage)(uint8_t page, const uint8_t *data),
+                            void (*drawOver)(uint8_t page, uint8_t *buf))
+{
+  uint8_t page;
+
+  for(page = 0; page < DISPLAY_PAGES; page++)
+  {
+    display_list_render_page(page, pageBuf);
+    if(drawOver != 0)
+    {
+      drawOver(page, pageBuf);
+    }
+    writePage(page, pageBuf);
+  }
+
+}/* end display_list_send_over() */
@@ -0,0 +1,91 @@
+/*
+ * display_list.h
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Drawing without a frame buffer.  The frame buffer in display.h takes 1024
+ * bytes, half the RAM of an ATmega328.  Here the screen is described by a
+ * list of things to draw instead: filled rectangles, lines and text.  To
+ * update the display, each page is drawn from the list into a 128 byte buffer
+ * and sent, then the same buffer is used for the next page.
+ *
+ * Text items point at strings, so a program builds its list once and then
+ * only changes the strings.  Labels can be kept in flash with
+ * display_list_add_text_P().  With room for DISPLAY_LIST_MAX items of 8 bytes
+ * each, the list and the page buffer take 288 bytes.
+ *
+ * Every page is drawn and sent on every update, so an update costs more CPU
+ * time than display_spi_update() with only a few changes.  It is the RAM that
+ * is saved, not the time.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef DISPLAY_LIST_H_
+#define DISPLAY_LIST_H_
+
+#include <avr/io.h>
+
+/* the most items a list can hold */
+#define DISPLAY_LIST_MAX 20
+
+/* the largest text size, the column of a character cell must fit 32 bits */
+#define DISPLAY_LIST_MAX_TEXT_SIZE 3
+
+/* returned by display_list_add_*() when the list is full */
+#define DISPLAY_LIST_FULL 0xff
+
+/* display_list_clear()
+
+   Empty the list.
+*/
+void display_list_clear(void);
+
+/* display_list_add_rect(), display_list_add_line()
+
+   Add a filled rectangle or a line, corners and ends included, the same as
+   display_draw_filled_rectangle() and display_draw_line().  Returns the
+   position of the item in the list or DISPLAY_LIST_FULL.
+*/
+uint8_t display_list_add_rect(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t colour);
+uint8_t display_list_add_line(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t colour);
+
+/* display_list_add_text(), display_list_add_text_P()
+
+   Add text with its top left corner at (x, y), drawn the same way as
+   display_putStr().  The string stays where it is, in RAM or in flash, and
+   is read each time the list is drawn.  Returns the position of the item in
+   the list or DISPLAY_LIST_FULL.
+*/
+uint8_t display_list_add_text(uint8_t x, uint8_t y, uint8_t size, uint8_t colour, const char *str);
+uint8_t display_list_add_text_P(uint8_t x, uint8_t y, uint8_t size, uint8_t colour, const char *str);
+
+/* display_list_render_page()
+
+   Draw everything in the list that falls on 'page' into the 128 bytes at
+   'buf'.  Items later in the list are drawn over earlier ones.
+*/
+void display_list_render_page(uint8_t page, uint8_t *buf);
+
+/* display_list_send()
+
+   Draw each page and send it with 'writePage', either
+   display_spi_write_page() or display_i2c_write_page().
+*/
+void display_list_send(void (*writePage)(uint8_t page, const uint8_t *data));
+
+/* display_list_send_over()
+
+   The same, but after each page is drawn from the list 'drawOver' is called
+   with the page and the buffer to add what the list can't describe, such as
+   a plot, before the page is sent.  This way it uses the list's page buffer
+   instead of needing another 128 bytes of its own.
+*/
+void display_list_send_over(void (*writePage)(uint8_t page, const uint8_t *data),
+                            void (*drawOver)(uint8_t page, uint8_t *buf));
+
+#endif /* DISPLAY_LIST_H_ */
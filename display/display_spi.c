@@ -0,0 +1,201 @@
+/*
+ * display_spi.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * SPI (4-wire) transport for the SSD1306 display: setting it up and sending
+ * bytes and pages straight to it.  Sending the frame buffer is in
+ * display_spi_frame.c.  See display_spi.h.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include "spibus/spibus.h"
+#include "display.h"
+#include "display_spi.h"
+
+/* the chip select and data/command pins */
+static volatile uint8_t *displayCsPort;
+static uint8_t displayCsMask;
+static volatile uint8_t *displayDcPort;
+static uint8_t displayDcMask;
+
+/* set while display_spi_start() has an update running in the background */
+volatile uint8_t display_spi_streaming;
+
+/* display_spi_select(), display_spi_deselect()
+
+   Take the bus and pull CE low, then raise CE and give the bus back.  If the
+   accelerometer is in the middle of a transfer, wait for it to finish.
+*/
+void display_spi_select(void)
+{
+  while(spibus_acquire(SPIBUS_OWNER_DISPLAY) != SPIBUS_OK)
+  {
+  }
+  *displayCsPort &= ~displayCsMask;
+
+}/* end display_spi_select() */
+
+void display_spi_deselect(void)
+{
+  *displayCsPort |= displayCsMask;
+  spibus_release(SPIBUS_OWNER_DISPLAY);
+
+}/* end display_spi_deselect() */
+
+/* display_spi_command(), display_spi_data()
+
+   Set DC for the bytes that follow, low for commands, high for display data.
+*/
+void display_spi_command(void)
+{
+  *displayDcPort &= ~displayDcMask;
+
+}/* end display_spi_command() */
+
+void display_spi_data(void)
+{
+  *displayDcPort |= displayDcMask;
+
+}/* end display_spi_data() */
+
+/* display_spi_init()
+
+   Set up the pins and the bus, then send the set up commands.
+*/
+void display_spi_init(volatile uint8_t *csPort, uint8_t csPin, volatile uint8_t *dcPort, uint8_t dcPin)
+{
+  uint8_t i;
+
+  displayCsPort = csPort;
+  displayCsMask = _BV(csPin);
+  displayDcPort = dcPort;
+  displayDcMask = _BV(dcPin);
+
+/* CE high (deselected), then make both pins outputs.  The data direction
+   register sits one address below the port register. */
+  *displayCsPort |= displayCsMask;
+  *(displayCsPort - 1) |= displayCsMask;
+  *(displayDcPort - 1) |= displayDcMask;
+
+  spibus_register(SPIBUS_OWNER_DISPLAY, DISPLAY_SPI_SPCR, DISPLAY_SPI_SPSR);
+
+  display_spi_select();
+  display_spi_command();
+  for(i = 0; i < DISPLAY_SSD1306_INIT_LENGTH; i++)
+  {
+    spibus_transfer(pgm_read_byte(&display_ssd1306_init[i]));
+  }
+  display_spi_deselect();
+
+}/* end display_spi_init() */
+
+/* display_spi_flip_vertical()
+
+   Reverse both the column and the row scan direction.
+*/
+void display_spi_flip_vertical(void)
+{
+  display_spi_select();
+  display_spi_command();
+  spibus_transfer(SSD1306_SEG_REMAP_0);
+  spibus_transfer(SSD1306_COM_SCAN_INC);
+  display_spi_deselect();
+
+}/* end display_spi_flip_vertical() */
+
+/* display_spi_write_page()
+
+   Send a whole page from 'data'.
+*/
+void display_spi_write_page(uint8_t page, const uint8_t *data)
+{
+  uint8_t x;
+
+  while(display_spi_streaming)
+  {
+  }
+
+  display_spi_select();
+
+  display_spi_command();
+  spibus_transfer(SSD1306_SET_COLUMN_ADDR);
+  spibus_transfer(0);
+  spibus_transfer(DISPLAY_MAX_X);
+  spibus_transfer(SSD1306_SET_PAGE_ADDR);
+  spibus_transfer(page);
+  spibus_transfer(page);
+
+  display_spi_data();
+  for(x = 0; x < DISPLAY_WIDTH; x++)
+  {
+    spibus_transfer(*data++);
+  }
+
+  display_spi_deselect();
+
+}/* end display_spi_write_page() */
+
+/* display_spi_send()
+
+   Send bytes with DC already set.
+*/
+static void display_spi_send(const uint8_t *bytes, uint8_t length)
+{
+  while(length-- > 0)
+  {
+    spibus_transfer(*bytes++);
+  }
+
+  display_spi_deselect();
+
+}/* end display_spi_send() */
+
+/* display_spi_send_commands()
+
+   Send bytes as commands.
+*/
+void display_spi_send_commands(const uint8_t *commands, uint8_t length)
+{
+  while(display_spi_streaming)
+  {
+  }
+
+  display_spi_select();
+  display_spi_command();
+  display_spi_send(commands, length);
+
+}/* end display_spi_send_commands() */
+
+/* display_spi_send_data()
+
+   Send bytes as display data.
+*/
+void display_spi_send_data(const uint8_t *data, uint8_t length)
+{
+  while(display_spi_streaming)
+  {
+  }
+
+  display_spi_select();
+  display_spi_data();
+  display_spi_send(data, length);
+
+}/* end display_spi_send_data() */
+
+/* display_spi_busy()
+
+   Returns 1 while a background update is running.
+*/
+uint8_t display_spi_busy(void)
+{
+  return(display_spi_streaming);
+
+}/* end display_spi_busy() */
@@ -0,0 +1,113 @@
+/*
+ * display_spi.h
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * SPI (4-wire) transport for the SSD1306 display.  Sends the dirty windows of
+ * the frame buffer in display.h.
+ *
+ * The display shares the SPI bus through spibus.h.  The SPI pins (SCK, MOSI
+ * and the SS pin as an output) must already be set up, spi_init() does that.
+ *
+ * There are two ways to send an update:
+ *
+ *    display_spi_update() - sends everything before returning, at F_CPU/2
+ *    display_spi_start()  - returns at once, the SPI interrupt sends the
+ *                           dirty pages one byte at a time
+ *
+ * At F_CPU/2 a byte goes in 16 CPU cycles, less time than it takes to get in
+ * and out of an interrupt, so the background update runs the bus at F_CPU/16
+ * instead.  The interrupt takes about 60 of every 128 cycles and the rest are
+ * left for the main loop.  A full frame takes about 8.5ms that way, a few
+ * changed digits well under 1ms.
+ *
+ * The display holds the bus until the update is finished, so other devices
+ * on the SPI bus wait for it.  Devices on other buses (the I2C sensors) can be
+ * used while it runs.
+ *
+ * display_spi_update() and display_spi_start() are in display_spi_frame.c,
+ * the rest in display_spi.c, with the set up commands in display_ssd1306.c.
+ * A program that only uses display_spi_write_page() or the send functions,
+ * with display_list.h or display_chart.h, links display_spi.c and
+ * display_ssd1306.c and leaves out the frame buffer.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef DISPLAY_SPI_H_
+#define DISPLAY_SPI_H_
+
+#include <avr/io.h>
+
+/* SPI mode 3, MSB first, F_CPU/2 = 8MHz */
+#define DISPLAY_SPI_SPCR (_BV(SPE) | _BV(MSTR) | _BV(CPOL) | _BV(CPHA))
+#define DISPLAY_SPI_SPSR _BV(SPI2X)
+
+/* display_spi_init()
+
+   Set up the chip select (CE) and data/command (DC) pins, register the SPI
+   settings (mode 3, F_CPU/2) with spibus and send the SSD1306 set up
+   commands.
+*/
+void display_spi_init(volatile uint8_t *csPort, uint8_t csPin, volatile uint8_t *dcPort, uint8_t dcPin);
+
+/* display_spi_flip_vertical()
+
+   Turn the picture upside down, for displays mounted the other way up.
+*/
+void display_spi_flip_vertical(void);
+
+/* display_spi_update()
+
+   Send every dirty window to the display.  Holds the SPI bus for the whole
+   update.  Returns the number of bytes sent, commands included.
+*/
+uint16_t display_spi_update(void);
+
+/* display_spi_start()
+
+   Start sending every dirty window in the background, after waiting for any
+   update already running to finish.  Returns the number of bytes that will
+   be sent, commands included.  Interrupts must be enabled.
+*/
+uint16_t display_spi_start(void);
+
+/* display_spi_busy()
+
+   Returns 1 while a background update is running, 0 once it has finished.
+*/
+uint8_t display_spi_busy(void);
+
+/* display_spi_write_page()
+
+   Send 128 bytes from 'data' straight to one page of the display, without
+   using the frame buffer.  For display_list.h.
+*/
+void display_spi_write_page(uint8_t page, const uint8_t *data);
+
+/* display_spi_send_commands(), display_spi_send_data()
+
+   Send 'length' bytes straight to the display as commands or as display
+   data, without using the frame buffer.  For display_chart.h.
+*/
+void display_spi_send_commands(const uint8_t *commands, uint8_t length);
+void display_spi_send_data(const uint8_t *data, uint8_t length);
+
+/* display_spi_select(), display_spi_deselect(), display_spi_command(),
+   display_spi_data(), display_spi_streaming
+
+   Used by display_spi_frame.c.  Take and give back the bus with CE, set DC
+   for commands or display data, and the flag that is set while a background
+   update runs.
+*/
+void display_spi_select(void);
+void display_spi_deselect(void);
+void display_spi_command(void);
+void display_spi_data(void);
+extern volatile uint8_t display_spi_streaming;
+
+#endif /* DISPLAY_SPI_H_ */
@@ -0,0 +1,199 @@
+/*
+ * display_spi_frame.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Sending the frame buffer in display.h over the SPI transport, all at once
+ * or in the background from the SPI interrupt.  See display_spi.h.  It is
+ * apart from display_spi.c so that a program that only sends pages or bytes
+ * of its own doesn't link the frame buffer.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "spibus/spibus.h"
+#include "display.h"
+#include "display_spi.h"
+
+/* DISPLAY_SPI_SPCR at F_CPU/16 = 1MHz with the interrupt on, for
+   display_spi_start() */
+#define DISPLAY_SPI_SPCR_BACKGROUND (DISPLAY_SPI_SPCR | _BV(SPIE) | _BV(SPR0))
+#define DISPLAY_SPI_SPSR_BACKGROUND 0
+
+/* The background update.  The dirty windows of all the pages are taken when
+   it starts, a clean page has its start past its end.  The interrupt sends
+   'streamCount' bytes from 'streamPtr', then moves on to the next part. */
+static uint8_t streamX0[DISPLAY_PAGES];
+static uint8_t streamX1[DISPLAY_PAGES];
+static uint8_t streamCommand[6];
+static const uint8_t *streamPtr;
+static uint8_t streamCount;
+static uint8_t streamPage;
+static uint8_t streamSendingData;
+
+/* display_spi_update()
+
+   For each dirty page, set the column and page window with six command bytes
+   then send the bytes inside it.
+*/
+uint16_t display_spi_update(void)
+{
+  uint16_t bytes = 0;
+  uint8_t page, x0, x1, x;
+
+  while(display_spi_streaming)
+  {
+  }
+
+  display_spi_select();
+
+  for(page = 0; page < DISPLAY_PAGES; page++)
+  {
+    if(display_get_dirty(page, &x0, &x1) == DISPLAY_CLEAN)
+    {
+      continue;
+    }
+
+    display_spi_command();
+    spibus_transfer(SSD1306_SET_COLUMN_ADDR);
+    spibus_transfer(x0);
+    spibus_transfer(x1);
+    spibus_transfer(SSD1306_SET_PAGE_ADDR);
+    spibus_transfer(page);
+    spibus_transfer(page);
+
+    display_spi_data();
+    for(x = x0; x <= x1; x++)
+    {
+      spibus_transfer(display_buffer[page][x]);
+    }
+
+    bytes += 6 + (x1 - x0) + 1;
+  }
+
+  display_spi_deselect();
+
+  return(bytes);
+
+}/* end display_spi_update() */
+
+/* display_spi_next_page()
+
+   Find the next page with something to send, set the window and send its
+   first command byte.  If there are no more, end the update and give the bus
+   back.  Called with the SPI interrupt disabled or from inside it.
+*/
+static void display_spi_next_page(void)
+{
+  while((streamPage < DISPLAY_PAGES) && (streamX0[streamPage] > streamX1[streamPage]))
+  {
+    streamPage++;
+  }
+
+  if(streamPage == DISPLAY_PAGES)
+  {
+    SPCR = DISPLAY_SPI_SPCR;
+    SPSR = DISPLAY_SPI_SPSR;
+    display_spi_deselect();
+    display_spi_streaming = 0;
+    return;
+  }
+
+  streamCommand[0] = SSD1306_SET_COLUMN_ADDR;
+  streamCommand[1] = streamX0[streamPage];
+  streamCommand[2] = streamX1[streamPage];
+  streamCommand[3] = SSD1306_SET_PAGE_ADDR;
+  streamCommand[4] = streamPage;
+  streamCommand[5] = streamPage;
+
+  display_spi_command();
+  streamSendingData = 0;
+  streamPtr = &streamCommand[1];
+  streamCount = 5;
+  SPDR = streamCommand[0];
+
+}/* end display_spi_next_page() */
+
+/* display_spi_start()
+
+   Take the dirty windows and lock their pages, then send the first byte.  The
+   interrupt does the rest.
+*/
+uint16_t display_spi_start(void)
+{
+  uint16_t bytes = 0;
+  uint8_t lock = 0;
+  uint8_t page;
+
+  while(display_spi_streaming)
+  {
+  }
+
+  for(page = 0; page < DISPLAY_PAGES; page++)
+  {
+    if(display_get_dirty(page, &streamX0[page], &streamX1[page]) == DISPLAY_DIRTY)
+    {
+      lock |= 1 << page;
+      bytes += 6 + (streamX1[page] - streamX0[page]) + 1;
+    }
+    else
+    {
+      streamX0[page] = DISPLAY_WIDTH;
+      streamX1[page] = 0;
+    }
+  }
+
+  if(lock == 0)
+  {
+    return(0);
+  }
+
+  display_lock_pages(lock);
+  streamPage = 0;
+  display_spi_streaming = 1;
+
+  display_spi_select();
+  SPSR = DISPLAY_SPI_SPSR_BACKGROUND;
+  SPCR = DISPLAY_SPI_SPCR_BACKGROUND & ~_BV(SPIE);
+  display_spi_next_page();
+  SPCR = DISPLAY_SPI_SPCR_BACKGROUND;
+
+  return(bytes);
+
+}/* end display_spi_start() */
+
+/* SPI transfer complete interrupt.  Send the next byte of the commands or
+   the data.  After the commands switch DC to data and send the window, after
+   the window unlock the page and go on to the next one.  DC is only changed
+   here, once the last byte has been clocked out completely.
+*/
+ISR(SPI_STC_vect)
+{
+  if(streamCount > 0)
+  {
+    streamCount--;
+    SPDR = *streamPtr++;
+    return;
+  }
+
+  if(streamSendingData == 0)
+  {
+    display_spi_data();
+    streamSendingData = 1;
+    streamPtr = &display_buffer[streamPage][streamX0[streamPage]];
+    streamCount = streamX1[streamPage] - streamX0[streamPage];
+    SPDR = *streamPtr++;
+    return;
+  }
+
+  display_unlock_page(streamPage);
+  streamPage++;
+  display_spi_next_page();
+
+}/* end ISR(SPI_STC_vect) */
@@ -0,0 +1,40 @@
+/*
+ * display_ssd1306.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * The SSD1306 set up commands the transports send, see display.h.  They are
+ * kept out of display.c so a program that draws with display_list.h or
+ * display_chart.h, and has no frame buffer, doesn't link display.c and its
+ * 1024 byte buffer just to start the display.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include "display.h"
+
+const uint8_t display_ssd1306_init[DISPLAY_SSD1306_INIT_LENGTH] PROGMEM =
+{
+  0xae,       /* display off */
+  0xd5, 0x80, /* clock divide, default */
+  0xa8, 0x3f, /* multiplex ratio, 64 lines */
+  0xd3, 0x00, /* display offset 0 */
+  0x40,       /* start line 0 */
+  0x8d, 0x14, /* charge pump on */
+  0x20, 0x00, /* horizontal addressing mode */
+  SSD1306_SEG_REMAP_127,
+  SSD1306_COM_SCAN_DEC,
+  0xda, 0x12, /* COM pins, alternative */
+  0x81, 0xcf, /* contrast */
+  0xd9, 0xf1, /* precharge period */
+  0xdb, 0x40, /* VCOMH deselect level */
+  0xa4,       /* show the display RAM */
+  0xa6,       /* normal, not inverted */
+  0xaf        /* display on */
+};
@@ -0,0 +1,104 @@
+/*
+ * fmt-bench.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Compares the fmt module (fmt/fmt.h) with the library itoa() function.  Each
+ * test value is converted both ways, in hex and in decimal, and the cycles
+ * each conversion took are sent out the serial port at 115200 baud.  Timer 1
+ * runs at the CPU clock, so its count is the number of cycles.
+ *
+ * The flash used by each can be compared by building this program, then
+ * taking out the calls to one or the other and looking at the difference
+ * reported by avr-size.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <stdlib.h>/* for itoa() */
+#include "uart/uart.h"
+#include "fmt/fmt.h"
+
+/* Function prototypes */
+void print_cycles(const char *label, uint16_t cycles);
+
+/* the values to convert, from short to as long as they get */
+static const int16_t TEST_VALUES[] PROGMEM =
+{
+  0, 7, -42, 999, -1234, 32767, -32768
+};
+
+#define TEST_COUNT (sizeof(TEST_VALUES) / sizeof(TEST_VALUES[0]))
+
+/* Start of code */
+int main(void)
+{
+  char tempStr[10];
+  uint16_t startCount, cycles;
+  int16_t value;
+  uint8_t i;
+
+/* initialize the UART so we can see the results */
+  uart_init(115200, USART_CHAR_SZ_EIGHT, USART_PARITY_NONE, USART_STOP_BIT_ONE);
+
+/* Timer 1 counts CPU cycles, no interrupts */
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);
+
+  for(i = 0; i < TEST_COUNT; i++)
+  {
+    value = pgm_read_word(&TEST_VALUES[i]);
+
+    uart_putstr("value ");
+    uart_putstr(fmt_dec16(value, 0, tempStr));
+    uart_putstr("\r\n");
+
+  /* hex */
+    startCount = TCNT1;
+    itoa(value, tempStr, 16);
+    cycles = TCNT1 - startCount;
+    print_cycles("  itoa(16):   ", cycles);
+
+    startCount = TCNT1;
+    fmt_hex16(value, tempStr);
+    cycles = TCNT1 - startCount;
+    print_cycles("  fmt_hex16:  ", cycles);
+
+  /* decimal */
+    startCount = TCNT1;
+    itoa(value, tempStr, 10);
+    cycles = TCNT1 - startCount;
+    print_cycles("  itoa(10):   ", cycles);
+
+    startCount = TCNT1;
+    fmt_dec16(value, 6, tempStr);
+    cycles = TCNT1 - startCount;
+    print_cycles("  fmt_dec16:  ", cycles);
+  }
+
+/* wait here forever */
+  while(1)
+  {
+  }/* end while() */
+
+}/* end main() */
+
+/* print_cycles()
+ *
+ * Send a label and a cycle count to the serial port.
+ */
+void print_cycles(const char *label, uint16_t cycles)
+{
+  char str[6];
+
+  uart_putstr(label);
+  uart_putstr(fmt_udec16(cycles, 5, str));
+  uart_putstr(" cycles\r\n");
+
+}/* end print_cycles() */
@@ -0,0 +1,202 @@
+/*
+ * fmt.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Fast integer to string conversion.  See fmt.h.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include "fmt.h"
+
+/* the character for each nibble */
+static const char FMT_HEX_DIGITS[16] PROGMEM =
+{
+  '0', '1', '2', '3', '4', '5', '6', '7',
+  '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'
+};
+
+/* fmt_digits()
+
+   Put the decimal digits of 'value' in 'digits', lowest first, at least
+   'least' of them (with leading zeros).  Returns how many.
+*/
+static uint8_t fmt_digits(uint16_t value, uint8_t least, char *digits)
+{
+  uint16_t quotient;
+  uint8_t count = 0;
+
+  do
+  {
+    quotient = ((uint32_t)value * 52429) >> 19;/* value / 10 */
+    digits[count++] = '0' + (uint8_t)(value - quotient * 10);
+    value = quotient;
+  }
+  while((value != 0) || (count < least));
+
+  return(count);
+
+}/* end fmt_digits() */
+
+/* fmt_field()
+
+   Copy 'count' digits, collected lowest first, into a field 'width' wide,
+   with a minus sign if 'negative'.
+*/
+static char *fmt_field(const char *digits, uint8_t count, uint8_t negative, uint8_t width, char *str)
+{
+  char *p = str;
+  uint8_t length;
+
+  length = count + negative;
+  if(width == 0)
+  {
+    width = length;
+  }
+
+  if(length > width)
+  {
+    while(width-- > 0)
+    {
+      *p++ = '*';
+    }
+  }
+  else
+  {
+    while(width-- > length)
+    {
+      *p++ = ' ';
+    }
+    if(negative)
+    {
+      *p++ = '-';
+    }
+    while(count > 0)
+    {
+      *p++ = digits[--count];
+    }
+  }
+
+  *p = 0;
+
+  return(str);
+
+}/* end fmt_field() */
+
+/* fmt_dec()
+
+   The decimal conversion for fmt_udec16() and fmt_dec16().
+*/
+static char *fmt_dec(uint16_t value, uint8_t negative, uint8_t width, char *str)
+{
+  char digits[5];
+
+  return(fmt_field(digits, fmt_digits(value, 1, digits), negative, width, str));
+
+}/* end fmt_dec() */
+
+/* fmt_hex8()
+
+   Two hex digits.
+*/
+char *fmt_hex8(uint8_t value, char *str)
+{
+  str[0] = pgm_read_byte(&FMT_HEX_DIGITS[value >> 4]);
+  str[1] = pgm_read_byte(&FMT_HEX_DIGITS[value & 0x0f]);
+  str[2] = 0;
+
+  return(str);
+
+}/* end fmt_hex8() */
+
+/* fmt_hex16()
+
+   Four hex digits, high byte first.
+*/
+char *fmt_hex16(uint16_t value, char *str)
+{
+  fmt_hex8(value >> 8, str);
+  fmt_hex8(value & 0xff, str + 2);
+
+  return(str);
+
+}/* end fmt_hex16() */
+
+/* fmt_udec16()
+
+   Unsigned decimal in a fixed width field.
+*/
+char *fmt_udec16(uint16_t value, uint8_t width, char *str)
+{
+  return(fmt_dec(value, 0, width, str));
+
+}/* end fmt_udec16() */
+
+/* fmt_dec16()
+
+   Signed decimal in a fixed width field.  The magnitude is worked out as
+   unsigned, so -32768 comes out right.
+*/
+char *fmt_dec16(int16_t value, uint8_t width, char *str)
+{
+  if(value < 0)
+  {
+    return(fmt_dec(-(uint16_t)value, 1, width, str));
+  }
+
+  return(fmt_dec(value, 0, width, str));
+
+}/* end fmt_dec16() */
+
+/* fmt_udec32()
+
+   Unsigned 32-bit decimal in a fixed width field.  The number is split into
+   groups of four digits with one 32-bit division each, and each group is
+   converted like a 16-bit number.  Numbers that fit 16 bits go straight
+   through.
+*/
+char *fmt_udec32(uint32_t value, uint8_t width, char *str)
+{
+  char digits[10];
+  uint32_t high;
+  uint8_t count = 0;
+
+  while(value > 65535)
+  {
+    high = value / 10000;
+    count += fmt_digits((uint16_t)(value - high * 10000), 4, digits + count);
+    value = high;
+  }
+  count += fmt_digits((uint16_t)value, 1, digits + count);
+
+  return(fmt_field(digits, count, 0, width, str));
+
+}/* end fmt_udec32() */
+
+/* fmt_scale()
+
+   (raw * scale) / 4096, rounded and clipped.
+*/
+int16_t fmt_scale(int16_t raw, int16_t scale)
+{
+  int32_t result = ((int32_t)raw * scale + 2048) >> 12;
+
+  if(result > 32767)
+  {
+    result = 32767;
+  }
+  else if(result < -32767)
+  {
+    result = -32767;
+  }
+
+  return((int16_t)result);
+
+}/* end fmt_scale() */
@@ -0,0 +1,86 @@
+/*
+ * fmt.h
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Fast integer to string conversion, in place of itoa(), utoa() and ltoa().
+ *
+ * The library functions work for any radix, so they divide by the radix for
+ * every digit, and the AVR has no divide instruction: each digit costs a call
+ * to the 16-bit division routine, about 200 cycles.  They also give strings
+ * of different lengths, so a number that gets shorter on a display leaves its
+ * old digits behind.
+ *
+ * Here hex digits come straight out of a 16 entry table, one nibble at a
+ * time, with no arithmetic at all.  Decimal digits use a multiply by the
+ * reciprocal of 10 instead of a division: x / 10 is (x * 52429) >> 19 for
+ * every 16-bit x, and the AVR multiplies in hardware.  Decimal numbers can be
+ * right justified in a fixed width field, with the minus sign next to the
+ * digits.
+ *
+ * Roughly, for 16-bit values (fmt-bench.c measures them on the target):
+ *
+ *                      itoa()           fmt
+ *    hex, 4 digits     ~900 cycles      ~50 cycles
+ *    decimal, 5 digits ~1,100 cycles    ~300 cycles
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef FMT_H_
+#define FMT_H_
+
+#include <avr/io.h>
+
+/* FMT_SCALE()
+
+   A scale for fmt_scale(), 'unitsPerCount' physical units for each count from
+   the sensor.  Up to 7.99, with a resolution of 1/4096.
+*/
+#define FMT_SCALE(unitsPerCount) ((int16_t)((unitsPerCount) * 4096.0 + 0.5))
+
+/* scales for the sensors on the 9 degrees of freedom sensor stick */
+#define FMT_SCALE_ADXL345_MG  FMT_SCALE(3.9)          /* mg, full resolution */
+#define FMT_SCALE_ITG3205_DPS FMT_SCALE(1.0 / 14.375) /* degrees per second */
+#define FMT_SCALE_HMC5883_MGA FMT_SCALE(0.92)         /* milligauss, 1.3Ga gain */
+
+/* fmt_hex8(), fmt_hex16()
+
+   Write 'value' as 2 or 4 lower case hex digits, leading zeros included, and
+   a terminating null.  'str' must hold 3 or 5 characters.  Returns 'str'.
+*/
+char *fmt_hex8(uint8_t value, char *str);
+char *fmt_hex16(uint16_t value, char *str);
+
+/* fmt_udec16(), fmt_dec16()
+
+   Write 'value' in decimal, right justified in a field 'width' characters
+   wide, and a terminating null.  A width of 0 makes the field just wide
+   enough.  If the number doesn't fit the field is filled with '*'.  'str'
+   must hold width + 1 characters (7 for a width of 0).  Returns 'str'.
+*/
+char *fmt_udec16(uint16_t value, uint8_t width, char *str);
+char *fmt_dec16(int16_t value, uint8_t width, char *str);
+
+/* fmt_udec32()
+
+   The same for an unsigned 32-bit value, for counts and cycle totals.  Each
+   group of four digits above the lowest costs a 32-bit division, so it is
+   slower than fmt_udec16() for big numbers.  'str' must hold width + 1
+   characters (11 for a width of 0).
+*/
+char *fmt_udec32(uint32_t value, uint8_t width, char *str);
+
+/* fmt_scale()
+
+   Convert a sensor reading to physical units, (raw * scale) / 4096 rounded,
+   with 'scale' from FMT_SCALE().  The result is clipped to +/-32767.  One
+   16x16 multiply and a shift.
+*/
+int16_t fmt_scale(int16_t raw, int16_t scale);
+
+#endif /* FMT_H_ */
@@ -0,0 +1,361 @@
+/*
+ * fusion.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Fixed-point attitude estimation (sensor fusion).  See fusion.h.
+ *
+ * This follows Mahony's AHRS update (as published in Madgwick's reference
+ * code) step for step, with the floating point replaced by Q15 and Q30
+ * integers.  The variable names match that code so the two can be compared.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include "cordic/cordic.h"
+#include "fusion.h"
+
+/* 1.0 and 0.5 in Q30 and Q15 */
+#define Q30_ONE  1073741824L
+#define Q15_HALF 16384
+
+/* sensor vectors shorter than this (in raw counts) are ignored */
+#define FUSION_MIN_NORM 16
+
+/* the quaternion, Q30 */
+static int32_t q0 = Q30_ONE, q1, q2, q3;
+
+/* integral feedback, Q30 half-radians per update */
+static int32_t integralFBx, integralFBy, integralFBz;
+
+/* gains and gyro scale from fusion_init() */
+static int16_t fusionGyroScale;
+static uint8_t fusionKpShift, fusionKiShift;
+
+/* fusion_mul()
+
+   Multiply a Q30 number by a Q15 number, giving a Q30 result.  'a' is split
+   in half so that only 16x16 bit multiplies are needed.
+*/
+static int32_t fusion_mul(int32_t a, int16_t b)
+{
+  int16_t aHigh = (int16_t)(a >> 16);
+  uint16_t aLow = (uint16_t)a;
+
+  return(((int32_t)aHigh * b * 2) + (((int32_t)aLow * b) >> 15));
+
+}/* end fusion_mul() */
+
+/* fusion_mul15()
+
+   Multiply two Q15 numbers, giving a Q15 result.
+*/
+static int16_t fusion_mul15(int16_t a, int16_t b)
+{
+  return((int16_t)(((int32_t)a * b) >> 15));
+
+}/* end fusion_mul15() */
+
+/* fusion_sat15()
+
+   Shift a Q30 number down to Q15, rounding, and clip it to fit an int16_t.
+*/
+static int16_t fusion_sat15(int32_t a)
+{
+  a = (a + 16384) >> 15;
+
+  if(a > 32767)
+  {
+    a = 32767;
+  }
+  else if(a < -32767)
+  {
+    a = -32767;
+  }
+
+  return((int16_t)a);
+
+}/* end fusion_sat15() */
+
+/* fusion_mag15()
+
+   Shift the magnitude of a Q30 number down to Q15, rounding.  Unlike
+   fusion_sat15() this doesn't clip, 1.0 comes out as 32768.
+*/
+static uint16_t fusion_mag15(int32_t a)
+{
+  if(a < 0)
+  {
+    a = -a;
+  }
+
+  return((uint16_t)((a + 16384) >> 15));
+
+}/* end fusion_mag15() */
+
+/* fusion_sqrt()
+
+   Integer square root, bit by bit.  Returns floor(sqrt(n)).
+*/
+static uint16_t fusion_sqrt(uint32_t n)
+{
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+
+  while(bit > n)
+  {
+    bit >>= 2;
+  }
+
+  while(bit != 0)
+  {
+    if(n >= root + bit)
+    {
+      n -= root + bit;
+      root = (root >> 1) + bit;
+    }
+    else
+    {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+
+  return((uint16_t)root);
+
+}/* end fusion_sqrt() */
+
+/* fusion_normalise()
+
+   Scale the raw vector 'v' to unit length in Q15, result in 'n'.  Returns 0
+   if the vector is too short to give a direction.  One division is shared by
+   the three axes.
+*/
+static uint8_t fusion_normalise(const int16_t *v, int16_t *n)
+{
+  uint32_t sum;
+  uint16_t norm;
+  int32_t recip, t;
+  uint8_t i;
+
+  sum = (uint32_t)((int32_t)v[0] * v[0]);
+  sum += (uint32_t)((int32_t)v[1] * v[1]);
+  sum += (uint32_t)((int32_t)v[2] * v[2]);
+  norm = fusion_sqrt(sum);
+
+  if(norm < FUSION_MIN_NORM)
+  {
+    return(0);
+  }
+
+/* recip is 1/norm in Q30, v[i] * recip can't overflow since |v[i]| <= norm */
+  recip = (int32_t)(Q30_ONE / norm);
+
+  for(i = 0; i < 3; i++)
+  {
+    t = (v[i] * recip) >> 15;
+    if(t > 32767)
+    {
+      t = 32767;
+    }
+    else if(t < -32767)
+    {
+      t = -32767;
+    }
+    n[i] = (int16_t)t;
+  }
+
+  return(1);
+
+}/* end fusion_normalise() */
+
+/* fusion_init()
+
+   Reset the attitude to level, pointing north, and set the gains.
+*/
+void fusion_init(int16_t gyroScale, uint8_t kpShift, uint8_t kiShift)
+{
+  q0 = Q30_ONE;
+  q1 = q2 = q3 = 0;
+  integralFBx = integralFBy = integralFBz = 0;
+
+  fusionGyroScale = gyroScale;
+  fusionKpShift = kpShift;
+  fusionKiShift = kiShift;
+
+}/* end fusion_init() */
+
+/* fusion_update()
+
+   Advance the attitude estimate by one update period.
+*/
+void fusion_update(const int16_t *gyro, const int16_t *accel, const int16_t *mag)
+{
+  int16_t a[3], m[3];
+  int16_t qa, qb, qc, qd;
+  int16_t q0q0, q0q1, q0q2, q0q3, q1q1, q1q2, q1q3, q2q2, q2q3, q3q3;
+  int16_t hx, hy, bx, bz;
+  int16_t halfvx, halfvy, halfvz, halfwx, halfwy, halfwz;
+  int32_t halfex, halfey, halfez;
+  int32_t gx, gy, gz;
+  uint16_t n0, n1, n2, n3;
+  int16_t normError;
+  uint8_t haveMag;
+
+/* gyro rate converted to the rotation this update, Q30 half-radians */
+  gx = (int32_t)gyro[0] * fusionGyroScale;
+  gy = (int32_t)gyro[1] * fusionGyroScale;
+  gz = (int32_t)gyro[2] * fusionGyroScale;
+
+/* Q15 copies of the quaternion for the multiplies */
+  qa = fusion_sat15(q0);
+  qb = fusion_sat15(q1);
+  qc = fusion_sat15(q2);
+  qd = fusion_sat15(q3);
+
+/* The feedback only happens if there is a usable accelerometer reading,
+   otherwise the gyro runs on its own. */
+  if(fusion_normalise(accel, a))
+  {
+    q0q0 = fusion_mul15(qa, qa);
+    q0q1 = fusion_mul15(qa, qb);
+    q0q2 = fusion_mul15(qa, qc);
+    q0q3 = fusion_mul15(qa, qd);
+    q1q1 = fusion_mul15(qb, qb);
+    q1q2 = fusion_mul15(qb, qc);
+    q1q3 = fusion_mul15(qb, qd);
+    q2q2 = fusion_mul15(qc, qc);
+    q2q3 = fusion_mul15(qc, qd);
+    q3q3 = fusion_mul15(qd, qd);
+
+  /* estimated direction of gravity, half length */
+    halfvx = q1q3 - q0q2;
+    halfvy = q0q1 + q2q3;
+    halfvz = q0q0 - Q15_HALF + q3q3;
+
+  /* error is the cross product between measured and estimated gravity */
+    halfex = (int32_t)a[1] * halfvz - (int32_t)a[2] * halfvy;
+    halfey = (int32_t)a[2] * halfvx - (int32_t)a[0] * halfvz;
+    halfez = (int32_t)a[0] * halfvy - (int32_t)a[1] * halfvx;
+
+    haveMag = 0;
+    if(mag != 0)
+    {
+      haveMag = fusion_normalise(mag, m);
+    }
+
+    if(haveMag)
+    {
+    /* reference direction of the earth's field, rotated to the earth frame,
+       with the east component removed */
+      hx = fusion_sat15(((int32_t)m[0] * (Q15_HALF - q2q2 - q3q3)
+                       + (int32_t)m[1] * (q1q2 - q0q3)
+                       + (int32_t)m[2] * (q1q3 + q0q2)) * 2);
+      hy = fusion_sat15(((int32_t)m[0] * (q1q2 + q0q3)
+                       + (int32_t)m[1] * (Q15_HALF - q1q1 - q3q3)
+                       + (int32_t)m[2] * (q2q3 - q0q1)) * 2);
+      bx = (int16_t)fusion_sqrt((uint32_t)((int32_t)hx * hx) + (uint32_t)((int32_t)hy * hy));
+      if(bx < 0)/* sqrt of exactly 1.0 comes out as 32768 */
+      {
+        bx = 32767;
+      }
+      bz = fusion_sat15(((int32_t)m[0] * (q1q3 - q0q2)
+                       + (int32_t)m[1] * (q2q3 + q0q1)
+                       + (int32_t)m[2] * (Q15_HALF - q1q1 - q2q2)) * 2);
+
+    /* estimated direction of the field, half length */
+      halfwx = fusion_sat15((int32_t)bx * (Q15_HALF - q2q2 - q3q3) + (int32_t)bz * (q1q3 - q0q2));
+      halfwy = fusion_sat15((int32_t)bx * (q1q2 - q0q3) + (int32_t)bz * (q0q1 + q2q3));
+      halfwz = fusion_sat15((int32_t)bx * (q0q2 + q1q3) + (int32_t)bz * (Q15_HALF - q1q1 - q2q2));
+
+    /* add the cross product between measured and estimated field */
+      halfex += (int32_t)m[1] * halfwz - (int32_t)m[2] * halfwy;
+      halfey += (int32_t)m[2] * halfwx - (int32_t)m[0] * halfwz;
+      halfez += (int32_t)m[0] * halfwy - (int32_t)m[1] * halfwx;
+    }
+
+  /* integral feedback */
+    if(fusionKiShift != FUSION_KI_OFF)
+    {
+      integralFBx += halfex >> fusionKiShift;
+      integralFBy += halfey >> fusionKiShift;
+      integralFBz += halfez >> fusionKiShift;
+      gx += integralFBx;
+      gy += integralFBy;
+      gz += integralFBz;
+    }
+
+  /* proportional feedback */
+    gx += halfex >> fusionKpShift;
+    gy += halfey >> fusionKpShift;
+    gz += halfez >> fusionKpShift;
+
+  }/* end if(fusion_normalise(accel, a)) */
+
+/* integrate the rate of change of the quaternion */
+  q0 += -fusion_mul(gx, qb) - fusion_mul(gy, qc) - fusion_mul(gz, qd);
+  q1 += fusion_mul(gx, qa) + fusion_mul(gz, qc) - fusion_mul(gy, qd);
+  q2 += fusion_mul(gy, qa) - fusion_mul(gz, qb) + fusion_mul(gx, qd);
+  q3 += fusion_mul(gz, qa) + fusion_mul(gy, qb) - fusion_mul(gx, qc);
+
+/* Renormalise.  The quaternion is always very close to unit length, so
+   q = q * (3 - |q|^2) / 2 is all that is needed, no square root. */
+  n0 = fusion_mag15(q0);
+  n1 = fusion_mag15(q1);
+  n2 = fusion_mag15(q2);
+  n3 = fusion_mag15(q3);
+  normError = (int16_t)((int32_t)((uint32_t)n0 * n0 + (uint32_t)n1 * n1
+                                + (uint32_t)n2 * n2 + (uint32_t)n3 * n3 - Q30_ONE) >> 16);
+
+  q0 -= fusion_mul(q0, normError);/* normError is (|q|^2 - 1) / 2 in Q15 */
+  q1 -= fusion_mul(q1, normError);
+  q2 -= fusion_mul(q2, normError);
+  q3 -= fusion_mul(q3, normError);
+
+}/* end fusion_update() */
+
+/* fusion_getQuaternion()
+
+   Copy the attitude quaternion (w, x, y, z) into 'q' in Q15.
+*/
+void fusion_getQuaternion(int16_t *q)
+{
+  q[0] = fusion_sat15(q0);
+  q[1] = fusion_sat15(q1);
+  q[2] = fusion_sat15(q2);
+  q[3] = fusion_sat15(q3);
+
+}/* end fusion_getQuaternion() */
+
+/* fusion_getEuler()
+
+   Copy the attitude as roll, pitch and yaw into 'euler', as binary angles.
+   The cosine of the pitch is the length of the (roll sine, roll cosine)
+   vector, so pitch comes from an atan2() as well and never needs asin().
+*/
+void fusion_getEuler(int16_t *euler)
+{
+  int16_t qa, qb, qc, qd;
+  int16_t sinRoll, cosRoll;
+
+  qa = fusion_sat15(q0);
+  qb = fusion_sat15(q1);
+  qc = fusion_sat15(q2);
+  qd = fusion_sat15(q3);
+
+/* the terms below are all in Q14 */
+  sinRoll = (int16_t)(((int32_t)qa * qb + (int32_t)qc * qd) >> 15);
+  cosRoll = (int16_t)(16384 - (((int32_t)qb * qb + (int32_t)qc * qc) >> 15));
+
+  euler[0] = cordic_atan2(sinRoll, cosRoll);
+  euler[1] = cordic_atan2((int16_t)(((int32_t)qa * qc - (int32_t)qd * qb) >> 15),
+                          (int16_t)cordic_magnitude(sinRoll, cosRoll));
+  euler[2] = cordic_atan2((int16_t)(((int32_t)qa * qd + (int32_t)qb * qc) >> 15),
+                          (int16_t)(16384 - (((int32_t)qc * qc + (int32_t)qd * qd) >> 15)));
+
+}/* end fusion_getEuler() */
@@ -0,0 +1,88 @@
+/*
+ * fusion.h
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Fixed-point attitude estimation (sensor fusion) for the ADXL345, ITG3205 and
+ * HMC5883.  This is Mahony's complementary filter done entirely in integer
+ * arithmetic, since the ATmega328 has no floating point hardware.  The gyro is
+ * integrated into a quaternion, and the accelerometer (gravity) and the
+ * magnetometer (north) pull the estimate back to stop it drifting.
+ *
+ * Number formats:
+ *    Q15 - int16_t, 32767 = 0.99997, used for unit vectors and quaternion
+ *          components handed out of the module
+ *    Q30 - int32_t, 1073741824 = 1.0, used for the quaternion inside the
+ *          module so small gyro steps aren't lost
+ *
+ * Nearly all multiplies are 16x16 bit, which the AVR does in hardware.  The
+ * expensive parts are the two square roots and divisions for normalising the
+ * sensor vectors.  A call to fusion_update() should take in the order of
+ * 10,000 cycles, well under the 160,000 available per update at 100Hz.
+ * sensors-ahrs.c measures and displays the actual count.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef FUSION_H_
+#define FUSION_H_
+
+#include <avr/io.h>
+
+/* FUSION_GYRO_SCALE()
+
+   Works out the 'gyroScale' argument for fusion_init() at compile time: the
+   rotation, in Q30 half-radians, of one gyro LSB held for one update period.
+   'lsbPerDps' is the gyro sensitivity (14.375 for the ITG3205), 'rateHz' is
+   how often fusion_update() is called.  Must come out below 32768, which it
+   does for the ITG3205 above about 20Hz.
+*/
+#define FUSION_GYRO_SCALE(lsbPerDps, rateHz) \
+  ((int16_t)(3.14159265358979 / 180.0 / (lsbPerDps) / 2.0 / (rateHz) * 1073741824.0 + 0.5))
+
+/* Feedback gains are powers of two, given as right shifts.
+
+   Proportional: Kp * T = 2^-kpShift, where T is the update period.  At 100Hz
+   a kpShift of 6 gives Kp = 1.6, a kpShift of 8 gives Kp = 0.4.
+
+   Integral: Ki * T * T = 2^-kiShift.  The integral term soaks up any gyro
+   bias left after calibration.  Use FUSION_KI_OFF to turn it off.
+*/
+#define FUSION_KI_OFF 0
+
+/* fusion_init()
+
+   Reset the attitude to level, pointing north, and set the gains.
+*/
+void fusion_init(int16_t gyroScale, uint8_t kpShift, uint8_t kiShift);
+
+/* fusion_update()
+
+   Advance the attitude estimate by one update period.  Each argument is a
+   three axis (X, Y, Z) raw sensor reading in the body frame; the three sensors
+   must have their axes lined up.  The accelerometer and magnetometer only need
+   to be in consistent units, the filter only uses their direction.  Pass 0 for
+   'mag' (or a zero vector) to run without the magnetometer; yaw will then
+   drift with the gyro.
+*/
+void fusion_update(const int16_t *gyro, const int16_t *accel, const int16_t *mag);
+
+/* fusion_getQuaternion()
+
+   Copy the attitude quaternion (w, x, y, z) into 'q' in Q15.
+*/
+void fusion_getQuaternion(int16_t *q);
+
+/* fusion_getEuler()
+
+   Copy the attitude as roll, pitch and yaw into 'euler', as binary angles (see
+   cordic.h).  Yaw is measured anticlockwise from magnetic north, looking
+   down, so the compass heading is minus the yaw.
+*/
+void fusion_getEuler(int16_t *euler);
+
+#endif /* FUSION_H_ */
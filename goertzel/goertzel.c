@@ -0,0 +1,139 @@
+/*
+ * goertzel.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Goertzel filters.  See goertzel.h.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include "goertzel.h"
+
+/* goertzel_mul()
+
+   (coef * s) >> shift for a Q14 coefficient and a 32-bit state, 'shift' being
+   13 or 14.  A plain 32 by 32 bit multiply would overflow and is slow on the
+   AVR, so the state is split in two halves, each needing one 16 by 16 bit
+   hardware multiply.  Good for |s| < 2^28.
+*/
+static inline int32_t goertzel_mul(int16_t coef, int32_t s, uint8_t shift)
+{
+  int32_t hi = (int32_t)coef * (int16_t)(s >> 16);
+  int32_t lo = (int32_t)coef * (uint16_t)s;
+
+  return(hi * (1L << (16 - shift)) + (lo >> shift));
+
+}/* end goertzel_mul() */
+
+/* goertzel_sqrt()
+
+   Integer square root, rounded down.
+*/
+static uint16_t goertzel_sqrt(uint32_t x)
+{
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+
+  while(bit > x)
+  {
+    bit >>= 2;
+  }
+
+  while(bit != 0)
+  {
+    if(x >= root + bit)
+    {
+      x -= root + bit;
+      root = (root >> 1) + bit;
+    }
+    else
+    {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+
+  return((uint16_t)root);
+
+}/* end goertzel_sqrt() */
+
+/* goertzel_add()
+
+   Put one sample through the bins.
+*/
+void goertzel_add(Goertzel_Bin *bins, uint8_t count, int16_t x)
+{
+  int32_t s;
+
+  while(count-- != 0)
+  {
+/* 2 * cos(w) * s1, cos(w) being Q14 */
+    s = x + goertzel_mul(bins->cos, bins->s1, 13) - bins->s2;
+    bins->s2 = bins->s1;
+    bins->s1 = s;
+    bins++;
+  }
+
+}/* end goertzel_add() */
+
+/* goertzel_level()
+
+   The real and imaginary parts of the bin's DFT term are
+   s1 - cos(w) * s2 and sin(w) * s2.  The tone's amplitude is twice the
+   length of that over the number of samples.
+*/
+uint16_t goertzel_level(Goertzel_Bin *bin, uint16_t n)
+{
+  int32_t re = bin->s1 - goertzel_mul(bin->cos, bin->s2, 14);
+  int32_t im = goertzel_mul(bin->sin, bin->s2, 14);
+  uint32_t level;
+  uint8_t shift = 0;
+
+  bin->s1 = 0;
+  bin->s2 = 0;
+
+  if(n == 0)
+  {
+    return(0);
+  }
+
+/* bring both into +/-2^15 so their squares add up without overflowing,
+   then scale the square root back up */
+  while(re >= 32768L || re < -32768L || im >= 32768L || im < -32768L)
+  {
+    re >>= 1;
+    im >>= 1;
+    shift++;
+  }
+
+  level = goertzel_sqrt((uint32_t)(re * re) + (uint32_t)(im * im));
+  level = ((level << shift) * 2 + n / 2) / n;
+
+  if(level > 65535)
+  {
+    level = 65535;
+  }
+
+  return((uint16_t)level);
+
+}/* end goertzel_level() */
+
+/* goertzel_clear()
+
+   Clear the bins' states.
+*/
+void goertzel_clear(Goertzel_Bin *bins, uint8_t count)
+{
+  while(count-- != 0)
+  {
+    bins->s1 = 0;
+    bins->s2 = 0;
+    bins++;
+  }
+
+}/* end goertzel_clear() */
@@ -0,0 +1,115 @@
+/*
+ * goertzel.h
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Goertzel filters, for measuring the level of a few known tones in a stream
+ * of samples without working out a whole FFT.  Each filter (a bin) is tuned
+ * to one frequency.  Every sample goes through all the bins, and after a
+ * block of N samples each bin gives the amplitude of its tone.  A bin picks
+ * up anything within about fs / N of its frequency, so N sets the
+ * bandwidth: at 9615 samples a second, N = 205 gives bins 47Hz wide, enough
+ * to tell the DTMF tones apart.
+ *
+ * Per sample each bin does
+ *
+ *    s = x + 2 * cos(w) * s1 - s2,   s2 = s1,   s1 = s
+ *
+ * in fixed point: cos(w) is in Q14 and the states are 32 bits, so there is
+ * no floating point.  The coefficients are worked out when the program is
+ * compiled, from the Taylor series of sin and cos in GOERTZEL_BIN(), so there
+ * is no maths library and no table of them to get wrong.
+ *
+ * Cost on an ATmega328: each bin does a 16 by 32 bit multiply as two 16 by 16
+ * bit hardware multiplies, then shifts, adds and moves its 8 bytes of state.
+ * That guesses at about 100 cycles per bin per sample, so eight bins at 9615
+ * samples a second would take about half of a 16MHz CPU.  The figure is an
+ * estimate from the instructions needed, not measured or counted from the
+ * compiler's listing; toneDetect.c prints the cycles goertzel_add() really
+ * takes, and that is the number to go by.  Reading a bin's level at the end
+ * of a block costs a square root, a few hundred cycles, and is meant for the
+ * main loop, not the interrupt.
+ *
+ * Only the integer types are needed, so this builds on a PC too:
+ * tools/goertzel-test.c runs it against made up signals.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef GOERTZEL_H_
+#define GOERTZEL_H_
+
+#include <stdint.h>
+
+/* One bin: its coefficients in Q14 (16384 = 1.0) and its state. */
+typedef struct
+{
+  int16_t cos;
+  int16_t sin;
+  int32_t s1;
+  int32_t s2;
+} Goertzel_Bin;
+
+/* GOERTZEL_BIN()
+
+   The initializer for a bin tuned to 'freq' Hz with 'fs' samples a second,
+   for example
+
+      Goertzel_Bin bins[] = {GOERTZEL_BIN(697, 9615), GOERTZEL_BIN(770, 9615)};
+
+   Both must be constants and freq must be less than fs / 2.  Near 0 and
+   fs / 2 the cosine changes so little with frequency that rounding it to
+   Q14 moves the bin by up to a Hz or so at 9615 samples a second.
+*/
+#define GOERTZEL_BIN(freq, fs) \
+  {GOERTZEL_Q14(GOERTZEL_COS(GOERTZEL_W(freq, fs))), \
+   GOERTZEL_Q14(GOERTZEL_SIN(GOERTZEL_W(freq, fs))), 0, 0}
+
+/* The angle the tone turns through between samples, in radians. */
+#define GOERTZEL_W(freq, fs) (2.0 * 3.14159265358979 * (double)(freq) / (double)(fs))
+
+/* GOERTZEL_COS(), GOERTZEL_SIN()
+
+   Taylor series of cos and sin to the x^16 and x^17 terms, written so they
+   nest.  From 0 to pi the error is under 2e-7, far below the 6e-5 step of
+   Q14.  The compiler works them out, nothing is left for the program.
+*/
+#define GOERTZEL_COS(w) (1.0 - (w) * (w) / 2 * (1.0 - (w) * (w) / 12 * \
+  (1.0 - (w) * (w) / 30 * (1.0 - (w) * (w) / 56 * (1.0 - (w) * (w) / 90 * \
+  (1.0 - (w) * (w) / 132 * (1.0 - (w) * (w) / 182 * (1.0 - (w) * (w) / 240))))))))
+
+#define GOERTZEL_SIN(w) ((w) * (1.0 - (w) * (w) / 6 * (1.0 - (w) * (w) / 20 * \
+  (1.0 - (w) * (w) / 42 * (1.0 - (w) * (w) / 72 * (1.0 - (w) * (w) / 110 * \
+  (1.0 - (w) * (w) / 156 * (1.0 - (w) * (w) / 210 * (1.0 - (w) * (w) / 272)))))))))
+
+/* a value from -1.0 to 1.0 in Q14, rounded */
+#define GOERTZEL_Q14(v) ((int16_t)((v) * 16384.0 + (((v) < 0) ? -0.5 : 0.5)))
+
+/* goertzel_add()
+
+   Put one sample through 'count' bins.  The states grow with the block
+   length, and faster for bins close to 0 or fs / 2, and must stay within
+   +/-2^28.  Samples of +/-512, from a 10-bit ADC, are safe for blocks of up to
+   4000 samples with every bin between fs / 200 and fs / 2 - fs / 200.
+*/
+void goertzel_add(Goertzel_Bin *bins, uint8_t count, int16_t x);
+
+/* goertzel_level()
+
+   The amplitude of the bin's tone over the 'n' samples added since the last
+   call, in the same units as the samples: a sine wave of amplitude 100 right
+   on the bin's frequency gives 100.  The bin is cleared for the next block.
+*/
+uint16_t goertzel_level(Goertzel_Bin *bin, uint16_t n);
+
+/* goertzel_clear()
+
+   Clear the states of 'count' bins without reading them.
+*/
+void goertzel_clear(Goertzel_Bin *bins, uint8_t count);
+
+#endif /* GOERTZEL_H_ */
@@ -0,0 +1,158 @@
+/*
+ * memdiag.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Memory diagnostics for the 2k of SRAM.  See memdiag.h.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include "memdiag.h"
+
+/* Set by the linker.  __heap_start is the end of .bss, where the heap would
+   start. */
+extern uint8_t __data_start, __data_end;
+extern uint8_t __bss_start, __bss_end;
+extern uint8_t __heap_start;
+
+/* The top of the heap, from avr-libc's malloc().  It is weak so that using it
+   doesn't pull malloc() into programs that don't, its address is 0 then. */
+extern uint8_t *__brkval __attribute__((weak));
+
+/* memdiag_paint()
+
+   Fill the RAM from the end of .bss to the top with MEMDIAG_PAINT.  It runs
+   in .init1, before the stack pointer and the zero register are set up and
+   before anything is on the stack, so it can't be an ordinary function: it is
+   naked, never called, and only uses the registers it loads itself.  The
+   hardware sets the stack pointer to RAMEND at reset, which is the last byte
+   painted.
+*/
+void memdiag_paint(void) __attribute__((naked, used, section(".init1")));
+
+void memdiag_paint(void)
+{
+  __asm__ __volatile__(
+    "    ldi r30, lo8(__heap_start)  \n"
+    "    ldi r31, hi8(__heap_start)  \n"
+    "    ldi r24, %0                 \n"
+    "    ldi r25, hi8(%1)            \n"
+    "1:  st Z+, r24                  \n"
+    "    cpi r30, lo8(%1)            \n"
+    "    cpc r31, r25                \n"
+    "    brne 1b                     \n"
+    :
+    : "M" (MEMDIAG_PAINT), "i" (RAMEND + 1)
+  );
+
+}/* end memdiag_paint() */
+
+/* memdiag_heap_end()
+
+   The first byte above the heap, or above .bss if the heap isn't used.
+*/
+static uint8_t *memdiag_heap_end(void)
+{
+  if((&__brkval != 0) && (__brkval != 0))
+  {
+    return(__brkval);
+  }
+
+  return(&__heap_start);
+
+}/* end memdiag_heap_end() */
+
+uint16_t memdiag_data_size(void)
+{
+  return((uint16_t)(&__data_end - &__data_start));
+
+}/* end memdiag_data_size() */
+
+uint16_t memdiag_bss_size(void)
+{
+  return((uint16_t)(&__bss_end - &__bss_start));
+
+}/* end memdiag_bss_size() */
+
+uint16_t memdiag_heap_size(void)
+{
+  return((uint16_t)(memdiag_heap_end() - &__heap_start));
+
+}/* end memdiag_heap_size() */
+
+/* memdiag_stack_size()
+
+   SP points at the next free byte below the stack.
+*/
+uint16_t memdiag_stack_size(void)
+{
+  return((uint16_t)(RAMEND - SP));
+
+}/* end memdiag_stack_size() */
+
+/* memdiag_free_min()
+
+   Count the paint left above the heap.  The stack pointer stops the count,
+   everything below it is fair game for the stack.
+*/
+uint16_t memdiag_free_min(void)
+{
+  const uint8_t *p = memdiag_heap_end();
+  const uint8_t *stack = (const uint8_t *)SP;
+  uint16_t count = 0;
+
+  while((p <= stack) && (*p == MEMDIAG_PAINT))
+  {
+    p++;
+    count++;
+  }
+
+  return(count);
+
+}/* end memdiag_free_min() */
+
+/* memdiag_stack_max()
+
+   Everything above the paint has been used by the stack.
+*/
+uint16_t memdiag_stack_max(void)
+{
+  return((uint16_t)(RAMEND + 1 - (uint16_t)memdiag_heap_end()) - memdiag_free_min());
+
+}/* end memdiag_stack_max() */
+
+/* memdiag_free()
+
+   From the top of the heap to the stack pointer, which is free itself.
+*/
+uint16_t memdiag_free(void)
+{
+  return((uint16_t)(SP + 1 - (uint16_t)memdiag_heap_end()));
+
+}/* end memdiag_free() */
+
+/* memdiag_report()
+
+   Print the sizes.  The smallest gap is worked out first, so that the stack
+   used by printing doesn't count.
+*/
+void memdiag_report(const Print_Sink *sink)
+{
+  uint16_t freeMin = memdiag_free_min();
+  uint16_t stackMax = memdiag_stack_max();
+
+  PRINT(sink, PRINT_P(".data:     "), memdiag_data_size(), PRINT_P("\r\n"));
+  PRINT(sink, PRINT_P(".bss:      "), memdiag_bss_size(), PRINT_P("\r\n"));
+  PRINT(sink, PRINT_P("heap:      "), memdiag_heap_size(), PRINT_P("\r\n"));
+  PRINT(sink, PRINT_P("stack now: "), memdiag_stack_size(), PRINT_P("\r\n"));
+  PRINT(sink, PRINT_P("stack max: "), stackMax, PRINT_P("\r\n"));
+  PRINT(sink, PRINT_P("free now:  "), memdiag_free(), PRINT_P("\r\n"));
+  PRINT(sink, PRINT_P("free min:  "), freeMin, PRINT_P(" of "), (uint16_t)(RAMEND + 1 - RAMSTART), PRINT_P("\r\n"));
+
+}/* end memdiag_report() */
@@ -0,0 +1,75 @@
+/*
+ * memdiag.h
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Memory diagnostics for the 2k of SRAM.  The RAM is laid out like this:
+ *
+ *    0x100  .data    initialized variables, copied from flash at start up
+ *           .bss     variables that start at zero
+ *           heap     malloc(), growing up, if the program uses it
+ *           (free)
+ *    0x8ff  stack    growing down
+ *
+ * If the stack grows down into the heap or the variables, the program goes
+ * wrong in ways that are very hard to track down.
+ *
+ * Linking memdiag.c in paints the free RAM with MEMDIAG_PAINT as the program
+ * starts, before main() and before the variables are set up.  The stack
+ * overwrites the paint as it grows and never puts it back, so the paint still
+ * left shows the smallest the free gap has ever been.  memdiag_report() sends
+ * the size of each part, the gap now and the smallest it has been to a print
+ * sink (see print.h).  If the smallest gap is 0 the stack has reached the
+ * heap or the variables.  The paint is only a guess: a value on the stack
+ * that happens to be MEMDIAG_PAINT looks unused.
+ *
+ * tools/ramreport.sh lists the RAM used by each variable and each object
+ * file of a program when it is built.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef MEMDIAG_H_
+#define MEMDIAG_H_
+
+#include <avr/io.h>
+#include "print/print.h"
+
+/* the value the free RAM is painted with */
+#define MEMDIAG_PAINT 0xc5
+
+/* memdiag_data_size(), memdiag_bss_size(), memdiag_heap_size()
+
+   The bytes used by each part of the RAM.  The heap is 0 if the program
+   doesn't use malloc().
+*/
+uint16_t memdiag_data_size(void);
+uint16_t memdiag_bss_size(void);
+uint16_t memdiag_heap_size(void);
+
+/* memdiag_stack_size(), memdiag_stack_max()
+
+   The bytes on the stack now, and the most there have ever been.
+*/
+uint16_t memdiag_stack_size(void);
+uint16_t memdiag_stack_max(void);
+
+/* memdiag_free(), memdiag_free_min()
+
+   The gap between the top of the heap, or the variables, and the stack now,
+   and the smallest it has been since start up.
+*/
+uint16_t memdiag_free(void);
+uint16_t memdiag_free_min(void);
+
+/* memdiag_report()
+
+   Print all of the above, one per line, each line ending with "\r\n".
+*/
+void memdiag_report(const Print_Sink *sink);
+
+#endif /* MEMDIAG_H_ */
@@ -15,8 +15,10 @@
  */ 
 
 #include <avr/io.h>
-#include <stdlib.h>/* for itoa() */
-#include "uart/uart.h"
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include "serial/serial.h"
+#include "fmt/fmt.h"
 
 /* Function prototypes */
 void swap(int *first, int *second);
@@ -29,82 +31,93 @@ int * variable_P;/* this is a pointer (points to integer variables) */
 /* Start of code */
 int main(void)
 {
-/* initialize the UART so we can use it to see what's going on */
-  uart_init(115200, USART_CHAR_SZ_EIGHT, USART_PARITY_NONE, USART_STOP_BIT_ONE);
+/* initialize the serial port so we can use it to see what's going on,
+   interrupts on so it sends in the background */
+  serial_init(115200);
+  sei();
 
 /* display the RAM addresses of the two variables, in HEX */
-  uart_putstr("Address of variable_1: 0x");
-  itoa((uint16_t)&variable_1, tempStr, 16);
-  uart_putstr(tempStr);
-  uart_putstr("\r\n");
-  uart_putstr("Address of variable_2: 0x");
-  itoa((uint16_t)&variable_2, tempStr, 16);
-  uart_putstr(tempStr);
-  uart_putstr("\r\n");
+  serial_putstr_P(PSTR("Address of variable_1: 0x"));
+  fmt_hex16((uint16_t)&variable_1, tempStr);
+  serial_putstr(tempStr);
+  serial_putstr_P(PSTR("\r\n"));
+  serial_putstr_P(PSTR("Address of variable_2: 0x"));
+  fmt_hex16((uint16_t)&variable_2, tempStr);
+  serial_putstr(tempStr);
+  serial_putstr_P(PSTR("\r\n"));
   
 /* display the address of the pointer in HEX (where it is located in RAM not
    what it points to) */
-  uart_putstr("Address of *variable_P: 0x");
-  itoa((uint16_t)&variable_P, tempStr, 16);
-  uart_putstr(tempStr);
-  uart_putstr("\r\n");
+  serial_putstr_P(PSTR("Address of *variable_P: 0x"));
+  fmt_hex16((uint16_t)&variable_P, tempStr);
+  serial_putstr(tempStr);
+  serial_putstr_P(PSTR("\r\n"));
 
 /* assign some values to the variables */
   variable_1 = 1234;
   variable_2 = 5678;
 
 /* display the contents of the two variables before swap() */
-  uart_putstr("Before swap():\r\n");
-  itoa(variable_1, tempStr, 10);
-  uart_putstr("variable_1 = ");
-  uart_putstr(tempStr);
-  uart_putstr("\r\n");
-  itoa(variable_2, tempStr, 10);
-  uart_putstr("variable_2 = ");
-  uart_putstr(tempStr);
-  uart_putstr("\r\n");
+  serial_putstr_P(PSTR("Before swap():\r\n"));
+  fmt_dec16(variable_1, 0, tempStr);
+  serial_putstr_P(PSTR("variable_1 = "));
+  serial_putstr(tempStr);
+  serial_putstr_P(PSTR("\r\n"));
+  fmt_dec16(variable_2, 0, tempStr);
+  serial_putstr_P(PSTR("variable_2 = "));
+  serial_putstr(tempStr);
+  serial_putstr_P(PSTR("\r\n"));
 
 /* perform the swap */
   swap(&variable_1, &variable_2);
 
 /* display the contents of the two variables after swap() */
-  uart_putstr("After swap():\r\n");
-  itoa(variable_1, tempStr, 10);
-  uart_putstr("variable_1 = ");
-  uart_putstr(tempStr);
-  uart_putstr("\r\n");
-  itoa(variable_2, tempStr, 10);
-  uart_putstr("variable_2 = ");
-  uart_putstr(tempStr);
-  uart_putstr("\r\n");
+  serial_putstr_P(PSTR("After swap():\r\n"));
+  fmt_dec16(variable_1, 0, tempStr);
+  serial_putstr_P(PSTR("variable_1 = "));
+  serial_putstr(tempStr);
+  serial_putstr_P(PSTR("\r\n"));
+  fmt_dec16(variable_2, 0, tempStr);
+  serial_putstr_P(PSTR("variable_2 = "));
+  serial_putstr(tempStr);
+  serial_putstr_P(PSTR("\r\n"));
 
 /* assign the address of variable_1 to the pointer variable_P */
   variable_P = &variable_1;
 
 /* display the contents of the pointer, and the contents of the variable it
    points to */
-  uart_putstr("Contents of *variable_P (address of variable_1): 0x");
-  itoa((uint16_t)variable_P, tempStr, 16);
-  uart_putstr(tempStr);
-  uart_putstr("\r\n");
-  uart_putstr("Contents of location *variable_P points to (variable_1): ");
-  itoa(*variable_P, tempStr, 10);
-  uart_putstr(tempStr);
-  uart_putstr("\r\n");
+  serial_putstr_P(PSTR("Contents of *variable_P (address of variable_1): 0x"));
+  fmt_hex16((uint16_t)variable_P, tempStr);
+  serial_putstr(tempStr);
+  serial_putstr_P(PSTR("\r\n"));
+  serial_putstr_P(PSTR("Contents of location *variable_P points to (variable_1): "));
+  fmt_dec16(*variable_P, 0, tempStr);
+  serial_putstr(tempStr);
+  serial_putstr_P(PSTR("\r\n"));
 
 /* perform the swap using the pointer in place of variable_1 */
   swap(variable_P, &variable_2);
   
 /* display the contents of the variables after second swap() */
-  uart_putstr("After second swap():\r\n");
-  itoa(variable_1, tempStr, 10);
-  uart_putstr("variable_1 = ");
-  uart_putstr(tempStr);
-  uart_putstr("\r\n");
-  itoa(variable_2, tempStr, 10);
-  uart_putstr("variable_2 = ");
-  uart_putstr(tempStr);
-  uart_putstr("\r\n");
+  serial_putstr_P(PSTR("After second swap():\r\n"));
+  fmt_dec16(variable_1, 0, tempStr);
+  serial_putstr_P(PSTR("variable_1 = "));
+  serial_putstr(tempStr);
+  serial_putstr_P(PSTR("\r\n"));
+  fmt_dec16(variable_2, 0, tempStr);
+  serial_putstr_P(PSTR("variable_2 = "));
+  serial_putstr(tempStr);
+  serial_putstr_P(PSTR("\r\n"));
+
+/* show how much of the transmit buffer was used */
+  fmt_udec16(serial_tx_high_water(), 0, tempStr);
+  serial_putstr_P(PSTR("TX buffer high water: "));
+  serial_putstr(tempStr);
+  serial_putstr_P(PSTR(" of "));
+  fmt_udec16(SERIAL_TX_SIZE - 1, 0, tempStr);
+  serial_putstr(tempStr);
+  serial_putstr_P(PSTR("\r\n"));
 
 /* wait here forever */
   while (1) 
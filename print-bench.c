@@ -0,0 +1,134 @@
+/*
+ * print-bench.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Compares PRINT() (print/print.h) with the library snprintf_P().  The same
+ * line of sensor readings is built both ways into a buffer in RAM, and the
+ * cycles each took are sent out the serial port at 115200 baud, along with
+ * the two lines so they can be checked against each other.  Timer 1 runs at
+ * the CPU clock, so its count is the number of cycles.
+ *
+ * To compare the flash used, build with BENCH_PRINTF set to 0, then with
+ * BENCH_PRINT set to 0, and look at the sizes reported by avr-size.  Each
+ * build still has the other's share of fmt and serial, so the difference is
+ * the cost of the formatter alone.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <stdio.h>/* for snprintf_P() */
+#include "serial/serial.h"
+#include "fmt/fmt.h"
+#include "print/print.h"
+
+/* which formatters to build in */
+#ifndef BENCH_PRINT
+#define BENCH_PRINT 1
+#endif
+#ifndef BENCH_PRINTF
+#define BENCH_PRINTF 1
+#endif
+
+/* Function prototypes */
+void buffer_putstr(const char *str);
+void buffer_putstr_P(const char *str);
+void print_result(const char *label, uint16_t cycles);
+
+/* the line being built, and a sink that writes to it */
+static char buffer[48];
+static uint8_t bufferLength;
+static const Print_Sink bufferSink = {buffer_putstr, buffer_putstr_P};
+
+/* Start of code */
+int main(void)
+{
+  int16_t x = 0x0123, y = -0x0456, z = 0x1000;
+  uint16_t heading = 271;
+  uint16_t startCount, cycles;
+
+/* initialize the serial port so we can see the results */
+  serial_init(115200);
+  sei();
+
+/* Timer 1 counts CPU cycles, no interrupts */
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);
+
+/* Each timed section starts with the serial port quiet, so the data
+   register empty interrupt isn't stealing cycles from it while it sends the
+   last result. */
+#if BENCH_PRINT
+  bufferLength = 0;
+  buffer[0] = '\0';
+  serial_flush();
+  startCount = TCNT1;
+  PRINT(&bufferSink, PRINT_P("acc "), PRINT_HEX(x), PRINT_P(" "), PRINT_HEX(y), PRINT_P(" "),
+        PRINT_HEX(z), PRINT_P(" hdg "), heading, PRINT_P("\r\n"));
+  cycles = TCNT1 - startCount;
+  print_result(PSTR("PRINT():      "), cycles);
+#endif
+
+#if BENCH_PRINTF
+  serial_flush();
+  startCount = TCNT1;
+  snprintf_P(buffer, sizeof(buffer), PSTR("acc %04x %04x %04x hdg %u\r\n"), x, y, z, heading);
+  cycles = TCNT1 - startCount;
+  print_result(PSTR("snprintf_P(): "), cycles);
+#endif
+
+/* wait here forever */
+  while(1)
+  {
+  }/* end while() */
+
+}/* end main() */
+
+/* buffer_putstr(), buffer_putstr_P()
+ *
+ * Add a string in RAM or flash to the end of the buffer, as much as fits.
+ */
+void buffer_putstr(const char *str)
+{
+  while((*str != '\0') && (bufferLength < sizeof(buffer) - 1))
+  {
+    buffer[bufferLength++] = *str++;
+  }
+  buffer[bufferLength] = '\0';
+
+}/* end buffer_putstr() */
+
+void buffer_putstr_P(const char *str)
+{
+  char c;
+
+  while(((c = pgm_read_byte(str++)) != '\0') && (bufferLength < sizeof(buffer) - 1))
+  {
+    buffer[bufferLength++] = c;
+  }
+  buffer[bufferLength] = '\0';
+
+}/* end buffer_putstr_P() */
+
+/* print_result()
+ *
+ * Send a label from flash, a cycle count and the line that was built to the
+ * serial port.
+ */
+void print_result(const char *label, uint16_t cycles)
+{
+  char str[6];
+
+  serial_putstr_P(label);
+  serial_putstr(fmt_udec16(cycles, 5, str));
+  serial_putstr_P(PSTR(" cycles: "));
+  serial_putstr(buffer);
+
+}/* end print_result() */
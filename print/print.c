@@ -0,0 +1,101 @@
+/*
+ * print.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * The routines behind PRINT().  See print.h.  The sinks are in files of
+ * their own so a program only links the one it uses.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include "fmt/fmt.h"
+#include "print.h"
+
+/* print_str(), print_flash(), print_char()
+
+   Strings and characters go straight to the sink.
+*/
+void print_str(const Print_Sink *sink, const char *str)
+{
+  sink->putstr(str);
+
+}/* end print_str() */
+
+void print_flash(const Print_Sink *sink, Print_Flash item)
+{
+  sink->putstr_P(item.str);
+
+}/* end print_flash() */
+
+void print_char(const Print_Sink *sink, char c)
+{
+  char str[2];
+
+  str[0] = c;
+  str[1] = '\0';
+  sink->putstr(str);
+
+}/* end print_char() */
+
+/* print_dec(), print_udec(), print_hex(), print_dec_width(),
+   print_udec_width()
+
+   Numbers are converted by fmt into a string on the stack, big enough for
+   the longest, "-32768".
+*/
+void print_dec(const Print_Sink *sink, int16_t value)
+{
+  char str[7];
+
+  sink->putstr(fmt_dec16(value, 0, str));
+
+}/* end print_dec() */
+
+void print_udec(const Print_Sink *sink, uint16_t value)
+{
+  char str[7];
+
+  sink->putstr(fmt_udec16(value, 0, str));
+
+}/* end print_udec() */
+
+void print_hex(const Print_Sink *sink, Print_Hex item)
+{
+  char str[5];
+
+  sink->putstr(fmt_hex16(item.value, str));
+
+}/* end print_hex() */
+
+void print_dec_width(const Print_Sink *sink, Print_Dec item)
+{
+  char str[7];
+
+  if(item.width > 6)
+  {
+    item.width = 6;
+  }
+
+  sink->putstr(fmt_dec16(item.value, item.width, str));
+
+}/* end print_dec_width() */
+
+void print_udec_width(const Print_Sink *sink, Print_UDec item)
+{
+  char str[11];
+
+  if(item.width > 10)
+  {
+    item.width = 10;
+  }
+
+  sink->putstr(fmt_udec32(item.value, item.width, str));
+
+}/* end print_udec_width() */
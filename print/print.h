@@ -0,0 +1,142 @@
+/*
+ * print.h
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * A small, type safe replacement for printf().  Instead of a format string
+ * the line to print is given as a list of items:
+ *
+ *    PRINT(&print_serial, PRINT_P("Length of int: "), (int)sizeof(int), PRINT_P("\r\n"));
+ *    PRINT(&print_display, PRINT_P("x="), PRINT_HEX(x), " y=", PRINT_DEC(y, 5));
+ *
+ * Each item's type picks the routine that prints it when the program is
+ * compiled (C11 _Generic), so PRINT() turns into one call per item with
+ * nothing left to work out at run time:
+ *
+ *    char *, const char *  string in RAM
+ *    PRINT_P("...")        string in flash
+ *    char                  one character (a character constant such as ' '
+ *                          is an int in C and prints as a number, use " ")
+ *    int, short, int8_t    signed decimal, fmt_dec16()
+ *    unsigned, uint8_t     unsigned decimal, fmt_udec16()
+ *    PRINT_HEX(x)          4 hex digits, fmt_hex16()
+ *    PRINT_DEC(x, width)   signed decimal right justified in 'width'
+ *    PRINT_UDEC(x, width)  unsigned 32-bit decimal right justified in
+ *                          'width', fmt_udec32(), 0 for just wide enough
+ *
+ * Any other type (a long or a float, say) doesn't compile, where printf()
+ * would print rubbish.  PRINT() takes up to 10 items.
+ *
+ * printf() reads its format string a character at a time while the program
+ * runs, and vfprintf() alone takes 1k to 2k of flash depending on which
+ * version is linked.  print-bench.c compares the two.
+ *
+ * A sink says where the text goes: print_serial sends it with serial.h,
+ * print_display draws it with display.h at the cursor.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef PRINT_H_
+#define PRINT_H_
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+
+/* where the text goes, a string in RAM or a string in flash at a time */
+typedef struct
+{
+  void (*putstr)(const char *str);
+  void (*putstr_P)(const char *str);
+} Print_Sink;
+
+/* the sinks */
+extern const Print_Sink print_serial;
+extern const Print_Sink print_display;
+
+/* the items that aren't plain C types */
+typedef struct
+{
+  const char *str;
+} Print_Flash;
+
+typedef struct
+{
+  uint16_t value;
+} Print_Hex;
+
+typedef struct
+{
+  int16_t value;
+  uint8_t width;
+} Print_Dec;
+
+typedef struct
+{
+  uint32_t value;
+  uint8_t width;
+} Print_UDec;
+
+#define PRINT_P(str)             ((Print_Flash){PSTR(str)})
+#define PRINT_HEX(value)         ((Print_Hex){(uint16_t)(value)})
+#define PRINT_DEC(value, width)  ((Print_Dec){(int16_t)(value), (width)})
+#define PRINT_UDEC(value, width) ((Print_UDec){(uint32_t)(value), (width)})
+
+/* the routines behind the items */
+void print_str(const Print_Sink *sink, const char *str);
+void print_flash(const Print_Sink *sink, Print_Flash item);
+void print_char(const Print_Sink *sink, char c);
+void print_dec(const Print_Sink *sink, int16_t value);
+void print_udec(const Print_Sink *sink, uint16_t value);
+void print_hex(const Print_Sink *sink, Print_Hex item);
+void print_dec_width(const Print_Sink *sink, Print_Dec item);
+void print_udec_width(const Print_Sink *sink, Print_UDec item);
+
+/* PRINT_ITEM()
+
+   Print one item, the routine picked by its type.
+*/
+#define PRINT_ITEM(sink, item) _Generic((item), \
+  char *: print_str, \
+  const char *: print_str, \
+  char: print_char, \
+  signed char: print_dec, \
+  short: print_dec, \
+  int: print_dec, \
+  unsigned char: print_udec, \
+  unsigned short: print_udec, \
+  unsigned int: print_udec, \
+  Print_Flash: print_flash, \
+  Print_Hex: print_hex, \
+  Print_Dec: print_dec_width, \
+  Print_UDec: print_udec_width)((sink), (item))
+
+/* PRINT()
+
+   Print up to 10 items to 'sink', one after the other.  The items are
+   counted and PRINT_ITEM() is repeated for each.
+*/
+#define PRINT(sink, ...) \
+  do { PRINT_JOIN(PRINT_, PRINT_COUNT(__VA_ARGS__))(sink, __VA_ARGS__) } while(0)
+
+#define PRINT_COUNT(...) PRINT_COUNT_(__VA_ARGS__, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define PRINT_COUNT_(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, n, ...) n
+#define PRINT_JOIN(a, b)  PRINT_JOIN_(a, b)
+#define PRINT_JOIN_(a, b) a##b
+
+#define PRINT_1(s, a)       PRINT_ITEM(s, a);
+#define PRINT_2(s, a, ...)  PRINT_ITEM(s, a); PRINT_1(s, __VA_ARGS__)
+#define PRINT_3(s, a, ...)  PRINT_ITEM(s, a); PRINT_2(s, __VA_ARGS__)
+#define PRINT_4(s, a, ...)  PRINT_ITEM(s, a); PRINT_3(s, __VA_ARGS__)
+#define PRINT_5(s, a, ...)  PRINT_ITEM(s, a); PRINT_4(s, __VA_ARGS__)
+#define PRINT_6(s, a, ...)  PRINT_ITEM(s, a); PRINT_5(s, __VA_ARGS__)
+#define PRINT_7(s, a, ...)  PRINT_ITEM(s, a); PRINT_6(s, __VA_ARGS__)
+#define PRINT_8(s, a, ...)  PRINT_ITEM(s, a); PRINT_7(s, __VA_ARGS__)
+#define PRINT_9(s, a, ...)  PRINT_ITEM(s, a); PRINT_8(s, __VA_ARGS__)
+#define PRINT_10(s, a, ...) PRINT_ITEM(s, a); PRINT_9(s, __VA_ARGS__)
+
+#endif /* PRINT_H_ */
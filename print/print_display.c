@@ -0,0 +1,36 @@
+/*
+ * print_display.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * The PRINT() sink for the display, text is drawn at the cursor.  See
+ * print.h.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include "display/display.h"
+#include "print.h"
+
+/* print_display_putStr_P()
+
+   display_putStr() for a string in flash.
+*/
+static void print_display_putStr_P(const char *str)
+{
+  char c;
+
+  while((c = pgm_read_byte(str++)) != '\0')
+  {
+    display_putChar(c);
+  }
+
+}/* end print_display_putStr_P() */
+
+const Print_Sink print_display = {display_putStr, print_display_putStr_P};
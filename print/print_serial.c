@@ -0,0 +1,19 @@
+/*
+ * print_serial.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * The PRINT() sink for the serial port.  See print.h.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include "serial/serial.h"
+#include "print.h"
+
+const Print_Sink print_serial = {serial_putstr, serial_putstr_P};
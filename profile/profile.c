@@ -0,0 +1,232 @@
+/*
+ * profile.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * A profiler for the stages of a main loop.  See profile.h.  Nothing in here
+ * is compiled unless PROFILE is defined.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include "profile.h"
+
+#ifdef PROFILE
+
+#if PROFILE_PRESCALE == 1
+#define PROFILE_CLOCK_SELECT _BV(CS10)
+#elif PROFILE_PRESCALE == 8
+#define PROFILE_CLOCK_SELECT _BV(CS11)
+#elif PROFILE_PRESCALE == 64
+#define PROFILE_CLOCK_SELECT (_BV(CS11) | _BV(CS10))
+#else
+#error "PROFILE_PRESCALE must be 1, 8 or 64"
+#endif
+
+/* width of the columns of numbers in the table, and of the names, and
+   PROFILE_NAME_WIDTH spaces to pad the names out with */
+#define PROFILE_NUMBER_WIDTH 8
+#define PROFILE_NAME_WIDTH   8
+#define PROFILE_NAME_SPACES  "        "
+
+/* the times of one stage, in timer ticks */
+typedef struct
+{
+  const char *name;
+  uint32_t sum;
+  uint16_t count;
+  uint16_t min;
+  uint16_t max;
+} Profile_Stage;
+
+static Profile_Stage profileStages[PROFILE_STAGES];
+
+/* Timer 1 at the end of the last lap */
+static uint16_t profileMark;
+
+/* profile_init()
+
+   Timer 1 in normal mode, counting up and wrapping around.
+*/
+void profile_init(void)
+{
+  TCCR1A = 0;
+  TCCR1B = PROFILE_CLOCK_SELECT;
+
+  profile_reset();
+
+}/* end profile_init() */
+
+void profile_name(uint8_t stage, const char *name)
+{
+  profileStages[stage].name = name;
+
+}/* end profile_name() */
+
+void profile_start(void)
+{
+  profileMark = TCNT1;
+
+}/* end profile_start() */
+
+/* profile_lap()
+
+   Timer 1 is read first thing and again last thing, so the time spent in
+   here doesn't count.  A stage stops counting laps before its sum could
+   overflow.
+*/
+void profile_lap(uint8_t stage)
+{
+  uint16_t ticks = TCNT1 - profileMark;
+  Profile_Stage *s = &profileStages[stage];
+
+  if(s->count != 0xffff)
+  {
+    s->count++;
+    s->sum += ticks;
+    if(ticks < s->min)
+    {
+      s->min = ticks;
+    }
+    if(ticks > s->max)
+    {
+      s->max = ticks;
+    }
+  }
+
+  profileMark = TCNT1;
+
+}/* end profile_lap() */
+
+/* profile_reset()
+
+   Clear the times, the minimum so the first lap replaces it.
+*/
+void profile_reset(void)
+{
+  uint8_t i;
+
+  for(i = 0; i < PROFILE_STAGES; i++)
+  {
+    profileStages[i].sum = 0;
+    profileStages[i].count = 0;
+    profileStages[i].min = 0xffff;
+    profileStages[i].max = 0;
+  }
+
+}/* end profile_reset() */
+
+/* profile_average()
+
+   The average time of a stage in cycles, rounded.
+*/
+static uint32_t profile_average(const Profile_Stage *s)
+{
+  if(s->count == 0)
+  {
+    return(0);
+  }
+
+  return((s->sum + s->count / 2) / s->count * PROFILE_PRESCALE);
+
+}/* end profile_average() */
+
+/* profile_per_second()
+
+   Laps round the whole loop per second, from the sum of the average times of
+   the stages.
+*/
+static uint16_t profile_per_second(void)
+{
+  uint32_t cycles = 0;
+  uint8_t i;
+
+  for(i = 0; i < PROFILE_STAGES; i++)
+  {
+    cycles += profile_average(&profileStages[i]);
+  }
+
+  if(cycles == 0)
+  {
+    return(0);
+  }
+
+  return((uint16_t)((F_CPU + cycles / 2) / cycles));
+
+}/* end profile_per_second() */
+
+/* profile_print()
+
+   Print the table.  Stages without a name or without any laps are left
+   out.
+*/
+void profile_print(const Print_Sink *sink)
+{
+  const Profile_Stage *s;
+  uint8_t i, length;
+
+  PRINT(sink, PRINT_P("stage        min     avg     max   laps\r\n"));
+
+  for(i = 0; i < PROFILE_STAGES; i++)
+  {
+    s = &profileStages[i];
+    if((s->name == 0) || (s->count == 0))
+    {
+      continue;
+    }
+
+    sink->putstr_P(s->name);
+    length = strlen_P(s->name);
+    if(length < PROFILE_NAME_WIDTH)
+    {
+      sink->putstr_P(PSTR(PROFILE_NAME_SPACES) + length);
+    }
+
+  /* the widest, 65535 ticks at a prescale of 64, is 7 digits */
+    PRINT(sink, PRINT_UDEC((uint32_t)s->min * PROFILE_PRESCALE, PROFILE_NUMBER_WIDTH),
+          PRINT_UDEC(profile_average(s), PROFILE_NUMBER_WIDTH),
+          PRINT_UDEC((uint32_t)s->max * PROFILE_PRESCALE, PROFILE_NUMBER_WIDTH),
+          PRINT_UDEC(s->count, PROFILE_NUMBER_WIDTH - 1), PRINT_P("\r\n"));
+  }
+
+  PRINT(sink, PRINT_P("loops/s "), profile_per_second(), PRINT_P("\r\n"));
+
+}/* end profile_print() */
+
+/* profile_summary()
+
+   Print the short line.
+*/
+void profile_summary(const Print_Sink *sink)
+{
+  const Profile_Stage *slowest = 0;
+  uint32_t average, slowestAverage = 0;
+  uint8_t i;
+
+  for(i = 0; i < PROFILE_STAGES; i++)
+  {
+    average = profile_average(&profileStages[i]);
+    if((profileStages[i].name != 0) && (average > slowestAverage))
+    {
+      slowest = &profileStages[i];
+      slowestAverage = average;
+    }
+  }
+
+  PRINT(sink, profile_per_second(), PRINT_P("/s"));
+  if(slowest != 0)
+  {
+    PRINT(sink, " ");
+    sink->putstr_P(slowest->name);
+    PRINT(sink, " ", PRINT_UDEC(slowestAverage, 0));
+  }
+
+}/* end profile_summary() */
+
+#endif /* PROFILE */
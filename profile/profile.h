@@ -0,0 +1,129 @@
+/*
+ * profile.h
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * A profiler for the stages of a main loop.  Timer 1 runs free as a clock,
+ * and each stage is timed from one PROFILE_LAP() to the next:
+ *
+ *    PROFILE_INIT();
+ *    PROFILE_NAME(STAGE_READ, "read");
+ *    PROFILE_NAME(STAGE_DRAW, "draw");
+ *    PROFILE_START();
+ *    while(1)
+ *    {
+ *      read_sensors();
+ *      PROFILE_LAP(STAGE_READ);
+ *      draw();
+ *      PROFILE_LAP(STAGE_DRAW);
+ *    }
+ *
+ * For each stage the shortest, average and longest time is kept, in CPU
+ * cycles.  PROFILE_PRINT() sends the table to a print sink (see print.h),
+ * PROFILE_SUMMARY() prints one short line, the loops per second and the
+ * slowest stage, small enough to go on the display.  If the laps go all the
+ * way round the loop, the loops per second come from the sum of the stages.
+ *
+ * All of this is only compiled in when PROFILE is defined on the compiler
+ * command line.  Otherwise every macro is empty, and the program is exactly
+ * what it would be without them.
+ *
+ * Timer 1 runs at F_CPU / PROFILE_PRESCALE, 8 unless it is defined as 1, 8 or
+ * 64.  A stage must take less than 65536 timer ticks, 32ms with the default,
+ * or it wraps around; with a prescale of 1 the times are exact to the cycle
+ * but a stage must be shorter than 4ms.  A lap costs about 60 cycles, which is
+ * left out of both stages.  Timer 1 can't be used for anything else.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+
+/* the largest number of stages */
+#ifndef PROFILE_STAGES
+#define PROFILE_STAGES 8
+#endif
+
+/* the Timer 1 clock */
+#ifndef PROFILE_PRESCALE
+#define PROFILE_PRESCALE 8
+#endif
+
+#ifdef PROFILE
+
+#include "print/print.h"
+
+#define PROFILE_INIT()            profile_init()
+#define PROFILE_NAME(stage, name) profile_name((stage), PSTR(name))
+#define PROFILE_START()           profile_start()
+#define PROFILE_LAP(stage)        profile_lap(stage)
+#define PROFILE_RESET()           profile_reset()
+#define PROFILE_PRINT(sink)       profile_print(sink)
+#define PROFILE_SUMMARY(sink)     profile_summary(sink)
+
+/* profile_init()
+
+   Start Timer 1 and clear the stages.
+*/
+void profile_init(void);
+
+/* profile_name()
+
+   Name a stage, 'name' is a string in flash.  Unnamed stages aren't printed.
+*/
+void profile_name(uint8_t stage, const char *name);
+
+/* profile_start()
+
+   Start timing the first stage.
+*/
+void profile_start(void);
+
+/* profile_lap()
+
+   The time since the last lap, or profile_start(), goes to 'stage'.  Then
+   start timing the next stage.
+*/
+void profile_lap(uint8_t stage);
+
+/* profile_reset()
+
+   Clear the times of all the stages, leaving their names.
+*/
+void profile_reset(void);
+
+/* profile_print()
+
+   Print a table of the stages: name, shortest, average and longest time in
+   cycles, and the number of laps.  Each line ends with "\r\n".
+*/
+void profile_print(const Print_Sink *sink);
+
+/* profile_summary()
+
+   Print the loops per second and the name and average time of the slowest
+   stage, such as "25/s draw 40012".
+*/
+void profile_summary(const Print_Sink *sink);
+
+#else /* PROFILE */
+
+#define PROFILE_INIT()            ((void)0)
+#define PROFILE_NAME(stage, name) ((void)0)
+#define PROFILE_START()           ((void)0)
+#define PROFILE_LAP(stage)        ((void)0)
+#define PROFILE_RESET()           ((void)0)
+#define PROFILE_PRINT(sink)       ((void)0)
+#define PROFILE_SUMMARY(sink)     ((void)0)
+
+#endif /* PROFILE */
+
+#endif /* PROFILE_H_ */
@@ -0,0 +1,279 @@
+/*
+ * pwmAnalyzer.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * A network analyzer on one board: the DDS sine wave of pwmDDS.c drives a
+ * circuit, the ADC measures what comes out of it, and the gain and phase of
+ * the circuit are sent down the serial port for a list of frequencies.
+ *
+ * Timer/Counter 1 sets the pace.  It counts in CTC mode at F_CPU / 8, and its
+ * compare match B starts each ADC conversion through the ADC's auto trigger,
+ * F_SAMPLE times a second.  The ADC interrupt then does the DDS: it steps the
+ * phase accumulator and writes the next value to the PWM, as the Timer 2
+ * interrupt does in pwmDDS.c.  So every ADC sample is taken at a known phase
+ * of the output, with no drift between the two.  (The ADC can't be triggered
+ * by Timer 2, which is why this uses Timer 1.)
+ *
+ * Each sample is demodulated as it comes in, like a lock-in amplifier: it is
+ * multiplied by the sine and the cosine of the phase, both from the same sine
+ * table, and added into two 32-bit sums, I and Q.  That is two multiplies and
+ * two adds per sample, no division.  Only whole turns of the phase
+ * accumulator are summed, so the DC level of the input and the component at
+ * twice the frequency cancel out.  Afterwards the main loop turns I and Q into
+ * a length and an angle with cordic_polar() (see cordic/cordic.h), and
+ * divides once to get the gain.
+ *
+ * The gain is the amplitude at the ADC over the amplitude of the DDS, both in
+ * volts, assuming AVCC for both, times 1000.  The phase is in degrees,
+ * positive when the output leads.  The numbers include the delay from the
+ * PWM, its filter and the ADC sample and hold, which grows with frequency:
+ * measure once with the circuit replaced by a wire, and take those results
+ * away.
+ *
+ * The ADC is overclocked.  It runs at F_CPU / 32, 500kHz, to sample fast
+ * enough for the 10kHz point, but the ATmega328 datasheet only promises the
+ * full 10 bits between 50 and 200kHz.  At 500kHz expect about 8 to 9
+ * effective bits.  Summing I and Q over thousands of samples averages out
+ * most of the extra noise, but not the extra nonlinearity, which distorts
+ * the measured gain and phase most for small signals: keep the circuit's
+ * output near full scale.  For full accuracy set the prescaler to 128
+ * (125kHz, a conversion in 108us), F_SAMPLE to 8000 and drop the 5kHz and
+ * 10kHz points, which would then be above F_SAMPLE / 2.
+ *
+ * Output, 115200 baud, one line per frequency:
+ *
+ *    frequency (Hz),gain (x1000),phase (degrees)
+ *
+ * Connections:
+ *    OC0A (PD6), Arduino pin 6 - PWM through its filter to the circuit
+ *    ADC0 (PC0), Arduino A0    - the circuit's output, biased to AVCC / 2
+ *    TX (PD1), Arduino pin 1   - serial port
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include "serial/serial.h"
+#include "print/print.h"
+#include "cordic/cordic.h"
+
+/* The DDS update and ADC sample frequency in Hz.  A conversion takes 13.5
+   ADC clocks, 27us at the overclocked 500kHz, so it can't be much more than
+   30kHz. */
+#define F_SAMPLE 25000
+
+/* Samples thrown away after a change of frequency, for the circuit to
+   settle, and the least that are summed.  The sums stop at the end of the
+   next whole turn of the phase accumulator after that.  16384 samples of up
+   to 511 x 127 fit the 32-bit sums with room to spare. */
+#define SETTLE_SAMPLES  2500
+#define MEASURE_SAMPLES 8192
+
+/* the sine table swings from 0 to 255, its amplitude is half of that */
+#define SINE_SWING 255
+
+/* The frequencies to measure, in Hz. */
+const uint16_t FREQUENCIES[] PROGMEM =
+{
+  20, 50, 100, 200, 500, 1000, 2000, 5000, 10000
+};
+#define FREQUENCY_COUNT (sizeof(FREQUENCIES) / sizeof(FREQUENCIES[0]))
+
+/* Sine table, the same as pwmDDS.c.  The sine used for demodulating is the
+   table less 128, the cosine is the same a quarter of a turn, 64 entries,
+   further on. */
+uint8_t SINE_TABLE[]=
+{
+  128, 131, 134, 137, 140, 143, 146, 149, 152, 156, 159, 162, 165, 168, 171, 174,
+  176, 179, 182, 185, 188, 191, 193, 196, 199, 201, 204, 206, 209, 211, 213, 216,
+  218, 220, 222, 224, 226, 228, 230, 232, 234, 236, 237, 239, 240, 242, 243, 245,
+  246, 247, 248, 249, 250, 251, 252, 252, 253, 254, 254, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 254, 254, 253, 252, 252, 251, 250, 249, 248, 247,
+  246, 245, 243, 242, 240, 239, 237, 236, 234, 232, 230, 228, 226, 224, 222, 220,
+  218, 216, 213, 211, 209, 206, 204, 201, 199, 196, 193, 191, 188, 185, 182, 179,
+  176, 174, 171, 168, 165, 162, 159, 156, 152, 149, 146, 143, 140, 137, 134, 131,
+  127, 124, 121, 118, 115, 112, 109, 106, 103, 99, 96, 93, 90, 87, 84, 81,
+  79, 76, 73, 70, 67, 64, 62, 59, 56, 54, 51, 49, 46, 44, 42, 39,
+  37, 35, 33, 31, 29, 27, 25, 23, 21, 19, 18, 16, 15, 13, 12, 10,
+  9, 8, 7, 6, 5, 4, 3, 3, 2, 1, 1, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 1, 1, 2, 3, 3, 4, 5, 6, 7, 8,
+  9, 10, 12, 13, 15, 16, 18, 19, 21, 23, 25, 27, 29, 31, 33, 35,
+  37, 39, 42, 44, 46, 49, 51, 54, 56, 59, 62, 64, 67, 70, 73, 76,
+  79, 81, 84, 87, 90, 93, 96, 99, 103, 106, 109, 112, 115, 118, 121, 124
+};
+
+/* the DDS phase accumulator */
+volatile uint16_t phaseReg, phaseInc;
+
+/* What the ADC interrupt is doing with the samples. */
+#define STATE_IDLE    0 /* nothing, the results are ready */
+#define STATE_SETTLE  1 /* throwing them away */
+#define STATE_START   2 /* waiting for the phase to come round to 0 */
+#define STATE_MEASURE 3 /* adding them up */
+
+volatile uint8_t state;
+volatile uint16_t sampleCount;
+volatile int32_t sumI, sumQ;
+
+/* This is the ADC Conversion Complete interrupt service routine.  Timer 1
+   compare match B started the conversion, so it runs F_SAMPLE times a
+   second.  The sample was taken while the DDS was putting out the phase in
+   phaseReg.  Here it is demodulated, then the DDS moves on to the next
+   phase. */
+ISR(ADC_vect)
+{
+  int16_t sample = ADC - 512;
+  uint8_t i = (uint8_t)(phaseReg >> 8);
+  uint16_t lastPhase = phaseReg;
+
+  /* The conversion started on the rising edge of the compare match B flag.
+     Nothing else clears it, so clear it here for the next one. */
+  TIFR1 = _BV(OCF1B);
+
+  if(state == STATE_MEASURE)
+  {
+    sumI += (int32_t)sample * (int8_t)(SINE_TABLE[i] - 128);
+    sumQ += (int32_t)sample * (int8_t)(SINE_TABLE[(uint8_t)(i + 64)] - 128);
+    sampleCount++;
+  }
+  else if(state == STATE_SETTLE)
+  {
+    if(--sampleCount == 0)
+    {
+      state = STATE_START;
+    }
+  }
+
+  phaseReg = lastPhase + phaseInc;
+  OCR0A = SINE_TABLE[(uint8_t)(phaseReg >> 8)]; /* update TC0 output compare register */
+
+  /* Has the phase gone round through 0?  Start or stop adding up. */
+  if(phaseReg < lastPhase)
+  {
+    if(state == STATE_START)
+    {
+      sumI = sumQ = 0;
+      sampleCount = 0;
+      state = STATE_MEASURE;
+    }
+    else if((state == STATE_MEASURE) && (sampleCount >= MEASURE_SAMPLES))
+    {
+      state = STATE_IDLE;
+    }
+  }
+
+}/* end ISR(ADC_vect) */
+
+/* measure()
+
+   Set the DDS to 'frequency', wait for the sums, then work out the gain and
+   phase.  The phase increment is rounded, the frequency actually made is
+   returned.
+*/
+uint16_t measure(uint16_t frequency, uint16_t *gain, int16_t *phase)
+{
+  int32_t i, q;
+  uint32_t length, divisor;
+  uint16_t inc, count;
+  uint8_t shift = 0;
+
+  inc = (uint16_t)(((uint32_t)frequency * 65536 + F_SAMPLE / 2) / F_SAMPLE);
+
+  cli();
+  phaseInc = inc;
+  sampleCount = SETTLE_SAMPLES;
+  state = STATE_SETTLE;
+  sei();
+
+  while(state != STATE_IDLE)
+  {
+  }
+
+  i = sumI;
+  q = sumQ;
+  count = sampleCount;
+
+  /* CORDIC takes 16 bits, shift both sums down until they fit */
+  while((i > 32767) || (i < -32767) || (q > 32767) || (q < -32767))
+  {
+    i >>= 1;
+    q >>= 1;
+    shift++;
+  }
+  length = (uint32_t)cordic_polar((int16_t)i, (int16_t)q, phase) << shift;
+
+  /* The length comes to count * amplitude * (SINE_SWING / 2) / 2, the
+     amplitude in ADC counts of AVCC / 1024.  The DDS amplitude is
+     SINE_SWING / 2 counts of AVCC / 256, or 2 * SINE_SWING ADC counts.  So
+     the gain is length / (count * SINE_SWING^2 / 2), times 1000. */
+  divisor = (uint32_t)count * (SINE_SWING * SINE_SWING / 2) / 1000;
+  *gain = (uint16_t)((length + divisor / 2) / divisor);
+
+  return((uint16_t)(((uint32_t)inc * F_SAMPLE + 32768) >> 16));
+
+}/* end measure() */
+
+/* This is where it all happens. */
+int main(void)
+{
+  uint16_t frequency, gain;
+  int16_t phase;
+  uint8_t n;
+
+  /* Set up the IO port registers for the IO pin connected to the PWM output
+     pin OC0A (PD6), Arduino pin 6. */
+  DDRD |= _BV(PORTD6);
+
+  /* Set up Timer 0 to generate a Fast PWM signal:
+     - clocked by F_CPU (fastest PWM frequency)
+     - non-inverted output */
+  TCCR0A = (_BV(WGM00) | _BV(WGM01) | _BV(COM0A1)); /* TC0 Mode 3, Fast PWM */
+  TCCR0B = _BV(CS00); /* TC0 clocked by F_CPU, no prescale */
+  OCR0A = 128; /* start in the middle */
+
+  /* Set up the ADC:
+     - AVCC reference, input ADC0, result right adjusted
+     - clocked by F_CPU / 32, 500kHz, beyond the 200kHz for full resolution
+       (see the top of the file)
+     - started by Timer 1 compare match B, interrupt when done */
+  ADMUX = _BV(REFS0);
+  ADCSRB = _BV(ADTS2) | _BV(ADTS0); /* trigger on TC1 compare match B */
+  DIDR0 = _BV(ADC0D); /* ADC0 is analog only */
+  ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIE) | _BV(ADPS2) | _BV(ADPS0);
+
+  /* Set up Timer 1 to start the ADC F_SAMPLE times a second:
+     - clocked by F_CPU / 8
+     - mode 4, CTC, cleared when it matches OCR1A
+     - compare match B at the top of the count too */
+  TCCR1A = 0;
+  TCCR1B = _BV(WGM12) | _BV(CS11);
+  OCR1A = (F_CPU / 8 / F_SAMPLE - 1); /* = 79 */
+  OCR1B = (F_CPU / 8 / F_SAMPLE - 1);
+
+  serial_init(115200);
+
+  /* enable the interrupt system */
+  sei();
+
+  PRINT(&print_serial, PRINT_P("\r\nHz,gain x1000,phase\r\n"));
+
+  /* run around this loop for ever, sweeping the frequencies */
+  while (1) 
+  {
+    for(n = 0; n < FREQUENCY_COUNT; n++)
+    {
+      frequency = measure(pgm_read_word(&FREQUENCIES[n]), &gain, &phase);
+      PRINT(&print_serial, frequency, ",", gain, ",", CORDIC_DEGREES(phase), PRINT_P("\r\n"));
+    }
+    PRINT(&print_serial, PRINT_P("\r\n"));
+
+  }/* end while(1) */
+
+}/* end main() */
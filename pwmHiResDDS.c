@@ -0,0 +1,161 @@
+/*
+ * pwmHiResDDS.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Source code for producing a DDS (Direct Digital Synthesis) generated sine
+ * wave signal with more resolution than pwmDDS.c.  That uses the 8-bit Fast
+ * PWM of Timer/Counter 0, so the output only has 256 levels, and a 256 entry
+ * table, so the phase is cut to 8 bits.  Both add noise to the sine wave.
+ *
+ * Here the 16-bit Timer/Counter 1 makes the PWM, in Fast PWM mode with the
+ * top of the count set by ICR1.  A top of 1023 gives 10 bits at 15,625Hz, a
+ * top of 511 gives 9 bits at 31,250Hz (set PWM_BITS).  The PWM period is also
+ * the DDS update period: the Timer 1 overflow interrupt works out the next
+ * sample, and OCR1A only takes the new value at the start of the next period,
+ * so updating it any faster would be no use.
+ *
+ * The phase accumulator is the same 16-bit one as pwmDDS.c.  The top 10 bits
+ * of it look up a quarter of a sine wave, 257 entries of 16 bits in flash,
+ * which the other three quarters are mirrored from, so the phase is good to 10
+ * bits and the table only takes 514 bytes.
+ *
+ * Each bit of resolution is worth about 6dB of signal to noise ratio, so the
+ * 10-bit output should be about 12dB cleaner than the 8-bit one.
+ * tools/dds-snr.c works out both from the samples the two programs produce:
+ * about 42dB for pwmDDS.c against 54dB here, the rounding of the phase
+ * costing each a little over a bit.
+ * The PWM frequency is lower, so the output filter has to cut off lower too:
+ * the highest output frequency is limited to a few kHz.
+ *
+ * For more bits still, OC1B could carry the low bits of each sample through
+ * a resistor 2^PWM_BITS times bigger than the one on OC1A, the two summed
+ * into the filter.  That needs the resistors matched to better than a bit,
+ * and isn't done here.
+ *
+ * The output is on OC1A (PB1), Arduino pin 9.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+/* This is the desired output frequency in Hz. */
+#define F_DDS_OUT 1000
+
+/* PWM resolution in bits, 9 or 10.  It sets the PWM frequency, which is also
+   the DDS update frequency (NOT the same as pwmDDS.c). */
+#define PWM_BITS 10
+#define PWM_TOP ((1 << PWM_BITS) - 1)
+#define F_UPDATE (F_CPU / (PWM_TOP + 1))
+
+/* A quarter of a sine wave, 0 to 90 degrees inclusive, in 257 steps.  Each
+   value is 32767 * sin(i * 90 / 256 degrees), rounded.  It is kept in flash,
+   a table this size would use up a quarter of the RAM. */
+const uint16_t QUARTER_SINE_TABLE[257] PROGMEM =
+{
+  0, 201, 402, 603, 804, 1005, 1206, 1407, 1608, 1809, 2009, 2210,
+  2410, 2611, 2811, 3012, 3212, 3412, 3612, 3811, 4011, 4210, 4410, 4609,
+  4808, 5007, 5205, 5404, 5602, 5800, 5998, 6195, 6393, 6590, 6786, 6983,
+  7179, 7375, 7571, 7767, 7962, 8157, 8351, 8545, 8739, 8933, 9126, 9319,
+  9512, 9704, 9896, 10087, 10278, 10469, 10659, 10849, 11039, 11228, 11417, 11605,
+  11793, 11980, 12167, 12353, 12539, 12725, 12910, 13094, 13279, 13462, 13645, 13828,
+  14010, 14191, 14372, 14553, 14732, 14912, 15090, 15269, 15446, 15623, 15800, 15976,
+  16151, 16325, 16499, 16673, 16846, 17018, 17189, 17360, 17530, 17700, 17869, 18037,
+  18204, 18371, 18537, 18703, 18868, 19032, 19195, 19357, 19519, 19680, 19841, 20000,
+  20159, 20317, 20475, 20631, 20787, 20942, 21096, 21250, 21403, 21554, 21705, 21856,
+  22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027, 23170, 23311, 23452, 23592,
+  23731, 23870, 24007, 24143, 24279, 24413, 24547, 24680, 24811, 24942, 25072, 25201,
+  25329, 25456, 25582, 25708, 25832, 25955, 26077, 26198, 26319, 26438, 26556, 26674,
+  26790, 26905, 27019, 27133, 27245, 27356, 27466, 27575, 27683, 27790, 27896, 28001,
+  28105, 28208, 28310, 28411, 28510, 28609, 28706, 28803, 28898, 28992, 29085, 29177,
+  29268, 29358, 29447, 29534, 29621, 29706, 29791, 29874, 29956, 30037, 30117, 30195,
+  30273, 30349, 30424, 30498, 30571, 30643, 30714, 30783, 30852, 30919, 30985, 31050,
+  31113, 31176, 31237, 31297, 31356, 31414, 31470, 31526, 31580, 31633, 31685, 31736,
+  31785, 31833, 31880, 31926, 31971, 32014, 32057, 32098, 32137, 32176, 32213, 32250,
+  32285, 32318, 32351, 32382, 32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589,
+  32609, 32628, 32646, 32663, 32678, 32692, 32705, 32717, 32728, 32737, 32745, 32752,
+  32757, 32761, 32765, 32766, 32767
+};
+
+/* These are the counters used to generate the index into the table. */
+uint16_t phaseReg, phaseInc;
+
+/* sine()
+
+   Look up the top 10 bits of 'phase' in the quarter wave table.  In the
+   second and fourth quarters the table is read backwards, in the third and
+   fourth the value is negative.  Returns -32767 to 32767.
+*/
+static inline int16_t sine(uint16_t phase)
+{
+  uint8_t quarter = phase >> 14;
+  uint16_t i = (phase >> 6) & 0xff;
+  int16_t value;
+
+  if(quarter & 1)
+  {
+    i = 256 - i;
+  }
+
+  value = (int16_t)pgm_read_word(&QUARTER_SINE_TABLE[i]);
+
+  if(quarter & 2)
+  {
+    value = -value;
+  }
+
+  return(value);
+
+}/* end sine() */
+
+/* This is the Timer 1 Overflow interrupt service routine.  Runs at the start
+   of every PWM period, when OCR1A has just taken the last value written.
+   Here the next sample is worked out and written to OCR1A.  The sine goes
+   from -32767 to 32767, shifted down it is +/-(PWM_TOP / 2) around the
+   middle of the range. */
+ISR(TIMER1_OVF_vect)
+{
+  phaseReg += phaseInc;
+
+  OCR1A = (PWM_TOP + 1) / 2 + (sine(phaseReg) >> (16 - PWM_BITS));
+
+}/* end ISR(TIMER1_OVF_vect) */
+
+/* This is where it all happens. */
+int main(void)
+{
+  /* Set up the IO port register for the IO pin connected to the PWM output
+     pin OC1A (PB1), Arduino pin 9. */
+  DDRB |= _BV(PORTB1);
+
+  /* Set up Timer 1 to generate a Fast PWM signal:
+     - mode 14, the top of the count set by ICR1
+     - clocked by F_CPU (fastest PWM frequency)
+     - non-inverted output on OC1A
+     - interrupt at the end of each period */
+  TCCR1A = (_BV(COM1A1) | _BV(WGM11)); /* TC1 Mode 14, Fast PWM, TOP = ICR1 */
+  TCCR1B = (_BV(WGM13) | _BV(WGM12) | _BV(CS10)); /* TC1 clocked by F_CPU */
+  ICR1 = PWM_TOP;
+  OCR1A = (PWM_TOP + 1) / 2; /* start in the middle */
+  TIMSK1 = _BV(TOIE1); /* enable TOIE1, overflow interrupt */
+
+  phaseReg = 0;
+  phaseInc = (uint16_t)((uint32_t)F_DDS_OUT * 65536 / F_UPDATE);
+
+  /* enable the interrupt system */
+  sei();
+
+  /* run around this loop for ever */
+  while (1) 
+  {
+    /* Nothing happens here, all the work is done in the ISR */
+  }/* end while(1) */
+
+}/* end main() */
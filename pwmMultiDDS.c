@@ -0,0 +1,430 @@
+/*
+ * pwmMultiDDS.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Up to four sine waves at once from the DDS of pwmVariableDDS.c, added
+ * together into one output: DTMF tones, or two or more tones close together
+ * for testing a circuit's intermodulation distortion.
+ *
+ * Each voice has its own phase accumulator and an amplitude from 0 to 255,
+ * 255 being the full swing of the output.  Every 20us (50,000Hz, from Timer 2
+ * as before) the interrupt steps each accumulator, looks its phase up in the
+ * sine table, multiplies by the voice's amplitude and adds it to the mix.
+ * That is one 8 by 8 bit hardware multiply and a few adds per voice.  The
+ * mix goes to the PWM on OC0A and to the R2R ladder on PORTC, the same as
+ * pwmVariableDDS.c.
+ *
+ * When the amplitudes add up to more than 255 the mix can go past the ends
+ * of the output.  It is saturated, clipped at the ends rather than wrapping
+ * round, and the clipped samples are counted.  With headroom on (the 'h'
+ * command) the amplitudes are scaled down together whenever they add up to
+ * more than 255, so the mix never clips, at the cost of each tone being
+ * quieter.
+ *
+ * The budget for each sample is 320 cycles (16MHz / 50,000Hz).  Timer 1
+ * counts CPU cycles, and the interrupt times itself from its first statement
+ * to its last: roughly 30 cycles plus 25 per voice.  The register saves and
+ * restores before and after, about 50 cycles (check the listing), aren't
+ * counted.  So four voices take about 180 of the 320 cycles and the main loop
+ * and the serial port get the rest.  The '?' command sends the worst count
+ * since the last report.
+ *
+ * Commands, 115200 baud, each ended with RETURN:
+ *
+ *    0-9 * # A-D          play a DTMF key, two voices
+ *    t f1 [f2 [f3 [f4]]]  play one to four tones, frequencies in Hz
+ *    a a1 [a2 [a3 [a4]]]  set the amplitudes of the voices, 0 to 255
+ *    h                    turn headroom scaling on or off
+ *    ?                    report the voices, the cycles and clipping
+ *
+ * The AVR has no interrupt priorities.  The serial port's interrupts turn
+ * interrupts back on after a few cycles (see pwmVariableDDS.c and
+ * serial/serial.h), so they don't hold up the samples for long.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <stdlib.h>/* for strtol() */
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+#include "serial/serial.h"
+#include "print/print.h"
+
+/* function prototypes */
+void setVoices(const uint16_t *frequencies, uint8_t count);
+void scaleAmplitudes(uint8_t count, uint8_t *scaled);
+void applyAmplitudes(void);
+void command(char *line);
+void report(void);
+
+/* ASCII codes for carriage and line feed */
+#define CR 0x0d
+#define LF 0x0a
+
+/* DDS update frequency in Hz (NOT the PWM frequency). */
+#define DDS_UPDATE_FREQ 50000
+
+/* Cycles between DDS updates. */
+#define DDS_BUDGET (F_CPU / DDS_UPDATE_FREQ)
+
+/* Maximum DDS output frequency. */
+#define MAX_DDS_FREQ 15000
+
+/* Most voices, and the total amplitude that can't clip. */
+#define VOICES 4
+#define FULL_SCALE 255
+
+/* The DTMF keys and their tones, a row tone from the low group and a column
+   tone from the high group. */
+const char DTMF_KEYS[] PROGMEM = "123A456B789C*0#D";
+const uint16_t DTMF_ROWS[4] PROGMEM = {697, 770, 852, 941};
+const uint16_t DTMF_COLUMNS[4] PROGMEM = {1209, 1336, 1477, 1633};
+
+/* Sine table, the same as pwmVariableDDS.c.  The voices use it less 128,
+   -128 to 127. */
+uint8_t SINE_TABLE[]=
+{
+  128, 131, 134, 137, 140, 143, 146, 149, 152, 156, 159, 162, 165, 168, 171, 174,
+  176, 179, 182, 185, 188, 191, 193, 196, 199, 201, 204, 206, 209, 211, 213, 216,
+  218, 220, 222, 224, 226, 228, 230, 232, 234, 236, 237, 239, 240, 242, 243, 245,
+  246, 247, 248, 249, 250, 251, 252, 252, 253, 254, 254, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 254, 254, 253, 252, 252, 251, 250, 249, 248, 247,
+  246, 245, 243, 242, 240, 239, 237, 236, 234, 232, 230, 228, 226, 224, 222, 220,
+  218, 216, 213, 211, 209, 206, 204, 201, 199, 196, 193, 191, 188, 185, 182, 179,
+  176, 174, 171, 168, 165, 162, 159, 156, 152, 149, 146, 143, 140, 137, 134, 131,
+  127, 124, 121, 118, 115, 112, 109, 106, 103, 99, 96, 93, 90, 87, 84, 81,
+  79, 76, 73, 70, 67, 64, 62, 59, 56, 54, 51, 49, 46, 44, 42, 39,
+  37, 35, 33, 31, 29, 27, 25, 23, 21, 19, 18, 16, 15, 13, 12, 10,
+  9, 8, 7, 6, 5, 4, 3, 3, 2, 1, 1, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 1, 1, 2, 3, 3, 4, 5, 6, 7, 8,
+  9, 10, 12, 13, 15, 16, 18, 19, 21, 23, 25, 27, 29, 31, 33, 35,
+  37, 39, 42, 44, 46, 49, 51, 54, 56, 59, 62, 64, 67, 70, 73, 76,
+  79, 81, 84, 87, 90, 93, 96, 99, 103, 106, 109, 112, 115, 118, 121, 124
+};
+
+/* The voices used by the interrupt: a phase accumulator and an amplitude
+   each.  Only the first voiceCount are played, so fewer voices take less
+   time. */
+uint16_t phaseReg[VOICES], phaseInc[VOICES];
+uint8_t amplitude[VOICES];
+uint8_t voiceCount;
+
+/* The amplitudes asked for, and whether they are scaled down to fit. */
+uint8_t level[VOICES] = {FULL_SCALE / 2, FULL_SCALE / 2, FULL_SCALE / 2, FULL_SCALE / 2};
+uint8_t headroom = 1;
+
+/* The interrupt's cycle count, the most since the last report, and the
+   clipped samples. */
+volatile uint16_t cyclesLast, cyclesWorst;
+volatile uint16_t clipped;
+
+/* This is the Timer 2 Compare A interrupt service routine.  Runs every time
+   the counter (TCNT2) matches the output compare register A (OCR2A).  Here
+   the voices are added up and the sum is written to the outputs. */
+ISR(TIMER2_COMPA_vect)
+{
+  uint16_t startCount = TCNT1;
+  int16_t mix = 0;
+  uint8_t v, out;
+
+  /* Each voice is -128..127 times 0..255.  A quarter of that, for four
+     voices, still fits 16 bits. */
+  for(v = 0; v < voiceCount; v++)
+  {
+    phaseReg[v] += phaseInc[v];
+    mix += ((int8_t)(SINE_TABLE[(uint8_t)(phaseReg[v] >> 8)] - 128) * amplitude[v]) >> 2;
+  }
+
+  /* back to -128..127, the rest of the divide by 256, and saturate */
+  mix >>= 6;
+  if(mix > 127)
+  {
+    mix = 127;
+    clipped++;
+  }
+  else if(mix < -128)
+  {
+    mix = -128;
+    clipped++;
+  }
+  out = (uint8_t)(mix + 128);
+
+  /* because PORTC is only 6-bits wide, use only the upper 6-bits for OCR0A 
+     so that both outputs will match */
+  OCR0A = out & 0b11111100; /* update PWM register */
+  PORTC = out >> 2;/* update R2R ladder */
+
+  cyclesLast = TCNT1 - startCount;
+  if(cyclesLast > cyclesWorst)
+  {
+    cyclesWorst = cyclesLast;
+  }
+
+}/* end ISR(TIMER2_COMPA_vect) */
+
+/* This is where it all happens. */
+int main(void)
+{
+  static char line[32];
+  static const uint16_t startTones[2] = {697, 1209};/* DTMF 1 */
+  uint8_t length = 0;
+  char c;
+
+  /* Set up the IO port registers for the IO pin connected to the PWM output
+     pin OC0A (PD6), Arduino pin 6. and PORTC for the R2R ladder. */
+  DDRD |= (_BV(PORTD6)) | (_BV(PORTD5));
+  DDRC = 0b00111111;
+
+  /* Set up Timer 0 to generate a Fast PWM signal:
+     - clocked by F_CPU (fastest PWM frequency)
+     - non-inverted output */
+  TCCR0A = (_BV(WGM00) | _BV(WGM01) | _BV(COM0A1)); /* TC0 Mode 3, Fast PWM */
+  TCCR0B = _BV(CS00); /* TC0 clocked by F_CPU, no prescale */
+  OCR0A = 128; /* start in the middle */
+
+  /* Set up Timer 1 to count CPU cycles, normal mode, no prescale. */
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);
+
+  /* Set up Timer 2 to interrupt at 50,000Hz:
+     - clocked by F_CPU / 8
+     - generate interrupt when OCR2A matches TCNT2
+     - load OCR2A with the count to get 50,000Hz
+   */
+  TCCR2A = _BV(WGM21); /* TC2 mode 2, CTC - clear timer on match A */
+  TCCR2B = _BV(CS21); /* clock by F_CPU / 8 */
+  OCR2A = (F_CPU / 8 / DDS_UPDATE_FREQ - 1); /* = 39 */
+  TIMSK2 = _BV(OCIE2A); /* enable OCIE2A, match A interrupt */
+
+  setVoices(startTones, 2);
+
+  serial_init(115200);
+  serial_rx_enable();
+
+  /* enable the interrupt system */
+  sei();
+
+  PRINT(&print_serial, PRINT_P("\r\nDTMF 1\r\n"));
+
+  /* run around this loop for ever, collecting commands a line at a time */
+  while (1) 
+  {
+    if(serial_available() != 0)
+    {
+      c = serial_getchar();
+      serial_putchar(c);/* echo it back to the terminal */
+
+      if(c == CR)
+      {
+        serial_putchar(LF);
+        line[length] = 0;
+        command(line);
+        length = 0;
+      }
+      else if(length < sizeof(line) - 1)
+      {
+        line[length++] = c;
+      }
+    }
+
+  }/* end while(1) */
+
+}/* end main() */
+
+/* setVoices()
+
+   Play 'count' tones, with the amplitudes set by the 'a' command.  The
+   accumulators start together at 0, so the mix always starts the same way.
+   The interrupt gets the new voices and their amplitudes all at once, so it
+   never mixes new voices with the old amplitudes.
+*/
+void setVoices(const uint16_t *frequencies, uint8_t count)
+{
+  uint16_t inc[VOICES];
+  uint8_t scaled[VOICES];
+  uint16_t frequency;
+  uint8_t v;
+
+  for(v = 0; v < count; v++)
+  {
+    frequency = (frequencies[v] > MAX_DDS_FREQ) ? MAX_DDS_FREQ : frequencies[v];
+    inc[v] = (uint16_t)(((uint32_t)frequency * 65536 + DDS_UPDATE_FREQ / 2) / DDS_UPDATE_FREQ);
+  }
+  scaleAmplitudes(count, scaled);
+
+  ATOMIC_BLOCK(ATOMIC_FORCEON)
+  {
+    for(v = 0; v < count; v++)
+    {
+      phaseReg[v] = 0;
+      phaseInc[v] = inc[v];
+      amplitude[v] = scaled[v];
+    }
+    voiceCount = count;
+  }
+
+}/* end setVoices() */
+
+/* scaleAmplitudes()
+
+   The amplitudes asked for of the first 'count' voices, scaled down to add
+   up to no more than FULL_SCALE if headroom is on.
+*/
+void scaleAmplitudes(uint8_t count, uint8_t *scaled)
+{
+  uint16_t total = 0;
+  uint8_t v;
+
+  for(v = 0; v < count; v++)
+  {
+    total += level[v];
+  }
+
+  for(v = 0; v < count; v++)
+  {
+    if(headroom && (total > FULL_SCALE))
+    {
+      scaled[v] = (uint8_t)((uint16_t)level[v] * FULL_SCALE / total);
+    }
+    else
+    {
+      scaled[v] = level[v];
+    }
+  }
+
+}/* end scaleAmplitudes() */
+
+/* applyAmplitudes()
+
+   Give the interrupt new amplitudes for the voices playing.
+*/
+void applyAmplitudes(void)
+{
+  uint8_t scaled[VOICES];
+  uint8_t v;
+
+  scaleAmplitudes(voiceCount, scaled);
+
+  ATOMIC_BLOCK(ATOMIC_FORCEON)
+  {
+    for(v = 0; v < voiceCount; v++)
+    {
+      amplitude[v] = scaled[v];
+    }
+  }
+
+}/* end applyAmplitudes() */
+
+/* command()
+
+   Carry out one line typed by the user, see the list at the top.
+*/
+void command(char *line)
+{
+  uint16_t numbers[VOICES];
+  const char *key;
+  char *next, *end;
+  uint8_t count = 0;
+  long value;
+
+  if(line[0] == '?')
+  {
+    report();
+    return;
+  }
+
+  if(line[0] == 'h')
+  {
+    headroom = !headroom;
+    applyAmplitudes();
+    PRINT(&print_serial, PRINT_P("headroom "), headroom ? PRINT_P("on\r\n") : PRINT_P("off\r\n"));
+    return;
+  }
+
+  /* one character on its own, a DTMF key */
+  if((line[0] != 0) && (line[1] == 0))
+  {
+    key = strchr_P(DTMF_KEYS, line[0]);
+    if(key != NULL)
+    {
+      numbers[0] = pgm_read_word(&DTMF_ROWS[(key - DTMF_KEYS) / 4]);
+      numbers[1] = pgm_read_word(&DTMF_COLUMNS[(key - DTMF_KEYS) % 4]);
+      setVoices(numbers, 2);
+      return;
+    }
+  }
+
+  /* 't' or 'a' and a list of numbers */
+  if((line[0] == 't') || (line[0] == 'a'))
+  {
+    next = line + 1;
+    while(count < VOICES)
+    {
+      value = strtol(next, &end, 10);
+      if((end == next) || (value < 0))
+      {
+        break;/* no more numbers */
+      }
+      numbers[count++] = (value > 65535) ? 65535 : (uint16_t)value;
+      next = end;
+    }
+
+    if((count != 0) && (line[0] == 't'))
+    {
+      setVoices(numbers, count);
+      return;
+    }
+    if((count != 0) && (line[0] == 'a'))
+    {
+      while(count-- != 0)
+      {
+        level[count] = (numbers[count] > FULL_SCALE) ? FULL_SCALE : (uint8_t)numbers[count];
+      }
+      applyAmplitudes();
+      return;
+    }
+  }
+
+  PRINT(&print_serial, PRINT_P("?\r\n"));
+
+}/* end command() */
+
+/* report()
+
+   Send each voice's frequency and amplitude, then the interrupt's cycles
+   against the budget and the number of clipped samples.  The worst cycle
+   count and the clipped samples are cleared for next time.
+*/
+void report(void)
+{
+  uint16_t last, worst, clips;
+  uint8_t v;
+
+  for(v = 0; v < voiceCount; v++)
+  {
+    PRINT(&print_serial, PRINT_P("voice "), v + 1, " ",
+          (uint16_t)(((uint32_t)phaseInc[v] * DDS_UPDATE_FREQ + 32768) >> 16),
+          PRINT_P("Hz amplitude "), amplitude[v], PRINT_P("\r\n"));
+  }
+
+  ATOMIC_BLOCK(ATOMIC_FORCEON)
+  {
+    last = cyclesLast;
+    worst = cyclesWorst;
+    clips = clipped;
+    cyclesWorst = 0;
+    clipped = 0;
+  }
+
+  PRINT(&print_serial, PRINT_P("cycles "), last, PRINT_P(" worst "), worst,
+        PRINT_P(" of "), (uint16_t)DDS_BUDGET, PRINT_P(", plus the register saves\r\n"));
+  PRINT(&print_serial, PRINT_P("clipped "), clips, PRINT_P("\r\n"));
+
+}/* end report() */
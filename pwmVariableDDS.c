@@ -17,7 +17,40 @@
  *
  * In this version of the DDS, the frequency can be varied by the user typing
  * the desired frequency on the PC keyboard.  The microcontroller UART is 
- * utilized to do this.
+ * utilized to do this, at 115200 baud.
+ *
+ * The AVR has no interrupt priorities, so while any other interrupt runs the
+ * DDS interrupt has to wait, and the next sample comes out late.  The serial
+ * port's interrupts (serial/serial.h) only grab a received byte or send the
+ * next one, the characters are worked out here in the main loop.  They also
+ * turn interrupts back on as soon as they have done that (SERIAL_ISR_NOBLOCK,
+ * the serial port's default).  Then the longest the DDS interrupt can be
+ * held off, counted from the compare match, is estimated from the
+ * instructions as:
+ *
+ *    a serial interrupt responding and jumping to its handler    7 cycles
+ *    its register saves, the byte and turning itself off       ~25 cycles
+ *    sei() and the one instruction always run after it      up to 5 cycles
+ *    the DDS interrupt responding and jumping to its handler     7 cycles
+ *
+ * about 45 cycles (2.8us) all told, or 6 counts of Timer 2, however fast
+ * commands come in.  That is an estimate, not a measurement: the register
+ * saves depend on the compiler, so check the listing, and measure it with
+ * DDS_LATENCY below.  Built with SERIAL_ISR_BLOCKING the whole of a serial
+ * interrupt, around 70 cycles (also estimated), comes before the sample.  The
+ * only other time interrupts are off is writing a new phaseInc, a few
+ * cycles.
+ *
+ * Compiled with DDS_LATENCY defined, the interrupt measures its own latency:
+ * how long after the compare match it got going, read from TCNT2 as the first
+ * thing it does.  Timer 2 counts at F_CPU / 8, so each count is 0.5us (8
+ * cycles).  Every sample goes into a histogram, and the worst latency and the
+ * number of late samples are kept for whatever was running at the time: one
+ * of the serial port's interrupts, or else what the main loop was doing (see
+ * DDS_CONTEXT()).  serial/serial.c has to be built with DDS_LATENCY too, for
+ * its interrupts to mark themselves.  Type '?' to get the report; it is cleared after
+ * it has been sent.  Any spread in the latency is jitter in the timing of the
+ * output samples, which is phase noise on the sine wave.
  *
  * This file is free software; you can redistribute it and/or modify
  * it under the terms of either the GNU General Public License version 3
@@ -28,10 +61,16 @@
 #include <avr/io.h>
 #include <stdlib.h>/* for atoi() */
 #include <avr/interrupt.h>
-#include "uart/uart.h"
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+#include "serial/serial.h"
+#include "print/print.h"
 
 /* function prototypes */
 void serialFrequency(void);
+#ifdef DDS_LATENCY
+void latencyReport(void);
+#endif
 
 /* ASCII codes for carriage and line feed */
 #define CR 0x0d
@@ -46,6 +85,46 @@ void serialFrequency(void);
 /* Maximum DDS output frequency that can be manually entered. */
 #define MAX_DDS_FREQ 15000
 
+/* What was running, so late interrupts can be blamed on it: what the main
+   loop is doing, or the interrupt that held the DDS up.  The serial port's
+   interrupts set ddsContext to their own context on the way in and put it
+   back on the way out (see serial/serial.h), and any interrupt added to this
+   program should do the same. */
+#define DDS_CONTEXT_IDLE   0 /* waiting for a character */
+#define DDS_CONTEXT_SERIAL 1 /* handling a received character */
+#define DDS_CONTEXT_FREQ   2 /* setting a new frequency */
+#define DDS_CONTEXT_REPORT 3 /* sending the latency report */
+#define DDS_CONTEXT_RX     SERIAL_CONTEXT_RX   /* serial receive interrupt */
+#define DDS_CONTEXT_UDRE   SERIAL_CONTEXT_UDRE /* serial transmit interrupt */
+#define DDS_CONTEXTS       6
+
+#ifdef DDS_LATENCY
+
+/* Latency histogram, one bin per Timer 2 count.  Latencies in the last bin or
+   beyond all go in the last bin. */
+#define LATENCY_BINS 16
+
+/* A sample is late if its latency is this many counts (0.5us) or more. */
+#ifndef LATENCY_LATE
+#define LATENCY_LATE 6
+#endif
+
+#define DDS_CONTEXT(context) (ddsContext = (context))
+
+volatile uint8_t ddsContext;
+
+/* the measurements, cleared by latencyReport() */
+volatile uint32_t latencyHist[LATENCY_BINS];
+volatile uint8_t latencyWorst[DDS_CONTEXTS];
+volatile uint16_t latencyLate[DDS_CONTEXTS];
+volatile uint16_t latencyMissed;
+
+#else
+
+#define DDS_CONTEXT(context)
+
+#endif /* DDS_LATENCY */
+
 /* Sine table, 256 entries.  Each value represents a voltage level on a
    sinusoidal waveform for one complete cycle.
 
@@ -83,6 +162,17 @@ uint16_t phaseReg, phaseInc;
 ISR(TIMER2_COMPA_vect)
 {
   uint8_t i;
+#ifdef DDS_LATENCY
+  uint8_t latency = TCNT2;/* read it first, before anything else can wait */
+  uint8_t context = ddsContext;
+
+  /* Already another match?  Then the timer has wrapped around, the latency
+     read above is wrong and a sample has been lost. */
+  if(TIFR2 & _BV(OCF2A))
+  {
+    latencyMissed++;
+  }
+#endif
 
   phaseReg += phaseInc;
   i = (uint8_t)(phaseReg >> 8); /* use only the upper 8-bits */
@@ -92,6 +182,20 @@ ISR(TIMER2_COMPA_vect)
   OCR0A = SINE_TABLE[i] & 0b11111100; /* update PWM register */
   PORTC = SINE_TABLE[i] >> 2;/* update R2R ladder */
 
+#ifdef DDS_LATENCY
+  /* record the latency after the output has been updated, so recording it
+     doesn't add to the jitter */
+  latencyHist[(latency < LATENCY_BINS) ? latency : (LATENCY_BINS - 1)]++;
+  if(latency > latencyWorst[context])
+  {
+    latencyWorst[context] = latency;
+  }
+  if(latency >= LATENCY_LATE)
+  {
+    latencyLate[context]++;
+  }
+#endif
+
 }/* end ISR(TIMER2_COMPA_vect) */
 
 /* This is where it all happens. */
@@ -122,7 +226,8 @@ int main(void)
   phaseReg = 0;
   phaseInc = DDS_INIT_FREQ * 65536 / DDS_UPDATE_FREQ;
 
-  uart_init(9600, USART_CHAR_SZ_EIGHT, USART_PARITY_NONE, USART_STOP_BIT_ONE);
+  serial_init(115200);
+  serial_rx_enable();
 
   /* enable the interrupt system */
   sei();
@@ -130,6 +235,7 @@ int main(void)
   /* run around this loop for ever waiting for an interrupt */
   while (1) 
   {
+    DDS_CONTEXT(DDS_CONTEXT_IDLE);
     serialFrequency();/* process characters received from the serial port */
 
   }/* end while(1) */
@@ -156,10 +262,19 @@ void serialFrequency(void)
                         space to store the null terminator */
   static uint8_t i = 0;
 
-  if(uart_available() == UART_AVAILABLE)/* test if a character is waiting */
+  if(serial_available() != 0)/* test if a character is waiting */
   {
-    c = uart_getchar();/* save the character */
-    uart_putchar(c);/* echo it back to the terminal */
+    DDS_CONTEXT(DDS_CONTEXT_SERIAL);
+    c = serial_getchar();/* save the character */
+    serial_putchar(c);/* echo it back to the terminal */
+
+#ifdef DDS_LATENCY
+    if(c == '?')/* send the latency report */
+    {
+      latencyReport();
+      return;
+    }
+#endif
 
     if(((c >= '0') && (c <= '9')) || (c == CR))/* is it a valid character? */
     {
@@ -180,12 +295,20 @@ void serialFrequency(void)
             phaseIncTemp = MAX_DDS_FREQ;/* limit to the maximum value */
           }
 
-          phaseInc = phaseIncTemp * 65536 / DDS_UPDATE_FREQ;/* update DDS phaseInc */
+          /* update DDS phaseInc, with interrupts off so the interrupt never
+             sees half of the old value and half of the new */
+          DDS_CONTEXT(DDS_CONTEXT_FREQ);
+          phaseIncTemp = phaseIncTemp * 65536 / DDS_UPDATE_FREQ;
+          ATOMIC_BLOCK(ATOMIC_FORCEON)
+          {
+            phaseInc = phaseIncTemp;
+          }
+          DDS_CONTEXT(DDS_CONTEXT_SERIAL);
 
           buf[0] = 0;/* reset everything */
           i = 0;
-          uart_putchar(CR);/* move cursor onto beginning of next line */
-          uart_putchar(LF);
+          serial_putchar(CR);/* move cursor onto beginning of next line */
+          serial_putchar(LF);
         }/* end if(i > 0) */
         
       }/* end if((i == 5) || (c == CR)) */
@@ -197,6 +320,68 @@ void serialFrequency(void)
 
     }/* end if(((c >= '0') && (c <= '9')) || (c == 0x0d)) */
 
-  }/* end if(uart_available() == UART_AVAILABLE) */
+  }/* end if(serial_available() != 0) */
 
 }/* end serialFrequency() */
+
+#ifdef DDS_LATENCY
+
+/* latencyReport()
+
+   Send the histogram, then the worst latency and the number of late samples
+   for each context, all in Timer 2 counts of 0.5us.  Each number is copied
+   and cleared with interrupts off, so none of the interrupt's counts are
+   lost, then sent with them on.  The text all comes from flash.
+*/
+void latencyReport(void)
+{
+  static const char contextNames[DDS_CONTEXTS][7] PROGMEM =
+  {
+    "idle  ", "serial", "freq  ", "report", "rx isr", "tx isr"
+  };
+  uint32_t count;
+  uint16_t late, missed;
+  uint8_t bin, worst;
+
+  DDS_CONTEXT(DDS_CONTEXT_REPORT);
+
+  PRINT(&print_serial, PRINT_P("\r\nlatency  samples\r\n"));
+  for(bin = 0; bin < LATENCY_BINS; bin++)
+  {
+    ATOMIC_BLOCK(ATOMIC_FORCEON)
+    {
+      count = latencyHist[bin];
+      latencyHist[bin] = 0;
+    }
+    if(count != 0)
+    {
+      PRINT(&print_serial, PRINT_UDEC(bin, 7),
+            (bin == LATENCY_BINS - 1) ? PRINT_P("+") : PRINT_P(" "),
+            PRINT_UDEC(count, 9), PRINT_P("\r\n"));
+    }
+  }
+
+  PRINT(&print_serial, PRINT_P("context worst  late\r\n"));
+  for(bin = 0; bin < DDS_CONTEXTS; bin++)
+  {
+    ATOMIC_BLOCK(ATOMIC_FORCEON)
+    {
+      worst = latencyWorst[bin];
+      late = latencyLate[bin];
+      latencyWorst[bin] = 0;
+      latencyLate[bin] = 0;
+    }
+    PRINT(&print_serial, (Print_Flash){contextNames[bin]}, PRINT_UDEC(worst, 6),
+          PRINT_UDEC(late, 6), PRINT_P("\r\n"));
+  }
+
+  ATOMIC_BLOCK(ATOMIC_FORCEON)
+  {
+    missed = latencyMissed;
+    latencyMissed = 0;
+  }
+  PRINT(&print_serial, PRINT_P("missed "), missed, PRINT_P("\r\n"));
+
+}/* end latencyReport() */
+
+#endif /* DDS_LATENCY */
@@ -0,0 +1,218 @@
+/*
+ * recorder.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * A triggered recorder for three axis samples.  See recorder.h.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include "recorder.h"
+
+#define RECORDER_MASK (RECORDER_SAMPLES - 1)
+
+/* the circular buffer, and where the next sample goes */
+static int16_t recorderSamples[RECORDER_SAMPLES][3];
+static uint8_t recorderHead;
+
+static uint8_t recorderState = RECORDER_IDLE;
+
+/* the settings from recorder_arm() */
+static uint8_t recorderPre, recorderPost;
+static int16_t recorderThreshold;
+
+/* Samples added since the recorder was armed, it stops counting at pre + 1.
+   Then samples still to come after the trigger. */
+static uint8_t recorderCount;
+static uint8_t recorderRemaining;
+
+/* the capture: its oldest sample in the buffer, the number of samples before
+   the trigger, and its length */
+static uint8_t recorderStart;
+static uint8_t recorderTriggerIndex;
+static uint8_t recorderLength;
+
+/* recorder_fire()
+
+   Trigger on the last sample added.
+*/
+static void recorder_fire(void)
+{
+  recorderTriggerIndex = recorderCount - 1;
+  recorderStart = (recorderHead - recorderCount) & RECORDER_MASK;
+  recorderRemaining = recorderPost - 1;
+
+  if(recorderRemaining == 0)
+  {
+    recorderLength = recorderTriggerIndex + recorderPost;
+    recorderState = RECORDER_DONE;
+  }
+  else
+  {
+    recorderState = RECORDER_TRIGGERED;
+  }
+
+}/* end recorder_fire() */
+
+/* recorder_arm()
+
+   Start waiting for a trigger.
+*/
+void recorder_arm(uint8_t pre, uint8_t post, int16_t threshold)
+{
+  if(post == 0)
+  {
+    post = 1;
+  }
+  if(post > RECORDER_SAMPLES)
+  {
+    post = RECORDER_SAMPLES;
+  }
+  if(pre > RECORDER_SAMPLES - post)
+  {
+    pre = RECORDER_SAMPLES - post;
+  }
+
+  recorderPre = pre;
+  recorderPost = post;
+  recorderThreshold = threshold;
+  recorderCount = 0;
+  recorderLength = 0;
+  recorderTriggerIndex = 0;
+  recorderState = RECORDER_ARMED;
+
+}/* end recorder_arm() */
+
+/* recorder_disarm()
+
+   Stop recording.
+*/
+void recorder_disarm(void)
+{
+  recorderLength = 0;
+  recorderTriggerIndex = 0;
+  recorderState = RECORDER_IDLE;
+
+}/* end recorder_disarm() */
+
+/* recorder_add()
+
+   Add one sample.  The threshold test is skipped when it is 0, and once the
+   recorder has triggered only the count of samples to come is left to do.
+*/
+uint8_t recorder_add(const int16_t *xyz)
+{
+  int16_t *slot;
+  int16_t threshold;
+
+  if((recorderState == RECORDER_IDLE) || (recorderState == RECORDER_DONE))
+  {
+    return(recorderState);
+  }
+
+  slot = recorderSamples[recorderHead];
+  slot[0] = xyz[0];
+  slot[1] = xyz[1];
+  slot[2] = xyz[2];
+  recorderHead = (recorderHead + 1) & RECORDER_MASK;
+
+  if(recorderState == RECORDER_TRIGGERED)
+  {
+    if(--recorderRemaining == 0)
+    {
+      recorderLength = recorderTriggerIndex + recorderPost;
+      recorderState = RECORDER_DONE;
+    }
+    return(recorderState);
+  }
+
+/* armed */
+  if(recorderCount <= recorderPre)
+  {
+    recorderCount++;
+  }
+
+  threshold = recorderThreshold;
+  if(threshold != RECORDER_NO_THRESHOLD)
+  {
+    if((xyz[0] > threshold) || (xyz[0] < -threshold) ||
+       (xyz[1] > threshold) || (xyz[1] < -threshold) ||
+       (xyz[2] > threshold) || (xyz[2] < -threshold))
+    {
+      recorder_fire();
+    }
+  }
+
+  return(recorderState);
+
+}/* end recorder_add() */
+
+/* recorder_add_block()
+
+   Add a block of samples.
+*/
+uint8_t recorder_add_block(const int16_t *xyz, uint8_t count)
+{
+  uint8_t state = recorderState;
+
+  while(count-- && (state != RECORDER_DONE))
+  {
+    state = recorder_add(xyz);
+    xyz += 3;
+  }
+
+  return(state);
+
+}/* end recorder_add_block() */
+
+/* recorder_trigger()
+
+   Trigger on the last sample added.  Nothing happens if no sample has been
+   added since the recorder was armed.
+*/
+void recorder_trigger(void)
+{
+  if((recorderState == RECORDER_ARMED) && (recorderCount != 0))
+  {
+    recorder_fire();
+  }
+
+}/* end recorder_trigger() */
+
+uint8_t recorder_state(void)
+{
+  return(recorderState);
+
+}/* end recorder_state() */
+
+uint8_t recorder_length(void)
+{
+  return(recorderLength);
+
+}/* end recorder_length() */
+
+uint8_t recorder_trigger_index(void)
+{
+  return(recorderTriggerIndex);
+
+}/* end recorder_trigger_index() */
+
+/* recorder_get()
+
+   Copy one sample of the capture.
+*/
+void recorder_get(uint8_t index, int16_t *xyz)
+{
+  const int16_t *slot = recorderSamples[(recorderStart + index) & RECORDER_MASK];
+
+  xyz[0] = slot[0];
+  xyz[1] = slot[1];
+  xyz[2] = slot[2];
+
+}/* end recorder_get() */
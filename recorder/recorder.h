@@ -0,0 +1,115 @@
+/*
+ * recorder.h
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * A triggered recorder for three axis samples, like the single shot mode of
+ * an oscilloscope.  While it is armed every sample goes into a circular
+ * buffer.  When a sample goes over the threshold, or recorder_trigger() is
+ * called, the recorder keeps 'pre' samples from before the trigger, carries
+ * on for 'post' samples including the trigger sample, then stops and holds
+ * the capture until it is armed again.
+ *
+ * The buffer is RECORDER_SAMPLES samples of three int16_t, fixed when the
+ * program is compiled, 768 bytes for the default of 128.  Define
+ * RECORDER_SAMPLES on the compiler command line to change it.  Adding a sample
+ * copies 6 bytes and, while waiting for the trigger, compares each axis with
+ * the threshold; there is no multiply, divide or 32-bit arithmetic.
+ *
+ * The threshold is on the size of each axis, so for an accelerometer it has to
+ * be above 1g or gravity sets it off.  The ADXL345 activity interrupt (see
+ * adxl345_spi_setActivity()) can compare against the change from a reference
+ * instead; when it fires, call recorder_trigger().
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef RECORDER_H_
+#define RECORDER_H_
+
+#include <avr/io.h>
+
+/* size of the buffer in samples, a power of 2 from 2 to 128 */
+#ifndef RECORDER_SAMPLES
+#define RECORDER_SAMPLES 128
+#endif
+
+#if (RECORDER_SAMPLES < 2) || (RECORDER_SAMPLES > 128) || (RECORDER_SAMPLES & (RECORDER_SAMPLES - 1))
+#error "RECORDER_SAMPLES must be a power of 2 from 2 to 128"
+#endif
+
+/* a threshold that never triggers, for recorder_trigger() only */
+#define RECORDER_NO_THRESHOLD 0
+
+/* states, returned by recorder_add() and recorder_state() */
+#define RECORDER_IDLE      0 /* not armed, samples are ignored */
+#define RECORDER_ARMED     1 /* waiting for the trigger */
+#define RECORDER_TRIGGERED 2 /* recording the samples after the trigger */
+#define RECORDER_DONE      3 /* the capture is complete */
+
+/* recorder_arm()
+
+   Start waiting for a trigger.  A sample triggers the recorder if any axis is
+   greater than 'threshold' or less than -'threshold'.  'pre' plus 'post' must
+   not be more than RECORDER_SAMPLES, and 'post' must be at least 1; they are
+   cut down to fit.  If fewer than 'pre' samples have been added when the
+   trigger comes, the capture starts with the first of them.
+*/
+void recorder_arm(uint8_t pre, uint8_t post, int16_t threshold);
+
+/* recorder_disarm()
+
+   Stop recording and throw the capture away.
+*/
+void recorder_disarm(void);
+
+/* recorder_add()
+
+   Add one sample, three int16_t (X, Y, Z).  Returns the state after the
+   sample went in.  Samples added when the state is RECORDER_IDLE or
+   RECORDER_DONE are ignored.
+*/
+uint8_t recorder_add(const int16_t *xyz);
+
+/* recorder_add_block()
+
+   Add 'count' samples, such as a block read from the ADXL345 FIFO, stopping
+   early if the capture completes.  Returns the state.
+*/
+uint8_t recorder_add_block(const int16_t *xyz, uint8_t count);
+
+/* recorder_trigger()
+
+   Trigger on the last sample added, if the recorder is armed.  Call it from
+   the same code that adds the samples, not from an interrupt: let the
+   interrupt set a flag and call recorder_trigger() after adding the samples
+   up to the one that set it off.
+*/
+void recorder_trigger(void);
+
+/* recorder_state()
+
+   Returns RECORDER_IDLE, RECORDER_ARMED, RECORDER_TRIGGERED or RECORDER_DONE.
+*/
+uint8_t recorder_state(void);
+
+/* recorder_length(), recorder_trigger_index()
+
+   The number of samples in the capture, 0 until the state is RECORDER_DONE,
+   and the index of the trigger sample in it, set when the recorder
+   triggers.
+*/
+uint8_t recorder_length(void);
+uint8_t recorder_trigger_index(void);
+
+/* recorder_get()
+
+   Copy sample 'index' of the capture to 'xyz', 0 being the oldest.
+*/
+void recorder_get(uint8_t index, int16_t *xyz);
+
+#endif /* RECORDER_H_ */
@@ -0,0 +1,414 @@
+/*
+ * sensors-ahrs.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * This is an example program that combines the data from three sensors into
+ * an attitude (which way the board is pointing) and displays it on an SPI OLED
+ * display.  The sensors are an accelerometer, a gyroscope and a magnetometer,
+ * the same ones used in sensors-spi.c.  The fusion is done in fixed point
+ * arithmetic 100 times a second, timed by Timer 0, and the attitude is shown
+ * as roll, pitch and yaw in degrees.  Timer 1 counts CPU cycles so the time
+ * taken by each fusion update and by one CORDIC atan2 can be shown on the
+ * display.
+ *
+ * The three sensors must have their X, Y and Z axes lined up, as they are on
+ * the 9 degrees of freedom sensor stick.
+ *
+ * The sensors are calibrated once and the calibration is kept in EEPROM.  To
+ * calibrate, hold the button down while resetting the board, then follow the
+ * prompts at the bottom of the display:
+ *    "still" - leave the board still while the gyro bias is measured
+ *    "turn"  - for 30 seconds, rest the board on each of its six faces in turn
+ *              and, between faces, turn it slowly through every direction
+ * The calibration also runs if the EEPROM doesn't hold one yet.
+ *
+ * The button is connected as follows:
+ *    Arduino 2 (ATMEGA PORTD2) to ground
+ *
+ * The I2C lines are connected as follows:
+ *    SCL - Arduino A5 (ATMEGA PORTC5)
+ *    SDA - Arduino A4 (ATMEGA PORTC4)
+ *
+ * The SPI lines are connected as follows:
+ *    SCK  - Arduino 13 (ATMEGA PORTB5)
+ *    MOSI - Arduino 11 (ATMEGA PORTB3)
+ *    MISO - Arduino 12 (ATMEGA PORTB4)
+ *    CE   - Arduino 10 (ATMEGA PORTB2), display chip select
+ *    DC   - Arduino 9 (ATMEGA PORTB1), display data/command
+ *    CS   - Arduino 8 (ATMEGA PORTB0), accelerometer chip select
+ *
+ * This file is free software; you can redistribute it and/or modify it under
+ * the terms of either the GNU General Public License version 3 or the GNU
+ * Lesser General Public License version 3, both as published by the Free
+ * Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "i2c/i2c.h"
+#include "spi/spi.h"
+#include "adxl345/adxl345_spi.h"
+#include "hmc5883/hmc5883.h"
+#include "itg3205/itg3205.h"
+#include "cordic/cordic.h"
+#include "fmt/fmt.h"
+#include "fusion/fusion.h"
+#include "calib/calib.h"
+#include "display/display.h"
+#include "display/display_spi.h"
+
+/* The fusion update rate in Hz, set by Timer 0. */
+#define FUSION_RATE 100
+
+/* The display is updated once every this many fusion updates (10Hz). */
+#define DISPLAY_DIVIDE 10
+
+/* Sensitivity of the ITG3205 gyro in LSB per degree per second. */
+#define ITG3205_LSB_PER_DPS 14.375
+
+/* Accelerometer reading for 1g at full resolution. */
+#define ADXL345_1G 256
+
+/* Calibration times, in 10ms ticks.  The accelerometer is averaged over
+   blocks of CAL_BLOCK ticks and the block is only used if the gyro says the
+   board was still (every axis below CAL_STILL counts, about 2 degrees/s). */
+#define CAL_GYRO_TICKS 256
+#define CAL_TURN_TICKS 3000
+#define CAL_BLOCK 16
+#define CAL_STILL 30
+
+/* function prototypes */
+void readSensors(int16_t *accel, int16_t *gyro, int16_t *mag);
+void calibrate(Calib_Data *cal);
+void showPrompt(const char *str);
+void waitTick(void);
+
+/* A flag that is set every time Timer 0 times out (10ms).  Make it volatile
+   so the compiler won't optimize it out and it will be visible in the main()
+   function. */
+volatile uint8_t t010msFlag;
+
+/* This is the Timer 0 Compare A interrupt service routine.  Runs every 10ms
+   when the timer times out.  All it does is sets a flag. */
+ISR(TIMER0_COMPA_vect)
+{
+  t010msFlag = 1;
+}
+
+int main(void)
+{
+/* temporary storage for a formatted string */
+  char tempStr[8];
+
+/* sensor data, X, Y and Z */
+  int16_t accelData[3], gyroData[3], magData[3];
+
+/* sensor calibration */
+  Calib_Data calibration;
+
+/* the attitude, roll, pitch and yaw as binary angles */
+  int16_t euler[3];
+
+/* CPU cycles taken by the last fusion update and the last CORDIC call */
+  uint16_t startCount, fusionCycles, cordicCycles;
+
+/* counts fusion updates between display updates */
+  uint8_t displayCount = 0;
+
+/* initialize the I2C bus for the sensors */
+  i2c_init(400000UL);
+
+/* initialize the SPI bus for the display and accelerometer */
+  spi_init((SPI_SPCR_SPE | SPI_SPCR_DORD_MSB | SPI_SPCR_MSTR | SPI_SPCR_MODE3 | SPI_SPCR_DIV2), SPI_SPSR_SPI2X);
+
+/* Initialize the accelerometer.
+
+    power it up
+    set data format to full resolution
+    set data rate to 100Hz, the same as the fusion rate
+ */
+  adxl345_spi_init(&PORTB, PORTB0);
+  adxl345_spi_setDataFormat(ADXL_DATA_FORMAT_FULL_RES | ADXL_DATA_FORMAT_RANGE_02);
+  adxl345_spi_setBWRate(ADXL_BW_RATE_0100);
+  adxl345_spi_setPowerControl(ADXL_POWER_CTL_MEASURE);
+
+/* Initialize the gyroscope.
+ */
+  itg3205_setPowerMgmt(ITG3205_PWR_MGMT_RESET|ITG3205_PWR_MGMT_PLLZ);
+  itg3205_setSampleRate(ITG3205_FS_SEL|ITG3205_DLPF_20HZ);
+
+/* Initialize the magnetometer.
+
+    average = 1, data rate = 15Hz
+    gain = 1.3 Ga
+    speed = normal, mode = continuous
+ */
+  hmc5883_init(HMC5883_AVRG_1|HMC5883_DORT_1500|HMC5883_MESC_NORM,
+               HMC5883_GAIN_092,
+               HMC5883_MODE_NS|HMC5883_MODE_CONT);
+
+/* Start the attitude at level.  Proportional gain 1.6, integral gain 0.15. */
+  fusion_init(FUSION_GYRO_SCALE(ITG3205_LSB_PER_DPS, FUSION_RATE), 6, 16);
+
+/* Initialize the display.
+   Clear the frame buffer, only the parts of it that change are sent.
+ */
+  display_spi_init(&PORTB, PORTB2, &PORTB, PORTB1);
+  display_spi_flip_vertical();
+  display_init();
+  display_set_text_size(2);
+
+/* Draw the labels on the screen, the title in black on a white bar. */
+  display_draw_filled_rectangle(0, 0, 127, 20, DISPLAY_WHITE);
+  display_set_text_colour(DISPLAY_BLACK);
+  display_set_cursor(40, 2);
+  display_putStr("AHRS");
+  display_set_text_colour(DISPLAY_WHITE);
+  display_set_text_size(1);
+  display_set_cursor(0, 27);
+  display_putStr("Rol:");
+  display_set_cursor(0, 37);
+  display_putStr("Pit:");
+  display_set_cursor(0, 47);
+  display_putStr("Yaw:");
+  display_set_cursor(64, 27);
+  display_putStr("Cyc:");
+  display_set_cursor(64, 37);
+  display_putStr("Cor:");
+  display_spi_update();
+
+/* Set up Timer 0 to interrupt every 10ms:
+     - clocked by F_CPU / 1024
+     - generate interrupt when OCR0A matches TCNT0
+     - load OCR0A with the count to get 100Hz
+ */
+  TCCR0A = _BV(WGM01); /* TC0 mode 2, CTC - clear timer on match A */
+  TCCR0B = _BV(CS02) | _BV(CS00); /* clock by F_CPU / 1024 */
+  OCR0A = (F_CPU / 1024 / FUSION_RATE - 1); /* = 155 */
+  TIMSK0 = _BV(OCIE0A); /* enable OCIE0A, match A interrupt */
+
+/* Set up Timer 1 to count CPU cycles, normal mode, no prescale. */
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);
+
+/* enable the interrupt system */
+  sei();
+
+/* The button has a pull up, it reads low if pressed. */
+  PORTD |= _BV(PORTD2);
+
+/* Get the calibration out of EEPROM, work it out if it isn't there or the
+   button is pressed. */
+  if((calib_load(&calibration) != CALIB_OK) || bit_is_clear(PIND, PIND2))
+  {
+    calibrate(&calibration);
+  }
+
+/* Every 10ms read the sensors and update the attitude.  Every 100ms send it
+   to the display. */
+  while(1)
+  {
+    if(t010msFlag == 1) /* test the 10ms flag, is it set? */
+    {
+      t010msFlag = 0; /* reset the flag */
+
+    /* Read and correct the sensors. */
+      readSensors(accelData, gyroData, magData);
+      calib_apply(&calibration.accel, accelData);
+      calib_apply(&calibration.gyro, gyroData);
+      calib_apply(&calibration.mag, magData);
+
+    /* Update the attitude and count how long it took. */
+      startCount = TCNT1;
+      fusion_update(gyroData, accelData, magData);
+      fusionCycles = TCNT1 - startCount;
+
+      if(++displayCount == DISPLAY_DIVIDE)
+      {
+        displayCount = 0;
+
+      /* Format and display the attitude in degrees. */
+        fusion_getEuler(euler);
+
+        display_set_cursor(28, 27);
+        display_putStr(fmt_dec16(CORDIC_DEGREES(euler[0]), 4, tempStr));
+
+        display_set_cursor(28, 37);
+        display_putStr(fmt_dec16(CORDIC_DEGREES(euler[1]), 4, tempStr));
+
+        display_set_cursor(28, 47);
+        display_putStr(fmt_dec16(CORDIC_DEGREES(euler[2]), 4, tempStr));
+
+      /* Time one CORDIC atan2 on the accelerometer data. */
+        startCount = TCNT1;
+        cordic_atan2(accelData[1], accelData[2]);
+        cordicCycles = TCNT1 - startCount;
+
+        display_set_cursor(92, 27);
+        display_putStr(fmt_udec16(fusionCycles, 5, tempStr));
+
+        display_set_cursor(92, 37);
+        display_putStr(fmt_udec16(cordicCycles, 5, tempStr));
+
+      /* Everything is written to the frame buffer, now start sending the
+         changes to the display.  It goes out in the background, so the next
+         10ms tick isn't held up. */
+        display_spi_start();
+
+      }/* end if(++displayCount == DISPLAY_DIVIDE) */
+
+    }/* end if(t010msFlag == 1) */
+
+  }/* end while(1) */
+
+}/* end main() */
+
+/* readSensors()
+
+   Read the three sensors into 'accel', 'gyro' and 'mag', X, Y and Z.
+*/
+void readSensors(int16_t *accel, int16_t *gyro, int16_t *mag)
+{
+/* temporary storage for raw data read from a sensor, two bytes per axis  */
+  uint8_t sensorBuf[6];
+
+/* Read the accelerometer. */
+  adxl345_spi_getAccelData(sensorBuf);
+  accel[0] = (int16_t)sensorBuf[1] << 8;
+  accel[0] += (int16_t)sensorBuf[0];
+  accel[1] = (int16_t)sensorBuf[3] << 8;
+  accel[1] += (int16_t)sensorBuf[2];
+  accel[2] = (int16_t)sensorBuf[5] << 8;
+  accel[2] += (int16_t)sensorBuf[4];
+
+/* Read the gyroscope. */
+  itg3205_getGyroData(sensorBuf);
+  gyro[0] = (int16_t)sensorBuf[1] << 8;
+  gyro[0] += (int16_t)sensorBuf[0];
+  gyro[1] = (int16_t)sensorBuf[3] << 8;
+  gyro[1] += (int16_t)sensorBuf[2];
+  gyro[2] = (int16_t)sensorBuf[5] << 8;
+  gyro[2] += (int16_t)sensorBuf[4];
+
+/* Read the magnetometer.  The data for each axis is read MSB first, and the
+   axes come out in the order X, Z, Y. */
+  hmc5883_getMagData(sensorBuf);
+  mag[0] = (int16_t)sensorBuf[0] << 8;
+  mag[0] += (int16_t)sensorBuf[1];
+  mag[2] = (int16_t)sensorBuf[2] << 8;
+  mag[2] += (int16_t)sensorBuf[3];
+  mag[1] = (int16_t)sensorBuf[4] << 8;
+  mag[1] += (int16_t)sensorBuf[5];
+
+}/* end readSensors() */
+
+/* calibrate()
+
+   Work out the sensor calibration and save it in EEPROM.  First the gyro bias
+   is averaged with the board still.  Then the board is turned onto each of its
+   six faces, which gives the accelerometer +1g and -1g on every axis, and
+   through every direction, which gives the extremes of the magnetic field on
+   every axis.  If the accelerometer or magnetometer didn't see enough of a
+   range, its old calibration is kept.
+*/
+void calibrate(Calib_Data *cal)
+{
+  int16_t accelData[3], gyroData[3], magData[3];
+  Calib_Mean gyroMean, accelBlock;
+  Calib_MinMax accelMinMax, magMinMax;
+  char tempStr[8];
+  uint16_t tick;
+  uint8_t still = 1;
+  uint8_t i;
+
+/* gyro bias, the board must be still */
+  showPrompt("Cal: still");
+  calib_mean_start(&gyroMean);
+  for(tick = 0; tick < CAL_GYRO_TICKS; tick++)
+  {
+    waitTick();
+    readSensors(accelData, gyroData, magData);
+    calib_mean_add(&gyroMean, gyroData);
+  }
+  calib_mean_finish(&gyroMean, &cal->gyro);
+
+/* six faces and every direction */
+  showPrompt("Cal: turn");
+  calib_minmax_start(&accelMinMax);
+  calib_minmax_start(&magMinMax);
+  calib_mean_start(&accelBlock);
+  for(tick = 0; tick < CAL_TURN_TICKS; tick++)
+  {
+    waitTick();
+    readSensors(accelData, gyroData, magData);
+    calib_apply(&cal->gyro, gyroData);
+
+    calib_minmax_add(&magMinMax, magData);
+
+  /* average the accelerometer, noting if the board moved */
+    calib_mean_add(&accelBlock, accelData);
+    for(i = 0; i < 3; i++)
+    {
+      if((gyroData[i] > CAL_STILL) || (gyroData[i] < -CAL_STILL))
+      {
+        still = 0;
+      }
+    }
+
+    if(accelBlock.count == CAL_BLOCK)
+    {
+      if(still)
+      {
+        for(i = 0; i < 3; i++)
+        {
+          accelData[i] = (int16_t)(accelBlock.sum[i] / CAL_BLOCK);
+        }
+        calib_minmax_add(&accelMinMax, accelData);
+      }
+      calib_mean_start(&accelBlock);
+      still = 1;
+    }
+
+  /* count down the seconds */
+    if((tick % 100) == 0)
+    {
+      display_set_cursor(64, 57);
+      display_putStr(fmt_udec16((CAL_TURN_TICKS - tick) / 100, 2, tempStr));
+      display_spi_update();
+    }
+  }
+
+  calib_minmax_finish(&accelMinMax, ADXL345_1G, &cal->accel);
+  calib_minmax_finish(&magMinMax, 0, &cal->mag);
+
+  calib_save(cal);
+  showPrompt("Cal: saved");
+
+}/* end calibrate() */
+
+/* showPrompt()
+
+   Write a calibration prompt across the whole bottom line of the display.
+*/
+void showPrompt(const char *str)
+{
+  display_set_cursor(0, 57);
+  display_putField(str, 21);
+  display_spi_update();
+
+}/* end showPrompt() */
+
+/* waitTick()
+
+   Wait for the next 10ms tick from Timer 0.
+*/
+void waitTick(void)
+{
+  while(t010msFlag == 0)
+  {
+  }
+  t010msFlag = 0;
+
+}/* end waitTick() */
@@ -0,0 +1,165 @@
+/*
+ * sensors-chart.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * A vibration monitor.  The total acceleration from the accelerometer is
+ * plotted on a strip chart across the bottom five pages of the display (see
+ * display/display_chart.h), with the newest reading and the peak to peak
+ * value over the chart in mg above it.
+ *
+ * The accelerometer runs at 3200Hz and is decimated to 200 samples a second.
+ * Each column of the chart shows the smallest and largest of 8 samples, so
+ * the chart moves 25 columns a second and holds the last 5 seconds.  Adding a
+ * column sends 19 bytes to the display.  The text is drawn from a display
+ * list a page at a time, so there is no frame buffer, and only its page is
+ * sent, twice a second.
+ *
+ * The wiring is the same as sensors-spi.c, only the accelerometer and the
+ * display are used.
+ *
+ * The SPI lines are connected as follows:
+ *    SCK  - Arduino 13 (ATMEGA PORTB5)
+ *    MOSI - Arduino 11 (ATMEGA PORTB3)
+ *    MISO - Arduino 12 (ATMEGA PORTB4)
+ *    CE   - Arduino 10 (ATMEGA PORTB2), display chip select
+ *    DC   - Arduino 9 (ATMEGA PORTB1), display data/command
+ *    CS   - Arduino 8 (ATMEGA PORTB0), accelerometer chip select
+ *
+ * This file is free software; you can redistribute it and/or modify it under
+ * the terms of either the GNU General Public License version 3 or the GNU
+ * Lesser General Public License version 3, both as published by the Free
+ * Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include "spi/spi.h"
+#include "adxl345/adxl345_spi.h"
+#include "cordic/cordic.h"
+#include "fmt/fmt.h"
+#include "decimate/decimate.h"
+#include "display/display.h"
+#include "display/display_spi.h"
+#include "display/display_list.h"
+#include "display/display_chart.h"
+
+/* Decimation ratio as a power of 2, 3200Hz / 16 gives 200 samples a
+   second. */
+#define ACCEL_DECIMATE_SHIFT 4
+
+/* samples in each column of the chart, 200 / 8 = 25 columns a second */
+#define CHART_SAMPLES 8
+
+/* columns between updates of the text, about twice a second */
+#define TEXT_COLUMNS 12
+
+/* the chart takes the bottom five pages, the text is on the page above */
+#define CHART_PAGE0 3
+#define CHART_PAGE1 7
+#define TEXT_PAGE   2
+
+/* the strings the display list points at */
+static char mgStr[6], peakStr[6];
+
+/* the chart, too big for the stack */
+static Display_Chart chart;
+
+int main(void)
+{
+/* the page being drawn from the display list */
+  uint8_t pageBuf[DISPLAY_WIDTH];
+
+/* samples drained from the accelerometer FIFO, three axes per sample */
+  int16_t accelFifo[ADXL_FIFO_SIZE * 3];
+  int16_t accelData[3];
+  uint8_t accelCount, i;
+
+/* the total acceleration and the extremes on the chart */
+  int16_t magnitude = 0, chartMin, chartMax;
+
+/* columns added since the text was last sent */
+  uint8_t textCount = 0;
+
+/* decimation filter state */
+  Decimate_Cic accelFilter;
+
+/* Initialize the SPI bus.  The display and the accelerometer share it, each
+   registers its own settings with spibus so the bus can be switched between
+   them. */
+  spi_init((SPI_SPCR_SPE | SPI_SPCR_DORD_MSB | SPI_SPCR_MSTR | SPI_SPCR_MODE3 | SPI_SPCR_DIV2), SPI_SPSR_SPI2X);
+
+/* Initialize the accelerometer.
+
+    power it up
+    set data format to full resolution and +/-2g, plenty for a board held
+    in the hand
+    set data rate to 3200Hz
+    FIFO in stream mode, it keeps the newest 32 samples (10ms)
+ */
+  adxl345_spi_init(&PORTB, PORTB0);
+  adxl345_spi_setDataFormat(ADXL_DATA_FORMAT_FULL_RES | ADXL_DATA_FORMAT_RANGE_02);
+  adxl345_spi_setBWRate(ADXL_BW_RATE_3200);
+  adxl345_spi_setFifoControl(ADXL_FIFO_CTL_STREAM);
+  adxl345_spi_setPowerControl(ADXL_POWER_CTL_MEASURE);
+
+/* Initialize the display.  There is no frame buffer to set up. */
+  display_spi_init(&PORTB, PORTB2, &PORTB, PORTB1);
+  display_spi_flip_vertical();
+
+/* Describe the text: the title in black on a white bar, and the readings. */
+  display_list_add_rect(0, 0, 127, 15, DISPLAY_WHITE);
+  display_list_add_text_P(10, 0, 2, DISPLAY_BLACK, PSTR("VIBRATION"));
+  display_list_add_text_P(0, 16, 1, DISPLAY_WHITE, PSTR("mg:"));
+  display_list_add_text(18, 16, 1, DISPLAY_WHITE, mgStr);
+  display_list_add_text_P(64, 16, 1, DISPLAY_WHITE, PSTR("p-p:"));
+  display_list_add_text(88, 16, 1, DISPLAY_WHITE, peakStr);
+
+/* Send the pages above the chart, then set up the chart, which clears its
+   pages. */
+  for(i = 0; i < CHART_PAGE0; i++)
+  {
+    display_list_render_page(i, pageBuf);
+    display_spi_write_page(i, pageBuf);
+  }
+  display_chart_init(&chart, 0, DISPLAY_MAX_X, CHART_PAGE0, CHART_PAGE1, CHART_SAMPLES,
+                     display_spi_send_commands, display_spi_send_data);
+
+  decimate_cic_init(&accelFilter, ACCEL_DECIMATE_SHIFT);
+
+/* Repeatedly empty the accelerometer FIFO and plot every decimated sample. */
+  while(1)
+  {
+    accelCount = adxl345_spi_readFifo(accelFifo, ADXL_FIFO_SIZE);
+    for(i = 0; i < accelCount; i++)
+    {
+      if(decimate_cic_add(&accelFilter, &accelFifo[i * 3], accelData) == DECIMATE_BUSY)
+      {
+        continue;
+      }
+
+      magnitude = cordic_magnitude3(accelData[0], accelData[1], accelData[2]);
+      if(display_chart_add(&chart, magnitude) == 0)
+      {
+        continue;
+      }
+
+    /* A column went on the chart, now and again update the text.  The peak
+       to peak value is over the whole chart. */
+      if(++textCount == TEXT_COLUMNS)
+      {
+        textCount = 0;
+
+        display_chart_get_extremes(&chart, &chartMin, &chartMax);
+        fmt_dec16(fmt_scale(magnitude, FMT_SCALE_ADXL345_MG), 5, mgStr);
+        fmt_dec16(fmt_scale(chartMax - chartMin, FMT_SCALE_ADXL345_MG), 5, peakStr);
+
+        display_list_render_page(TEXT_PAGE, pageBuf);
+        display_spi_write_page(TEXT_PAGE, pageBuf);
+      }
+    }
+
+  }/* end while(1) */
+
+}/* end main() */
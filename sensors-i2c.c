@@ -10,6 +10,11 @@
  * communicates on the I2C bus.  The OLED display also communicates on the I2C
  * bus.
  *
+ * Built with PROFILE defined, the stages of the loop are timed (see
+ * profile/profile.h).  Every 64 loops the loops per second and the slowest
+ * stage replace the title, and the table of stages is sent out of the serial
+ * port (Arduino 1, ATMEGA PORTD1) at 115200 baud.
+ *
  * The I2C lines are connected as follows:
  *    SCL - Arduino A5 (ATMEGA PORTC5)
  *    SDA - Arduino A4 (ATMEGA PORTC4)
@@ -21,30 +26,59 @@
  */ 
 
 #include <avr/io.h>
-#include <stdlib.h>
 #include "i2c/i2c.h"
 #include "adxl345/adxl345.h"
 #include "hmc5883/hmc5883.h"
 #include "itg3205/itg3205.h"
-#include "graphics/graphics.h"
-#include "ssd1306/ssd1306_i2c.h"
+#include "cordic/cordic.h"
+#include "compass/compass.h"
+#include "fmt/fmt.h"
+#include "display/display.h"
+#include "display/display_i2c.h"
+#include "display/display_field.h"
+#include "profile/profile.h"
+#ifdef PROFILE
+#include <avr/interrupt.h>
+#include "serial/serial.h"
+#include "print/print.h"
+#endif
+
+/* The stages of the main loop timed when PROFILE is defined (see
+   profile/profile.h), and how many loops between reports. */
+#define STAGE_READ   0
+#define STAGE_MATH   1
+#define STAGE_FIELDS 2
+#define STAGE_UPDATE 3
+#define STAGE_REPORT 4
 
-/* These define the string formatting for the itoa() function. */
-#define HEX_FORMAT 16
-#define DEC_FORMAT 10
-#define OCT_FORMAT 8
+#define PROFILE_REPORT_LOOPS 64
 
 int main(void)
 {
 /* temporary storage for raw data read from a sensor, two bytes per axis  */
   uint8_t sensorBuf[6];
   
-/* temporary storage for a formatted string from itoa() */
-  char tempStr[8];
+/* the fields showing the data, each is only redrawn when its value
+   changes */
+  Display_Field accelField[3], gyroField[3], magField[3];
+  Display_Field headingField, mgField;
+  uint8_t i;
 
 /* temporary storage for 16-bit raw sensor data */
   int16_t sensorXData, sensorYData, sensorZData;
 
+/* the accelerometer and magnetometer data, X, Y and Z, kept for working out
+   the heading */
+  int16_t accelData[3], magData[3];
+
+/* the gyroscope data, and what is worked out from the other two */
+  int16_t gyroData[3];
+  int16_t heading, magnitude;
+
+#ifdef PROFILE
+  uint8_t profileLoops = 0;
+#endif
+
 /* initialize and start up the I2C system */
   i2c_init(400000UL);
 
@@ -74,31 +108,60 @@ int main(void)
                HMC5883_MODE_NS|HMC5883_MODE_CONT);
 
 /* Initialize the display.
-   Setup the display in graphics mode.
+   Clear the frame buffer, only the parts of it that change are sent.
  */
-  ssd1306_i2c_init();
-  ssd1306_i2c_flip_vertical();
-  graphics_init(SSD1306_GRAPHICS_MAX_X, SSD1306_GRAPHICS_MAX_Y);
-  graphics_set_text_size(2);
-  graphics_set_rotation(GRAPHICS_ROTATION_0);
-
-/* Draw the labels on the screen. */
-  graphics_draw_filled_rectangle(0, 0, 127, 20);
-  graphics_set_cursor(21, 2);
-  graphics_putStr("SENSORS");
-  graphics_set_text_size(1);
-  graphics_set_cursor(0, 27);
-  graphics_putStr("Acc:");
-  graphics_set_cursor(0, 37);
-  graphics_putStr("Gyr:");
-  graphics_set_cursor(0, 47);
-  graphics_putStr("Mag:");
-  ssd1306_i2c_graphics_update();
+  display_i2c_init();
+  display_i2c_flip_vertical();
+  display_init();
+  display_set_text_size(2);
+
+/* Draw the labels on the screen, the title in black on a white bar. */
+  display_draw_filled_rectangle(0, 0, 127, 20, DISPLAY_WHITE);
+  display_set_text_colour(DISPLAY_BLACK);
+  display_set_cursor(21, 2);
+  display_putStr("SENSORS");
+  display_set_text_colour(DISPLAY_WHITE);
+  display_set_text_size(1);
+  display_set_cursor(0, 27);
+  display_putStr("Acc:");
+  display_set_cursor(0, 37);
+  display_putStr("Gyr:");
+  display_set_cursor(0, 47);
+  display_putStr("Mag:");
+  display_set_cursor(0, 57);
+  display_putStr("Hdg:");
+  display_set_cursor(64, 57);
+  display_putStr("mg:");
+  display_i2c_update();
+
+/* Set up the fields for the data, three to a row. */
+  for(i = 0; i < 3; i++)
+  {
+    display_field_init(&accelField[i], 28 + 36 * i, 27, 4, DISPLAY_FIELD_HEX, DISPLAY_FIELD_NO_SCALE);
+    display_field_init(&gyroField[i], 28 + 36 * i, 37, 4, DISPLAY_FIELD_HEX, DISPLAY_FIELD_NO_SCALE);
+    display_field_init(&magField[i], 28 + 36 * i, 47, 4, DISPLAY_FIELD_HEX, DISPLAY_FIELD_NO_SCALE);
+  }
+  display_field_init(&headingField, 28, 57, 3, DISPLAY_FIELD_UDEC, DISPLAY_FIELD_NO_SCALE);
+  display_field_init(&mgField, 88, 57, 5, DISPLAY_FIELD_DEC, FMT_SCALE_ADXL345_MG);
+
+/* Start timing the stages of the loop.  The table goes out of the serial
+   port, which needs interrupts. */
+#ifdef PROFILE
+  serial_init(115200);
+  sei();
+#endif
+  PROFILE_INIT();
+  PROFILE_NAME(STAGE_READ, "read");
+  PROFILE_NAME(STAGE_MATH, "math");
+  PROFILE_NAME(STAGE_FIELDS, "fields");
+  PROFILE_NAME(STAGE_UPDATE, "update");
+  PROFILE_NAME(STAGE_REPORT, "report");
+  PROFILE_START();
 
 /* Repeatedly read the sensors and send the data to the display. */
   while(1) 
   {
-  /* Read the accelerometer, format and display the data. */
+  /* Read the accelerometer. */
     adxl345_getAccelData(sensorBuf);
     sensorXData = (int16_t)sensorBuf[1] << 8;
     sensorXData += (int16_t)sensorBuf[0];
@@ -106,20 +169,11 @@ int main(void)
     sensorYData += (int16_t)sensorBuf[2];
     sensorZData = (int16_t)sensorBuf[5] << 8;
     sensorZData += (int16_t)sensorBuf[4];
+    accelData[0] = sensorXData;
+    accelData[1] = sensorYData;
+    accelData[2] = sensorZData;
 
-    graphics_set_cursor(28, 27);
-    itoa(sensorXData, tempStr, HEX_FORMAT);
-    graphics_putStr(tempStr);
-
-    graphics_set_cursor(64, 27);
-    itoa(sensorYData, tempStr, HEX_FORMAT);
-    graphics_putStr(tempStr);
-
-    graphics_set_cursor(100, 27);
-    itoa(sensorZData, tempStr, HEX_FORMAT);
-    graphics_putStr(tempStr);
-
-  /* Read the gyroscope, format and display the data. */
+  /* Read the gyroscope. */
     itg3205_getGyroData(sensorBuf);
     sensorXData = (int16_t)sensorBuf[1] << 8;
     sensorXData += (int16_t)sensorBuf[0];
@@ -127,21 +181,11 @@ int main(void)
     sensorYData += (int16_t)sensorBuf[2];
     sensorZData = (int16_t)sensorBuf[5] << 8;
     sensorZData += (int16_t)sensorBuf[4];
+    gyroData[0] = sensorXData;
+    gyroData[1] = sensorYData;
+    gyroData[2] = sensorZData;
 
-    graphics_set_cursor(28, 37);
-    itoa(sensorXData, tempStr, HEX_FORMAT);
-    graphics_putStr(tempStr);
-
-    graphics_set_cursor(64, 37);
-    itoa(sensorYData, tempStr, HEX_FORMAT);
-    graphics_putStr(tempStr);
-
-    graphics_set_cursor(100, 37);
-    itoa(sensorZData, tempStr, HEX_FORMAT);
-    graphics_putStr(tempStr);
-
-  /* Read the magnetometer, format and display the data.  The data for each axis
-     is read MSB first. */
+  /* Read the magnetometer.  The data for each axis is read MSB first. */
     hmc5883_getMagData(sensorBuf);
     sensorXData = (int16_t)sensorBuf[1];
     sensorXData += (int16_t)sensorBuf[0] << 8;
@@ -150,20 +194,62 @@ int main(void)
     sensorZData = (int16_t)sensorBuf[5];
     sensorZData += (int16_t)sensorBuf[4] << 8;
 
-    graphics_set_cursor(28, 47);
-    itoa(sensorXData, tempStr, HEX_FORMAT);
-    graphics_putStr(tempStr);
+  /* The HMC5883 sends its axes in the order X, Z, Y, so sensorYData is really
+     the Z axis. */
+    magData[0] = sensorXData;
+    magData[1] = sensorZData;
+    magData[2] = sensorYData;
+
+    PROFILE_LAP(STAGE_READ);
+
+  /* Work out the tilt compensated heading in degrees and the total
+     acceleration in mg (3.9mg per count at full resolution). */
+    heading = COMPASS_DEGREES(compass_heading(accelData, magData));
+    magnitude = cordic_magnitude3(accelData[0], accelData[1], accelData[2]);
+
+    PROFILE_LAP(STAGE_MATH);
+
+  /* Format and draw the data.  The magnetometer fields are in the order the
+     chip sends them. */
+    for(i = 0; i < 3; i++)
+    {
+      display_field_set(&accelField[i], accelData[i]);
+      display_field_set(&gyroField[i], gyroData[i]);
+    }
+    display_field_set(&magField[0], sensorXData);
+    display_field_set(&magField[1], sensorYData);
+    display_field_set(&magField[2], sensorZData);
+    display_field_set(&headingField, heading);
+    display_field_set(&mgField, magnitude);
+
+    PROFILE_LAP(STAGE_FIELDS);
+
+  /* everything is written to the frame buffer, now send the changes to the
+     display, nothing at all if no field changed */
+    display_i2c_update();
+
+    PROFILE_LAP(STAGE_UPDATE);
+
+#ifdef PROFILE
+  /* Now and again show the loops per second and the slowest stage in the
+     title bar, and send the whole table down the serial port.  The overlay
+     goes out to the display with the next update. */
+    if(++profileLoops == PROFILE_REPORT_LOOPS)
+    {
+      profileLoops = 0;
 
-    graphics_set_cursor(64, 47);
-    itoa(sensorYData, tempStr, HEX_FORMAT);
-    graphics_putStr(tempStr);
+      display_draw_filled_rectangle(0, 0, 127, 20, DISPLAY_WHITE);
+      display_set_text_colour(DISPLAY_BLACK);
+      display_set_cursor(2, 7);
+      PROFILE_SUMMARY(&print_display);
+      display_set_text_colour(DISPLAY_WHITE);
 
-    graphics_set_cursor(100, 47);
-    itoa(sensorZData, tempStr, HEX_FORMAT);
-    graphics_putStr(tempStr);
+      PROFILE_PRINT(&print_serial);
+      PROFILE_RESET();
+    }
 
-  /* everything is written to the graphics RAM, now send it to the display */
-    ssd1306_i2c_graphics_update();
+    PROFILE_LAP(STAGE_REPORT);
+#endif
 
   }/* end while(1) */
 
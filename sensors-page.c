@@ -0,0 +1,207 @@
+/*
+ * sensors-page.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * The same sensors screen as sensors-spi.c, drawn without a frame buffer.
+ * The screen is described once as a list of rectangles and text (see
+ * display/display_list.h).  The text items point at the strings below, so
+ * each update just rewrites the strings, then draws the screen one 128 byte
+ * page at a time and sends each page as soon as it is drawn.
+ *
+ * A frame buffer would take 1024 of the ATmega328's 2048 bytes of RAM.  The
+ * list and the page buffer take 288, which leaves room for the 192 byte
+ * accelerometer FIFO buffer and the decimation filters.  Since every page is
+ * drawn from scratch, a number that gets shorter leaves no old digits behind.
+ * Link display_spi.c, display_ssd1306.c and display_list.c, not display.c or
+ * display_spi_frame.c, which hold the frame buffer and the code that sends it.
+ *
+ * The wiring is the same as sensors-spi.c.
+ *
+ * The I2C lines are connected as follows:
+ *    SCL - Arduino A5 (ATMEGA PORTC5)
+ *    SDA - Arduino A4 (ATMEGA PORTC4)
+ *
+ * The SPI lines are connected as follows:
+ *    SCK  - Arduino 13 (ATMEGA PORTB5)
+ *    MOSI - Arduino 11 (ATMEGA PORTB3)
+ *    MISO - Arduino 12 (ATMEGA PORTB4)
+ *    CE   - Arduino 10 (ATMEGA PORTB2), display chip select
+ *    DC   - Arduino 9 (ATMEGA PORTB1), display data/command
+ *    CS   - Arduino 8 (ATMEGA PORTB0), accelerometer chip select
+ *
+ * This file is free software; you can redistribute it and/or modify it under
+ * the terms of either the GNU General Public License version 3 or the GNU
+ * Lesser General Public License version 3, both as published by the Free
+ * Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include "i2c/i2c.h"
+#include "spi/spi.h"
+#include "adxl345/adxl345_spi.h"
+#include "hmc5883/hmc5883.h"
+#include "itg3205/itg3205.h"
+#include "cordic/cordic.h"
+#include "compass/compass.h"
+#include "fmt/fmt.h"
+#include "decimate/decimate.h"
+#include "display/display.h"
+#include "display/display_spi.h"
+#include "display/display_list.h"
+
+/* Decimation ratios, as powers of 2.  3200Hz / 64 gives 50 display updates per
+   second. */
+#define ACCEL_DECIMATE_SHIFT 6
+#define GYRO_DECIMATE_SHIFT 4
+
+/* the strings the display list points at, one per number on the screen */
+static char accelStr[3][5], gyroStr[3][5], magStr[3][5];
+static char headingStr[4], mgStr[6];
+
+int main(void)
+{
+/* temporary storage for raw data read from a sensor, two bytes per axis  */
+  uint8_t sensorBuf[6];
+
+/* the accelerometer, gyroscope and magnetometer data, X, Y and Z */
+  int16_t accelData[3] = {0, 0, 0}, gyroData[3] = {0, 0, 0}, magData[3];
+  int16_t gyroRaw[3];
+
+/* samples drained from the accelerometer FIFO, three axes per sample */
+  int16_t accelFifo[ADXL_FIFO_SIZE * 3];
+  uint8_t accelCount, accelReady, i;
+
+/* decimation filter state */
+  Decimate_Cic accelFilter;
+  Decimate_Avg gyroFilter;
+
+/* initialize the I2C bus for the sensors */
+  i2c_init(400000UL);
+
+/* Initialize the SPI bus for the display.  The display and the accelerometer
+   share the bus, each registers its own settings with spibus so the bus can
+   be switched between them. */
+  spi_init((SPI_SPCR_SPE | SPI_SPCR_DORD_MSB | SPI_SPCR_MSTR | SPI_SPCR_MODE3 | SPI_SPCR_DIV2), SPI_SPSR_SPI2X);
+
+/* Initialize the accelerometer.
+
+    power it up
+    set data format to full resolution and +/-2g, plenty for a board held
+    in the hand
+    set data rate to 3200Hz
+    FIFO in stream mode, it keeps the newest 32 samples (10ms)
+ */
+  adxl345_spi_init(&PORTB, PORTB0);
+  adxl345_spi_setDataFormat(ADXL_DATA_FORMAT_FULL_RES | ADXL_DATA_FORMAT_RANGE_02);
+  adxl345_spi_setBWRate(ADXL_BW_RATE_3200);
+  adxl345_spi_setFifoControl(ADXL_FIFO_CTL_STREAM);
+  adxl345_spi_setPowerControl(ADXL_POWER_CTL_MEASURE);
+
+/* Initialize the gyroscope.
+ */
+  itg3205_setPowerMgmt(ITG3205_PWR_MGMT_RESET|ITG3205_PWR_MGMT_PLLZ);
+  itg3205_setSampleRate(ITG3205_FS_SEL|ITG3205_DLPF_20HZ);
+
+/* Initialize the magnetometer.
+
+    average = 1, data rate = 15Hz
+    gain = 1.3 Ga
+    speed = normal, mode = continuous
+ */
+  hmc5883_init(HMC5883_AVRG_1|HMC5883_DORT_1500|HMC5883_MESC_NORM,
+               HMC5883_GAIN_092,
+               HMC5883_MODE_NS|HMC5883_MODE_CONT);
+
+/* Initialize the display.  There is no frame buffer to set up. */
+  display_spi_init(&PORTB, PORTB2, &PORTB, PORTB1);
+  display_spi_flip_vertical();
+
+/* Describe the screen: the title in black on a white bar, the labels, and
+   a text item for each number. */
+  display_list_add_rect(0, 0, 127, 20, DISPLAY_WHITE);
+  display_list_add_text_P(21, 2, 2, DISPLAY_BLACK, PSTR("SENSORS"));
+  display_list_add_text_P(0, 27, 1, DISPLAY_WHITE, PSTR("Acc:"));
+  display_list_add_text_P(0, 37, 1, DISPLAY_WHITE, PSTR("Gyr:"));
+  display_list_add_text_P(0, 47, 1, DISPLAY_WHITE, PSTR("Mag:"));
+  display_list_add_text_P(0, 57, 1, DISPLAY_WHITE, PSTR("Hdg:"));
+  display_list_add_text_P(64, 57, 1, DISPLAY_WHITE, PSTR("mg:"));
+  for(i = 0; i < 3; i++)
+  {
+    display_list_add_text(28 + i * 36, 27, 1, DISPLAY_WHITE, accelStr[i]);
+    display_list_add_text(28 + i * 36, 37, 1, DISPLAY_WHITE, gyroStr[i]);
+    display_list_add_text(28 + i * 36, 47, 1, DISPLAY_WHITE, magStr[i]);
+  }
+  display_list_add_text(28, 57, 1, DISPLAY_WHITE, headingStr);
+  display_list_add_text(88, 57, 1, DISPLAY_WHITE, mgStr);
+
+  decimate_cic_init(&accelFilter, ACCEL_DECIMATE_SHIFT);
+  decimate_avg_init(&gyroFilter, GYRO_DECIMATE_SHIFT);
+
+/* Repeatedly read the sensors and send the data to the display. */
+  while(1)
+  {
+  /* Read the gyroscope into its decimation filter. */
+    itg3205_getGyroData(sensorBuf);
+    gyroRaw[0] = (int16_t)sensorBuf[1] << 8;
+    gyroRaw[0] += (int16_t)sensorBuf[0];
+    gyroRaw[1] = (int16_t)sensorBuf[3] << 8;
+    gyroRaw[1] += (int16_t)sensorBuf[2];
+    gyroRaw[2] = (int16_t)sensorBuf[5] << 8;
+    gyroRaw[2] += (int16_t)sensorBuf[4];
+    decimate_avg_add(&gyroFilter, gyroRaw, gyroData);
+
+  /* Empty the accelerometer FIFO into its decimation filter. */
+    accelReady = DECIMATE_BUSY;
+    accelCount = adxl345_spi_readFifo(accelFifo, ADXL_FIFO_SIZE);
+    for(i = 0; i < accelCount; i++)
+    {
+      if(decimate_cic_add(&accelFilter, &accelFifo[i * 3], accelData) == DECIMATE_READY)
+      {
+        accelReady = DECIMATE_READY;
+      }
+    }
+
+  /* Only update the display when a new accelerometer output is ready. */
+    if(accelReady == DECIMATE_BUSY)
+    {
+      continue;
+    }
+
+  /* Read the magnetometer.  The data for each axis is read MSB first, and the
+     axes come out in the order X, Z, Y. */
+    hmc5883_getMagData(sensorBuf);
+    magData[0] = (int16_t)sensorBuf[0] << 8;
+    magData[0] += (int16_t)sensorBuf[1];
+    magData[2] = (int16_t)sensorBuf[2] << 8;
+    magData[2] += (int16_t)sensorBuf[3];
+    magData[1] = (int16_t)sensorBuf[4] << 8;
+    magData[1] += (int16_t)sensorBuf[5];
+
+  /* Format the data into the strings.  The magnetometer is shown in the order
+     it is sent, X, Z, Y, the same as sensors-spi.c. */
+    for(i = 0; i < 3; i++)
+    {
+      fmt_hex16(accelData[i], accelStr[i]);
+      fmt_hex16(gyroData[i], gyroStr[i]);
+    }
+    fmt_hex16(magData[0], magStr[0]);
+    fmt_hex16(magData[2], magStr[1]);
+    fmt_hex16(magData[1], magStr[2]);
+
+  /* the tilt compensated heading in degrees and the total acceleration in mg
+     (3.9mg per count at full resolution) */
+    fmt_udec16(COMPASS_DEGREES(compass_heading(accelData, magData)), 3, headingStr);
+    fmt_dec16(fmt_scale(cordic_magnitude3(accelData[0], accelData[1], accelData[2]),
+                        FMT_SCALE_ADXL345_MG), 5, mgStr);
+
+  /* Draw and send the screen a page at a time.  Sending takes about 1.5ms at
+     F_CPU/2 and drawing a few more, still well inside the 10ms the
+     accelerometer FIFO holds. */
+    display_list_send(display_spi_write_page);
+
+  }/* end while(1) */
+
+}/* end main() */
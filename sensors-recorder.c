@@ -0,0 +1,284 @@
+/*
+ * sensors-recorder.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * A shock recorder.  The accelerometer runs at 3200Hz and every sample goes
+ * into the recorder (see recorder/recorder.h).  When the board is knocked the
+ * recorder keeps 10ms from before the knock and 30ms after it, then the
+ * capture is sent down the serial port as comma separated values and plotted
+ * on the display, and the recorder is armed again.
+ *
+ * Either of two things triggers it: any axis going over 1.5g, or the ADXL345
+ * activity interrupt, which watches for a change of more than 1g from the
+ * resting values so it works whichever way up the board is.  The interrupt
+ * comes in on INT0; the samples that set it off are still in the FIFO, so the
+ * trigger lands on the last sample read after it, within a few samples of the
+ * knock.
+ *
+ * The wiring is the same as sensors-spi.c, only the accelerometer and the
+ * display are used, plus the accelerometer's INT1 pin and the serial port.
+ *
+ * The SPI lines are connected as follows:
+ *    SCK  - Arduino 13 (ATMEGA PORTB5)
+ *    MOSI - Arduino 11 (ATMEGA PORTB3)
+ *    MISO - Arduino 12 (ATMEGA PORTB4)
+ *    CE   - Arduino 10 (ATMEGA PORTB2), display chip select
+ *    DC   - Arduino 9 (ATMEGA PORTB1), display data/command
+ *    CS   - Arduino 8 (ATMEGA PORTB0), accelerometer chip select
+ *    INT1 - Arduino 2 (ATMEGA PORTD2), accelerometer activity interrupt
+ *    TX   - Arduino 1 (ATMEGA PORTD1), 115200 baud
+ *
+ * This file is free software; you can redistribute it and/or modify it under
+ * the terms of either the GNU General Public License version 3 or the GNU
+ * Lesser General Public License version 3, both as published by the Free
+ * Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include "spi/spi.h"
+#include "adxl345/adxl345_spi.h"
+#include "fmt/fmt.h"
+#include "serial/serial.h"
+#include "print/print.h"
+#include "display/display.h"
+#include "display/display_spi.h"
+#include "display/display_list.h"
+#include "recorder/recorder.h"
+
+/* samples kept before and after the trigger, 10ms and 30ms at 3200Hz */
+#define RECORD_PRE  32
+#define RECORD_POST 96
+
+/* the software trigger, 1.5g in steps of 3.9mg */
+#define RECORD_THRESHOLD 384
+
+/* the activity trigger, 1g in steps of 62.5mg */
+#define ACTIVITY_THRESHOLD 16
+
+/* the plot takes the bottom seven pages, the text is on the top one */
+#define PLOT_PAGE0  1
+#define PLOT_TOP    (PLOT_PAGE0 * 8)
+#define PLOT_HALF   ((DISPLAY_HEIGHT - PLOT_TOP) / 2 - 1)
+#define PLOT_ZERO   (PLOT_TOP + PLOT_HALF)
+
+/* the string the display list points at */
+static char peakStr[6];
+
+/* how far plot_page() shifts each axis right, set by show_capture() */
+static uint8_t plotShift;
+
+/* set by the activity interrupt */
+static volatile uint8_t activity;
+
+/* ISR(INT0_vect)
+
+   The accelerometer saw activity.  Leave it to the main loop, which knows
+   which samples have been read.
+*/
+ISR(INT0_vect)
+{
+  activity = 1;
+
+}/* end ISR(INT0_vect) */
+
+/* send_capture()
+
+   Send the capture as one line per sample: the sample number counted from
+   the trigger, then X, Y and Z in steps of 3.9mg.
+*/
+static void send_capture(void)
+{
+  int16_t xyz[3];
+  uint8_t length = recorder_length();
+  uint8_t trigger = recorder_trigger_index();
+  uint8_t i;
+
+  PRINT(&print_serial, PRINT_P("\r\nn,x,y,z\r\n"));
+  for(i = 0; i < length; i++)
+  {
+    recorder_get(i, xyz);
+    PRINT(&print_serial, (int16_t)i - trigger, ",", xyz[0], ",", xyz[1], ",", xyz[2], PRINT_P("\r\n"));
+  }
+
+}/* end send_capture() */
+
+/* plot_page()
+
+   Plot the three axes of the capture into one page of the display, over what
+   the display list drew.  The zero line is dotted every 4 pixels and the
+   trigger is marked with a dotted line every 2.  Each axis is shifted right
+   by plotShift so the biggest value fits the plot.  Called by
+   display_list_send_over() for each page.
+*/
+static void plot_page(uint8_t page, uint8_t *buf)
+{
+  int16_t xyz[3];
+  uint8_t length = recorder_length();
+  uint8_t column, i, axis;
+  int16_t y;
+
+  if(page < PLOT_PAGE0)
+  {
+    return;
+  }
+
+  if((PLOT_ZERO >> 3) == page)
+  {
+    for(column = 0; column < DISPLAY_WIDTH; column += 4)
+    {
+      buf[column] |= _BV(PLOT_ZERO & 7);
+    }
+  }
+
+  column = (uint16_t)recorder_trigger_index() * DISPLAY_WIDTH / length;
+  buf[column] |= 0x55;
+
+  for(i = 0; i < length; i++)
+  {
+    recorder_get(i, xyz);
+    column = (uint16_t)i * DISPLAY_WIDTH / length;
+
+    for(axis = 0; axis < 3; axis++)
+    {
+      y = PLOT_ZERO - (xyz[axis] >> plotShift);
+      if((y >> 3) == page)
+      {
+        buf[column] |= _BV(y & 7);
+      }
+    }
+  }
+
+}/* end plot_page() */
+
+/* show_capture()
+
+   Draw the peak value and the plot, a page at a time through the display
+   list's page buffer.
+*/
+static void show_capture(void)
+{
+  int16_t xyz[3];
+  int16_t peak = 0;
+  uint8_t length = recorder_length();
+  uint8_t i, axis;
+
+/* find the biggest value on any axis */
+  for(i = 0; i < length; i++)
+  {
+    recorder_get(i, xyz);
+    for(axis = 0; axis < 3; axis++)
+    {
+      if(xyz[axis] > peak)
+      {
+        peak = xyz[axis];
+      }
+      else if(-xyz[axis] > peak)
+      {
+        peak = -xyz[axis];
+      }
+    }
+  }
+
+  plotShift = 0;
+  while((peak >> plotShift) > PLOT_HALF)
+  {
+    plotShift++;
+  }
+
+  fmt_dec16(fmt_scale(peak, FMT_SCALE_ADXL345_MG), 5, peakStr);
+
+  display_list_send_over(display_spi_write_page, plot_page);
+
+}/* end show_capture() */
+
+/* arm()
+
+   Throw away what is in the FIFO, clear the activity interrupt and start
+   again.
+*/
+static void arm(int16_t *accelFifo)
+{
+  while(adxl345_spi_readFifo(accelFifo, ADXL_FIFO_SIZE) != 0)
+  {
+  }
+
+  cli();
+  adxl345_spi_getInterruptSource();
+  activity = 0;
+  sei();
+
+  recorder_arm(RECORD_PRE, RECORD_POST, RECORD_THRESHOLD);
+
+}/* end arm() */
+
+int main(void)
+{
+/* samples drained from the accelerometer FIFO, three axes per sample */
+  int16_t accelFifo[ADXL_FIFO_SIZE * 3];
+  uint8_t accelCount;
+
+  serial_init(115200);
+
+/* Initialize the SPI bus.  The display and the accelerometer share it, each
+   registers its own settings with spibus so the bus can be switched between
+   them. */
+  spi_init((SPI_SPCR_SPE | SPI_SPCR_DORD_MSB | SPI_SPCR_MSTR | SPI_SPCR_MODE3 | SPI_SPCR_DIV2), SPI_SPSR_SPI2X);
+
+/* Initialize the accelerometer.
+
+    power it up
+    set data format to full resolution and +/-16g, so a knock isn't clipped;
+    full resolution keeps 3.9mg a step in every range
+    set data rate to 3200Hz
+    FIFO in stream mode, it keeps the newest 32 samples (10ms)
+    activity on any axis, AC coupled, on INT1
+ */
+  adxl345_spi_init(&PORTB, PORTB0);
+  adxl345_spi_setDataFormat(ADXL_DATA_FORMAT_FULL_RES | ADXL_DATA_FORMAT_RANGE_16);
+  adxl345_spi_setBWRate(ADXL_BW_RATE_3200);
+  adxl345_spi_setFifoControl(ADXL_FIFO_CTL_STREAM);
+  adxl345_spi_setActivity(ACTIVITY_THRESHOLD, ADXL_ACT_AC | ADXL_ACT_X | ADXL_ACT_Y | ADXL_ACT_Z);
+  adxl345_spi_setInterrupts(ADXL_INT_ACTIVITY, 0);
+  adxl345_spi_setPowerControl(ADXL_POWER_CTL_MEASURE);
+
+/* INT0 on the rising edge of INT1 */
+  EICRA = _BV(ISC01) | _BV(ISC00);
+  EIMSK = _BV(INT0);
+
+/* Initialize the display.  There is no frame buffer to set up. */
+  display_spi_init(&PORTB, PORTB2, &PORTB, PORTB1);
+  display_spi_flip_vertical();
+
+/* Describe the text, the plot is drawn over it. */
+  display_list_add_text_P(0, 0, 1, DISPLAY_WHITE, PSTR("SHOCK  peak:"));
+  display_list_add_text(72, 0, 1, DISPLAY_WHITE, peakStr);
+  display_list_add_text_P(104, 0, 1, DISPLAY_WHITE, PSTR("mg"));
+  display_list_send(display_spi_write_page);
+
+  sei();
+
+  arm(accelFifo);
+
+/* Repeatedly empty the accelerometer FIFO into the recorder. */
+  while(1)
+  {
+    accelCount = adxl345_spi_readFifo(accelFifo, ADXL_FIFO_SIZE);
+    if(recorder_add_block(accelFifo, accelCount) == RECORDER_ARMED && activity)
+    {
+      recorder_trigger();
+    }
+
+    if(recorder_state() == RECORDER_DONE)
+    {
+      send_capture();
+      show_capture();
+      arm(accelFifo);
+    }
+
+  }/* end while(1) */
+
+}/* end main() */
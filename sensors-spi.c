@@ -4,10 +4,26 @@
  * Created: 2017-07-31
  * Author : Craig Hollinger
  *
- * This is an example program that uses the I2C bus to read data from sensors
- * and display it on an SPI OLED display.  The sensors are an accelerometer,
- * a gyroscope and a magnetometer.  Each sensor has three axes of data and 
- * communicates on the I2C bus.  The OLED display communicates on the SPI bus.
+ * This is an example program that reads data from sensors and displays it on
+ * an SPI OLED display.  The sensors are an accelerometer, a gyroscope and a
+ * magnetometer, each with three axes of data.  The gyroscope and magnetometer
+ * communicate on the I2C bus.  The accelerometer shares the SPI bus with the
+ * OLED display, which lets it run at its full 3200Hz data rate.  Its FIFO
+ * holds the samples until the loop comes around to collect them.
+ *
+ * Rather than showing single noisy readings, the sensors are oversampled and
+ * decimated.  Every accelerometer sample goes through a second order CIC
+ * filter that gives one output per 64 samples, 50 per second, and each output
+ * updates the display.  Between display updates the gyroscope is read as
+ * often as the loop comes around and averaged in blocks of 16.
+ *
+ * The display is sent in the background by the SPI interrupt, so the loop
+ * goes back to reading the gyroscope while the last frame goes out.
+ *
+ * Built with PROFILE defined, the stages of each update are timed (see
+ * profile/profile.h).  Every 64 updates the updates per second and the
+ * slowest stage replace the title, and the table of stages is sent out of
+ * the serial port (Arduino 1, ATMEGA PORTD1) at 115200 baud.
  *
  * The I2C lines are connected as follows:
  *    SCL - Arduino A5 (ATMEGA PORTC5)
@@ -16,8 +32,10 @@
  * The SPI lines are connected as follows:
  *    SCK  - Arduino 13 (ATMEGA PORTB5)
  *    MOSI - Arduino 11 (ATMEGA PORTB3)
- *    CE   - Arduino 10 (ATMEGA PORTB2)
- *    DC   - Arduino 9 (ATMEGA PORTB1)
+ *    MISO - Arduino 12 (ATMEGA PORTB4)
+ *    CE   - Arduino 10 (ATMEGA PORTB2), display chip select
+ *    DC   - Arduino 9 (ATMEGA PORTB1), display data/command
+ *    CS   - Arduino 8 (ATMEGA PORTB0), accelerometer chip select
  *
  * This file is free software; you can redistribute it and/or modify it under
  * the terms of either the GNU General Public License version 3 or the GNU
@@ -26,46 +44,96 @@
  */ 
 
 #include <avr/io.h>
-#include <stdlib.h>
+#include <avr/interrupt.h>
 #include "i2c/i2c.h"
 #include "spi/spi.h"
-#include "adxl345/adxl345.h"
+#include "adxl345/adxl345_spi.h"
 #include "hmc5883/hmc5883.h"
 #include "itg3205/itg3205.h"
-#include "graphics/graphics.h"
-#include "ssd1306/ssd1306_spi.h"
+#include "cordic/cordic.h"
+#include "compass/compass.h"
+#include "fmt/fmt.h"
+#include "decimate/decimate.h"
+#include "display/display.h"
+#include "display/display_spi.h"
+#include "display/display_field.h"
+#include "profile/profile.h"
+#ifdef PROFILE
+#include "serial/serial.h"
+#include "print/print.h"
+#endif
+
+/* Decimation ratios, as powers of 2.  3200Hz / 64 gives 50 display updates per
+   second. */
+#define ACCEL_DECIMATE_SHIFT 6
+#define GYRO_DECIMATE_SHIFT 4
 
-/* These define the string formatting for the itoa() function. */
-#define HEX_FORMAT 16
-#define DEC_FORMAT 10
-#define OCT_FORMAT 8
+/* The stages of each display update timed when PROFILE is defined (see
+   profile/profile.h), and how many updates between reports. */
+#define STAGE_READ   0
+#define STAGE_MATH   1
+#define STAGE_FIELDS 2
+#define STAGE_UPDATE 3
+#define STAGE_REPORT 4
+
+#define PROFILE_REPORT_LOOPS 64
 
 int main(void)
 {
 /* temporary storage for raw data read from a sensor, two bytes per axis  */
   uint8_t sensorBuf[6];
   
-/* temporary storage for a formatted string from itoa() */
-  char tempStr[8];
+/* the fields showing the data, each is only redrawn when its value
+   changes */
+  Display_Field accelField[3], gyroField[3], magField[3];
+  Display_Field headingField, mgField;
 
 /* temporary storage for 16-bit raw sensor data */
   int16_t sensorXData, sensorYData, sensorZData;
 
+/* the accelerometer and magnetometer data, X, Y and Z, kept for working out
+   the heading */
+  int16_t accelData[3] = {0, 0, 0}, magData[3];
+
+/* samples drained from the accelerometer FIFO, three axes per sample */
+  int16_t accelFifo[ADXL_FIFO_SIZE * 3];
+  uint8_t accelCount, i;
+
+/* decimated accelerometer and gyroscope data, X, Y and Z */
+  int16_t gyroData[3] = {0, 0, 0}, gyroRaw[3];
+  uint8_t accelReady;
+
+/* decimation filter state */
+  Decimate_Cic accelFilter;
+  Decimate_Avg gyroFilter;
+
+/* what is worked out from the sensors */
+  int16_t heading, magnitude;
+
+#ifdef PROFILE
+  uint8_t profileLoops = 0;
+#endif
+
 /* initialize the I2C bus for the sensors */
   i2c_init(400000UL);
 
-/* initialize the SPI bus for the display */
+/* Initialize the SPI bus for the display.  The display and the accelerometer
+   share the bus, each registers its own settings with spibus so the bus can
+   be switched between them. */
   spi_init((SPI_SPCR_SPE | SPI_SPCR_DORD_MSB | SPI_SPCR_MSTR | SPI_SPCR_MODE3 | SPI_SPCR_DIV2), SPI_SPSR_SPI2X);
 
 /* Initialize the accelerometer.
    
     power it up
     set data format to full resolution and +/-16g
-    set data rate to 12.5Hz
+    set data rate to 3200Hz
+    FIFO in stream mode, it keeps the newest 32 samples (10ms)
  */
-  adxl345_setDataFormat(ADXL_DATA_FORMAT_FULL_RES | ADXL_DATA_FORMAT_RANGE_02);
-  adxl345_setBWRate(ADXL_BW_RATE_0012);
-  adxl345_setPowerControl(ADXL_POWER_CTL_MEASURE);
+  adxl345_spi_init(&PORTB, PORTB0);
+  adxl345_spi_setDataFormat(ADXL_DATA_FORMAT_FULL_RES | ADXL_DATA_FORMAT_RANGE_02);
+  adxl345_spi_setBWRate(ADXL_BW_RATE_3200);
+  adxl345_spi_setFifoControl(ADXL_FIFO_CTL_STREAM);
+  adxl345_spi_setPowerControl(ADXL_POWER_CTL_MEASURE);
 
 /* Initialize the gyroscope.
  */
@@ -83,74 +151,95 @@ int main(void)
                HMC5883_MODE_NS|HMC5883_MODE_CONT);
 
 /* Initialize the display.
-   Setup the display in graphics mode.
+   Clear the frame buffer, only the parts of it that change are sent.
  */
-  ssd1306_spi_init(&PORTB, PORTB2, &PORTB, PORTB1);
-  ssd1306_spi_flip_vertical();
-  graphics_init(SSD1306_GRAPHICS_MAX_X, SSD1306_GRAPHICS_MAX_Y);
-  graphics_set_text_size(2);
-  graphics_set_rotation(GRAPHICS_ROTATION_0);
-
-/* Draw the labels on the screen. */
-  graphics_draw_filled_rectangle(0, 0, 127, 20);
-  graphics_set_cursor(21, 2);
-  graphics_putStr("SENSORS");
-  graphics_set_text_size(1);
-  graphics_set_cursor(0, 27);
-  graphics_putStr("Acc:");
-  graphics_set_cursor(0, 37);
-  graphics_putStr("Gyr:");
-  graphics_set_cursor(0, 47);
-  graphics_putStr("Mag:");
-  ssd1306_spi_graphics_update();
+  display_spi_init(&PORTB, PORTB2, &PORTB, PORTB1);
+  display_spi_flip_vertical();
+  display_init();
+  display_set_text_size(2);
+
+/* Draw the labels on the screen, the title in black on a white bar. */
+  display_draw_filled_rectangle(0, 0, 127, 20, DISPLAY_WHITE);
+  display_set_text_colour(DISPLAY_BLACK);
+  display_set_cursor(21, 2);
+  display_putStr("SENSORS");
+  display_set_text_colour(DISPLAY_WHITE);
+  display_set_text_size(1);
+  display_set_cursor(0, 27);
+  display_putStr("Acc:");
+  display_set_cursor(0, 37);
+  display_putStr("Gyr:");
+  display_set_cursor(0, 47);
+  display_putStr("Mag:");
+  display_set_cursor(0, 57);
+  display_putStr("Hdg:");
+  display_set_cursor(64, 57);
+  display_putStr("mg:");
+  display_spi_update();
+
+/* Set up the fields for the data, three to a row. */
+  for(i = 0; i < 3; i++)
+  {
+    display_field_init(&accelField[i], 28 + 36 * i, 27, 4, DISPLAY_FIELD_HEX, DISPLAY_FIELD_NO_SCALE);
+    display_field_init(&gyroField[i], 28 + 36 * i, 37, 4, DISPLAY_FIELD_HEX, DISPLAY_FIELD_NO_SCALE);
+    display_field_init(&magField[i], 28 + 36 * i, 47, 4, DISPLAY_FIELD_HEX, DISPLAY_FIELD_NO_SCALE);
+  }
+  display_field_init(&headingField, 28, 57, 3, DISPLAY_FIELD_UDEC, DISPLAY_FIELD_NO_SCALE);
+  display_field_init(&mgField, 88, 57, 5, DISPLAY_FIELD_DEC, FMT_SCALE_ADXL345_MG);
+
+  decimate_cic_init(&accelFilter, ACCEL_DECIMATE_SHIFT);
+  decimate_avg_init(&gyroFilter, GYRO_DECIMATE_SHIFT);
+
+/* enable the interrupt system, the display updates run on the SPI
+   interrupt */
+  sei();
+
+/* Start timing the stages of the loop.  The table goes out of the serial
+   port. */
+#ifdef PROFILE
+  serial_init(115200);
+#endif
+  PROFILE_INIT();
+  PROFILE_NAME(STAGE_READ, "read");
+  PROFILE_NAME(STAGE_MATH, "math");
+  PROFILE_NAME(STAGE_FIELDS, "fields");
+  PROFILE_NAME(STAGE_UPDATE, "update");
+  PROFILE_NAME(STAGE_REPORT, "report");
+  PROFILE_START();
 
 /* Repeatedly read the sensors and send the data to the display. */
   while(1) 
   {
-  /* Read the accelerometer, format and display the data. */
-    adxl345_getAccelData(sensorBuf);
-    sensorXData = (int16_t)sensorBuf[1] << 8;
-    sensorXData += (int16_t)sensorBuf[0];
-    sensorYData = (int16_t)sensorBuf[3] << 8;
-    sensorYData += (int16_t)sensorBuf[2];
-    sensorZData = (int16_t)sensorBuf[5] << 8;
-    sensorZData += (int16_t)sensorBuf[4];
-
-    graphics_set_cursor(28, 27);
-    itoa(sensorXData, tempStr, HEX_FORMAT);
-    graphics_putStr(tempStr);
-
-    graphics_set_cursor(64, 27);
-    itoa(sensorYData, tempStr, HEX_FORMAT);
-    graphics_putStr(tempStr);
-
-    graphics_set_cursor(100, 27);
-    itoa(sensorZData, tempStr, HEX_FORMAT);
-    graphics_putStr(tempStr);
-
-  /* Read the gyroscope, format and display the data. */
+  /* Read the gyroscope into its decimation filter.  It is on the I2C bus, so
+     this overlaps with the display update started on the last pass. */
     itg3205_getGyroData(sensorBuf);
-    sensorXData = (int16_t)sensorBuf[1] << 8;
-    sensorXData += (int16_t)sensorBuf[0];
-    sensorYData = (int16_t)sensorBuf[3] << 8;
-    sensorYData += (int16_t)sensorBuf[2];
-    sensorZData = (int16_t)sensorBuf[5] << 8;
-    sensorZData += (int16_t)sensorBuf[4];
-
-    graphics_set_cursor(28, 37);
-    itoa(sensorXData, tempStr, HEX_FORMAT);
-    graphics_putStr(tempStr);
-
-    graphics_set_cursor(64, 37);
-    itoa(sensorYData, tempStr, HEX_FORMAT);
-    graphics_putStr(tempStr);
-
-    graphics_set_cursor(100, 37);
-    itoa(sensorZData, tempStr, HEX_FORMAT);
-    graphics_putStr(tempStr);
-
-  /* Read the magnetometer, format and display the data.  The data for each axis
-     is read MSB first. */
+    gyroRaw[0] = (int16_t)sensorBuf[1] << 8;
+    gyroRaw[0] += (int16_t)sensorBuf[0];
+    gyroRaw[1] = (int16_t)sensorBuf[3] << 8;
+    gyroRaw[1] += (int16_t)sensorBuf[2];
+    gyroRaw[2] = (int16_t)sensorBuf[5] << 8;
+    gyroRaw[2] += (int16_t)sensorBuf[4];
+    decimate_avg_add(&gyroFilter, gyroRaw, gyroData);
+
+  /* Empty the accelerometer FIFO into its decimation filter.  If the last
+     frame is still going out to the display this waits for the SPI bus. */
+    accelReady = DECIMATE_BUSY;
+    accelCount = adxl345_spi_readFifo(accelFifo, ADXL_FIFO_SIZE);
+    for(i = 0; i < accelCount; i++)
+    {
+      if(decimate_cic_add(&accelFilter, &accelFifo[i * 3], accelData) == DECIMATE_READY)
+      {
+        accelReady = DECIMATE_READY;
+      }
+    }
+
+  /* Only update the display when a new accelerometer output is ready. */
+    if(accelReady == DECIMATE_BUSY)
+    {
+      continue;
+    }
+
+  /* Read the magnetometer.  The data for each axis is read MSB first. */
     hmc5883_getMagData(sensorBuf);
     sensorXData = (int16_t)sensorBuf[0] << 8;
     sensorXData += (int16_t)sensorBuf[1];
@@ -159,20 +248,68 @@ int main(void)
     sensorZData = (int16_t)sensorBuf[4] << 8;
     sensorZData += (int16_t)sensorBuf[5];
 
-    graphics_set_cursor(28, 47);
-    itoa(sensorXData, tempStr, HEX_FORMAT);
-    graphics_putStr(tempStr);
+  /* The HMC5883 sends its axes in the order X, Z, Y, so sensorYData is really
+     the Z axis. */
+    magData[0] = sensorXData;
+    magData[1] = sensorZData;
+    magData[2] = sensorYData;
+
+  /* The read stage takes in every pass of the loop since the last update. */
+    PROFILE_LAP(STAGE_READ);
+
+  /* Work out the tilt compensated heading in degrees and the total
+     acceleration in mg (3.9mg per count at full resolution). */
+    heading = COMPASS_DEGREES(compass_heading(accelData, magData));
+    magnitude = cordic_magnitude3(accelData[0], accelData[1], accelData[2]);
+
+    PROFILE_LAP(STAGE_MATH);
+
+  /* Display the data.  Fields that haven't changed since the last frame are
+     skipped.  The magnetometer fields are in the order the chip sends
+     them. */
+    for(i = 0; i < 3; i++)
+    {
+      display_field_set(&accelField[i], accelData[i]);
+      display_field_set(&gyroField[i], gyroData[i]);
+    }
+    display_field_set(&magField[0], sensorXData);
+    display_field_set(&magField[1], sensorYData);
+    display_field_set(&magField[2], sensorZData);
+    display_field_set(&headingField, heading);
+    display_field_set(&mgField, magnitude);
+
+    PROFILE_LAP(STAGE_FIELDS);
+
+#ifdef PROFILE
+  /* Now and again show the updates per second and the slowest stage in the
+     title bar, and send the whole table down the serial port. */
+    if(++profileLoops == PROFILE_REPORT_LOOPS)
+    {
+      profileLoops = 0;
+
+      display_draw_filled_rectangle(0, 0, 127, 20, DISPLAY_WHITE);
+      display_set_text_colour(DISPLAY_BLACK);
+      display_set_cursor(2, 7);
+      PROFILE_SUMMARY(&print_display);
+      display_set_text_colour(DISPLAY_WHITE);
+
+      PROFILE_PRINT(&print_serial);
+      PROFILE_RESET();
+    }
 
-    graphics_set_cursor(64, 47);
-    itoa(sensorYData, tempStr, HEX_FORMAT);
-    graphics_putStr(tempStr);
+    PROFILE_LAP(STAGE_REPORT);
+#endif
 
-    graphics_set_cursor(100, 47);
-    itoa(sensorZData, tempStr, HEX_FORMAT);
-    graphics_putStr(tempStr);
+  /* Everything is written to the frame buffer, now start sending the changes
+     to the display in the background.  If nothing changed there is nothing
+     to send.  This holds the SPI bus, but even a
+     full frame takes only about 8.5ms and the accelerometer FIFO holds 10ms
+     of samples, so none are lost.  Only starting it is timed; the transfer
+     runs on the interrupt and its time lands in whatever stage it
+     interrupts. */
+    display_spi_start();
 
-  /* everything is written to the graphics RAM, now send it to the display */
-    ssd1306_spi_graphics_update();
+    PROFILE_LAP(STAGE_UPDATE);
 
   }/* end while(1) */
 
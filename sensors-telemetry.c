@@ -0,0 +1,186 @@
+/*
+ * sensors-telemetry.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Streams every raw sample from the three sensors out the serial port at 1M
+ * baud, as binary records (see telemetry/telemetry.h), for capture on a PC
+ * with tools/telemetry-decode.c:
+ *
+ *    accelerometer  3200 a second, from its FIFO over SPI
+ *    gyroscope      1000 a second, over I2C
+ *    magnetometer   15 a second, over I2C
+ *
+ * That is about 63,000 bytes a second, well inside the 100,000 the link can
+ * carry.  The display isn't used, so the SPI bus is left to the
+ * accelerometer.
+ *
+ * Timer 1 runs at F_CPU/8, 0.5us a tick, and every record carries its time.
+ * The accelerometer samples come out of the FIFO together, so each is given
+ * the time of the read less 312.5us (625 ticks) for each newer sample behind
+ * it.
+ *
+ * Build with SERIAL_TX_SIZE=256; it won't compile without it.  That holds 17
+ * of the 15-byte records, not a whole FIFO of 32 (480 bytes), so this relies
+ * on the loop emptying the FIFO often: each pass takes well under a millisecond, so only a few
+ * samples are waiting each time and the buffer drains at 150us a record in
+ * between.  If the buffer does fill, records are dropped, not delayed, and
+ * the decoder reports the gaps.
+ *
+ * The I2C lines are connected as follows:
+ *    SCL - Arduino A5 (ATMEGA PORTC5)
+ *    SDA - Arduino A4 (ATMEGA PORTC4)
+ *
+ * The SPI lines are connected as follows:
+ *    SCK  - Arduino 13 (ATMEGA PORTB5)
+ *    MOSI - Arduino 11 (ATMEGA PORTB3)
+ *    MISO - Arduino 12 (ATMEGA PORTB4)
+ *    CS   - Arduino 8 (ATMEGA PORTB0), accelerometer chip select
+ *
+ * The serial port (TX, Arduino 1) goes to a USB serial adapter that can run
+ * at 1M baud.
+ *
+ * This file is free software; you can redistribute it and/or modify it under
+ * the terms of either the GNU General Public License version 3 or the GNU
+ * Lesser General Public License version 3, both as published by the Free
+ * Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "i2c/i2c.h"
+#include "spi/spi.h"
+#include "adxl345/adxl345_spi.h"
+#include "hmc5883/hmc5883.h"
+#include "itg3205/itg3205.h"
+#include "serial/serial.h"
+#include "telemetry/telemetry.h"
+
+/* with the 64 byte default only 4 records fit, and most of the
+   accelerometer's samples would be dropped */
+#if SERIAL_TX_SIZE < 256
+#error "build sensors-telemetry.c with SERIAL_TX_SIZE=256"
+#endif
+
+/* Timer 1 ticks between accelerometer samples at 3200Hz, and between
+   gyroscope reads at 1kHz */
+#define ACCEL_TICKS 625
+#define GYRO_TICKS  2000
+
+/* gyroscope reads between magnetometer reads, 1000 / 67 is about 15Hz */
+#define MAG_DIVIDE 67
+
+int main(void)
+{
+/* temporary storage for raw data read from a sensor, two bytes per axis  */
+  uint8_t sensorBuf[6];
+
+/* samples drained from the accelerometer FIFO, three axes per sample */
+  int16_t accelFifo[ADXL_FIFO_SIZE * 3];
+  uint8_t accelCount, i;
+
+/* the gyroscope and magnetometer data, X, Y and Z */
+  int16_t gyroData[3], magData[3];
+
+/* when the FIFO was read, and when the gyroscope is next due */
+  uint16_t now, gyroTime;
+  uint8_t magCount = 0;
+
+/* initialize the serial port at 1M baud, UBRR0 = 1 at 16MHz */
+  serial_init(1000000UL);
+  telemetry_init();
+
+/* initialize the I2C bus for the gyroscope and magnetometer */
+  i2c_init(400000UL);
+
+/* initialize the SPI bus for the accelerometer */
+  spi_init((SPI_SPCR_SPE | SPI_SPCR_DORD_MSB | SPI_SPCR_MSTR | SPI_SPCR_MODE3 | SPI_SPCR_DIV2), SPI_SPSR_SPI2X);
+
+/* Initialize the accelerometer.
+
+    power it up
+    set data format to full resolution and +/-16g, still 3.9mg a step, so
+    the raw stream is never clipped
+    set data rate to 3200Hz
+    FIFO in stream mode, it keeps the newest 32 samples (10ms)
+ */
+  adxl345_spi_init(&PORTB, PORTB0);
+  adxl345_spi_setDataFormat(ADXL_DATA_FORMAT_FULL_RES | ADXL_DATA_FORMAT_RANGE_16);
+  adxl345_spi_setBWRate(ADXL_BW_RATE_3200);
+  adxl345_spi_setFifoControl(ADXL_FIFO_CTL_STREAM);
+  adxl345_spi_setPowerControl(ADXL_POWER_CTL_MEASURE);
+
+/* Initialize the gyroscope.
+ */
+  itg3205_setPowerMgmt(ITG3205_PWR_MGMT_RESET|ITG3205_PWR_MGMT_PLLZ);
+  itg3205_setSampleRate(ITG3205_FS_SEL|ITG3205_DLPF_20HZ);
+
+/* Initialize the magnetometer.
+
+    average = 1, data rate = 15Hz
+    gain = 1.3 Ga
+    speed = normal, mode = continuous
+ */
+  hmc5883_init(HMC5883_AVRG_1|HMC5883_DORT_1500|HMC5883_MESC_NORM,
+               HMC5883_GAIN_092,
+               HMC5883_MODE_NS|HMC5883_MODE_CONT);
+
+/* Timer 1 counts at F_CPU/8, no interrupts */
+  TCCR1A = 0;
+  TCCR1B = _BV(CS11);
+
+/* enable the interrupt system, the serial port sends on its interrupt */
+  sei();
+
+  gyroTime = TCNT1;
+
+/* Send every sample as it arrives. */
+  while(1)
+  {
+  /* Empty the accelerometer FIFO, oldest sample first. */
+    now = TCNT1;
+    accelCount = adxl345_spi_readFifo(accelFifo, ADXL_FIFO_SIZE);
+    for(i = 0; i < accelCount; i++)
+    {
+      telemetry_send(TELEMETRY_ACCEL, now - (uint16_t)(accelCount - 1 - i) * ACCEL_TICKS, &accelFifo[i * 3]);
+    }
+
+  /* Read the gyroscope every 1ms, and the magnetometer every 67th time. */
+    if((uint16_t)(TCNT1 - gyroTime) < GYRO_TICKS)
+    {
+      continue;
+    }
+    gyroTime += GYRO_TICKS;
+
+    now = TCNT1;
+    itg3205_getGyroData(sensorBuf);
+    gyroData[0] = (int16_t)sensorBuf[1] << 8;
+    gyroData[0] += (int16_t)sensorBuf[0];
+    gyroData[1] = (int16_t)sensorBuf[3] << 8;
+    gyroData[1] += (int16_t)sensorBuf[2];
+    gyroData[2] = (int16_t)sensorBuf[5] << 8;
+    gyroData[2] += (int16_t)sensorBuf[4];
+    telemetry_send(TELEMETRY_GYRO, now, gyroData);
+
+    if(++magCount < MAG_DIVIDE)
+    {
+      continue;
+    }
+    magCount = 0;
+
+  /* The data for each axis is read MSB first, and the axes come out in the
+     order X, Z, Y.  They are sent as X, Y, Z. */
+    now = TCNT1;
+    hmc5883_getMagData(sensorBuf);
+    magData[0] = (int16_t)sensorBuf[0] << 8;
+    magData[0] += (int16_t)sensorBuf[1];
+    magData[2] = (int16_t)sensorBuf[2] << 8;
+    magData[2] += (int16_t)sensorBuf[3];
+    magData[1] = (int16_t)sensorBuf[4] << 8;
+    magData[1] += (int16_t)sensorBuf[5];
+    telemetry_send(TELEMETRY_MAG, now, magData);
+
+  }/* end while(1) */
+
+}/* end main() */
@@ -0,0 +1,352 @@
+/*
+ * serial.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Buffered, interrupt driven transmit and receive on USART 0.  See serial.h.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include "serial.h"
+
+#define SERIAL_TX_MASK (SERIAL_TX_SIZE - 1)
+#define SERIAL_RX_MASK (SERIAL_RX_SIZE - 1)
+
+/* SERIAL_ISR_ENTER(), SERIAL_ISR_EXIT()
+
+   Mark an interrupt in ddsContext, and put it back, for the DDS latency
+   measurement.  Nothing unless DDS_LATENCY is defined.  ENTER comes first in
+   the interrupt, before interrupts can be turned on.
+*/
+#ifdef DDS_LATENCY
+extern volatile uint8_t ddsContext;
+#define SERIAL_ISR_ENTER(context) uint8_t savedContext = ddsContext; ddsContext = (context)
+#define SERIAL_ISR_EXIT() (ddsContext = savedContext)
+#else
+#define SERIAL_ISR_ENTER(context)
+#define SERIAL_ISR_EXIT()
+#endif
+
+/* The ring buffer.  Only the program moves the head and only the interrupt
+   moves the tail, so neither needs interrupts turned off.  It is empty when
+   they are equal. */
+static volatile char txBuffer[SERIAL_TX_SIZE];
+static volatile uint8_t txHead;
+static volatile uint8_t txTail;
+
+/* the most bytes in the buffer, and whether anything has been sent since the
+   last flush */
+static uint8_t txHighWater;
+static uint8_t txSent;
+
+/* The receive ring buffer.  This time the interrupt moves the head and the
+   program the tail. */
+static volatile char rxBuffer[SERIAL_RX_SIZE];
+static volatile uint8_t rxHead;
+static volatile uint8_t rxTail;
+static volatile uint8_t rxOverruns;
+
+/* serial_send_next()
+
+   Move the byte at the tail of the buffer into the data register, clearing
+   the transmit complete flag for serial_flush().  When the buffer is empty
+   turn the interrupt off.  UDR0 must be empty.
+*/
+static inline void serial_send_next(void)
+{
+  uint8_t tail = txTail;
+
+  if(tail == txHead)
+  {
+    UCSR0B &= ~_BV(UDRIE0);
+    return;
+  }
+
+  UDR0 = txBuffer[tail];
+  UCSR0A = _BV(U2X0) | _BV(TXC0);
+  txTail = (tail + 1) & SERIAL_TX_MASK;
+
+}/* end serial_send_next() */
+
+/* serial_init()
+
+   Double speed mode, the baud rate divisor rounded to the nearest.
+*/
+void serial_init(uint32_t baud)
+{
+  txHead = txTail = 0;
+  txHighWater = 0;
+  txSent = 0;
+  rxHead = rxTail = 0;
+  rxOverruns = 0;
+
+  UBRR0 = (uint16_t)((F_CPU + baud * 4) / (baud * 8) - 1);
+  UCSR0A = _BV(U2X0);
+  UCSR0C = _BV(UCSZ01) | _BV(UCSZ00);
+  UCSR0B = _BV(TXEN0);
+
+}/* end serial_init() */
+
+/* serial_putchar()
+
+   Wait for room, put the character in and make sure the interrupt is on.
+   While waiting with interrupts off, send from the buffer by hand.
+*/
+void serial_putchar(char c)
+{
+  uint8_t head = txHead;
+  uint8_t next = (head + 1) & SERIAL_TX_MASK;
+  uint8_t used;
+
+  while(next == txTail)
+  {
+    if(bit_is_clear(SREG, SREG_I) && bit_is_set(UCSR0A, UDRE0))
+    {
+      serial_send_next();
+    }
+  }
+
+  txBuffer[head] = c;
+  txHead = next;
+  txSent = 1;
+
+  used = (next - txTail) & SERIAL_TX_MASK;
+  if(used > txHighWater)
+  {
+    txHighWater = used;
+  }
+
+  UCSR0B |= _BV(UDRIE0);
+
+}/* end serial_putchar() */
+
+/* serial_putstr()
+
+   Put each character of a string in RAM in the buffer.
+*/
+void serial_putstr(const char *str)
+{
+  while(*str != '\0')
+  {
+    serial_putchar(*str++);
+  }
+
+}/* end serial_putstr() */
+
+/* serial_putstr_P()
+
+   Put each character of a string in flash in the buffer.
+*/
+void serial_putstr_P(const char *str)
+{
+  char c;
+
+  while((c = pgm_read_byte(str++)) != '\0')
+  {
+    serial_putchar(c);
+  }
+
+}/* end serial_putstr_P() */
+
+/* serial_write()
+
+   Put each byte in the buffer.
+*/
+void serial_write(const uint8_t *data, uint8_t length)
+{
+  while(length-- > 0)
+  {
+    serial_putchar((char)*data++);
+  }
+
+}/* end serial_write() */
+
+/* serial_tx_free()
+
+   The size of the buffer less what is in it, less the byte always kept
+   free.
+*/
+uint8_t serial_tx_free(void)
+{
+  return((uint8_t)((txTail - txHead - 1) & SERIAL_TX_MASK));
+
+}/* end serial_tx_free() */
+
+/* serial_flush()
+
+   Wait for the buffer to empty, then for the transmit complete flag, which
+   is only worth waiting for if something has been sent.
+*/
+void serial_flush(void)
+{
+  while(txHead != txTail)
+  {
+    if(bit_is_clear(SREG, SREG_I) && bit_is_set(UCSR0A, UDRE0))
+    {
+      serial_send_next();
+    }
+  }
+
+  if(txSent)
+  {
+    loop_until_bit_is_set(UCSR0A, TXC0);
+    txSent = 0;
+  }
+
+}/* end serial_flush() */
+
+/* serial_tx_high_water(), serial_tx_reset_high_water()
+
+   Read and reset the high water mark.
+*/
+uint8_t serial_tx_high_water(void)
+{
+  return(txHighWater);
+
+}/* end serial_tx_high_water() */
+
+void serial_tx_reset_high_water(void)
+{
+  txHighWater = 0;
+
+}/* end serial_tx_reset_high_water() */
+
+/* serial_rx_enable()
+
+   The receiver and its interrupt on, leaving the transmitter as it is.
+*/
+void serial_rx_enable(void)
+{
+  UCSR0B |= _BV(RXEN0) | _BV(RXCIE0);
+
+}/* end serial_rx_enable() */
+
+uint8_t serial_available(void)
+{
+  return((uint8_t)((rxHead - rxTail) & SERIAL_RX_MASK));
+
+}/* end serial_available() */
+
+/* serial_getchar()
+
+   Wait for a byte, then take it from the tail.
+*/
+char serial_getchar(void)
+{
+  uint8_t tail = rxTail;
+  char c;
+
+  while(tail == rxHead)
+  {
+  }
+
+  c = rxBuffer[tail];
+  rxTail = (tail + 1) & SERIAL_RX_MASK;
+
+  return(c);
+
+}/* end serial_getchar() */
+
+uint8_t serial_rx_overruns(void)
+{
+  return(rxOverruns);
+
+}/* end serial_rx_overruns() */
+
+/* serial_rx_overrun()
+
+   Count a lost byte.
+*/
+static inline void serial_rx_overrun(void)
+{
+  if(rxOverruns != 255)
+  {
+    rxOverruns++;
+  }
+
+}/* end serial_rx_overrun() */
+
+/* USART 0 data register empty interrupt.  Send the next byte.
+
+   With SERIAL_ISR_NOBLOCK, the default, the interrupt turns itself off before turning
+   interrupts on, as the flag stays set until the buffer is empty, and turns
+   itself back on if there is more to send.  The program can't add to the
+   buffer until this returns, so it can't be missed.
+*/
+ISR(USART_UDRE_vect)
+{
+  SERIAL_ISR_ENTER(SERIAL_CONTEXT_UDRE);
+
+#ifdef SERIAL_ISR_NOBLOCK
+  UCSR0B &= ~_BV(UDRIE0);
+  sei();
+
+  serial_send_next();
+  if(txTail != txHead)
+  {
+    UCSR0B |= _BV(UDRIE0);
+  }
+#else
+  serial_send_next();
+#endif
+
+  SERIAL_ISR_EXIT();
+
+}/* end ISR(USART_UDRE_vect) */
+
+/* USART 0 receive complete interrupt.  Grab the byte and put it in the
+   buffer, or count it as lost if the buffer is full.
+
+   With SERIAL_ISR_NOBLOCK the byte is read first, then the interrupt turns
+   itself off and interrupts on.  If the USART is holding a second byte it
+   would otherwise come straight back in and store the bytes in the wrong
+   order.  When it turns itself back on the buffer is up to date, so another
+   byte can come in on top.
+*/
+ISR(USART_RX_vect)
+{
+  uint8_t status, head, next;
+  char c;
+  SERIAL_ISR_ENTER(SERIAL_CONTEXT_RX);
+
+/* the status has to be read before the data */
+  status = UCSR0A;
+  c = UDR0;
+
+#ifdef SERIAL_ISR_NOBLOCK
+  UCSR0B &= ~_BV(RXCIE0);
+  sei();
+#endif
+
+  if(status & _BV(DOR0))
+  {
+    serial_rx_overrun();
+  }
+
+  head = rxHead;
+  next = (head + 1) & SERIAL_RX_MASK;
+  if(next == rxTail)
+  {
+    serial_rx_overrun();
+  }
+  else
+  {
+    rxBuffer[head] = c;
+    rxHead = next;
+  }
+
+#ifdef SERIAL_ISR_NOBLOCK
+  UCSR0B |= _BV(RXCIE0);
+#endif
+
+  SERIAL_ISR_EXIT();
+
+}/* end ISR(USART_RX_vect) */
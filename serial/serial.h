@@ -0,0 +1,157 @@
+/*
+ * serial.h
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Buffered, interrupt driven USART 0.  serial_putstr() copies the
+ * string into a ring buffer and returns.  The data register empty interrupt
+ * sends the bytes one at a time while the program gets on with something
+ * else.  A call only waits if the buffer fills up.  At 115200 baud a byte
+ * takes 87us, about 1,400 cycles the program used to spend waiting.
+ *
+ * Constant strings can be sent from flash with serial_putstr_P() and PSTR(),
+ * so they don't take up RAM.  Every string literal passed to serial_putstr()
+ * is copied into RAM at start up.
+ *
+ * The buffer is SERIAL_TX_SIZE bytes, one of which is always kept free.
+ * serial_tx_high_water() shows the most that has been in it, to see if it
+ * can be made smaller or needs to be bigger.  Set SERIAL_TX_SIZE when
+ * building to change it.
+ *
+ * Interrupts must be enabled with sei() for the bytes to be sent in the
+ * background.  With interrupts off, a full buffer is emptied by polling so
+ * nothing locks up.
+ *
+ * Receiving is turned on with serial_rx_enable().  The receive interrupt only
+ * puts the byte in a second ring buffer, SERIAL_RX_SIZE bytes; working out
+ * what it means is left to the program, with serial_available() and
+ * serial_getchar().
+ *
+ * The AVR has no interrupt priorities: while one interrupt runs every other
+ * one waits.  So both interrupts turn their own interrupt off, turn
+ * interrupts back on and only then get on with the buffer
+ * (SERIAL_ISR_NOBLOCK, defined below unless the build defines
+ * SERIAL_ISR_BLOCKING).  Any other interrupt, such as a timer driving a DDS,
+ * only waits for the part before that, estimated at about 25 cycles
+ * including the register saves, instead of the whole of the serial
+ * interrupt.  It costs a few cycles more per byte and a little stack, as
+ * another interrupt can now run on top.  Build with SERIAL_ISR_BLOCKING
+ * defined for plain interrupts that run to the end with interrupts off.
+ *
+ * Built with DDS_LATENCY defined, for pwmVariableDDS.c, each interrupt puts
+ * SERIAL_CONTEXT_RX or SERIAL_CONTEXT_UDRE in the program's ddsContext while
+ * it runs, and puts the old value back on the way out, so a DDS sample held
+ * up by it is charged to it.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef SERIAL_H_
+#define SERIAL_H_
+
+#include <avr/io.h>
+
+/* the interrupts turn interrupts back on early, unless asked not to */
+#ifndef SERIAL_ISR_BLOCKING
+#define SERIAL_ISR_NOBLOCK
+#endif
+
+/* size of the transmit buffer, a power of 2 up to 256 */
+#ifndef SERIAL_TX_SIZE
+#define SERIAL_TX_SIZE 64
+#endif
+
+#if (SERIAL_TX_SIZE & (SERIAL_TX_SIZE - 1)) || (SERIAL_TX_SIZE > 256)
+#error "SERIAL_TX_SIZE must be a power of 2 up to 256"
+#endif
+
+/* size of the receive buffer, a power of 2 up to 256 */
+#ifndef SERIAL_RX_SIZE
+#define SERIAL_RX_SIZE 32
+#endif
+
+#if (SERIAL_RX_SIZE & (SERIAL_RX_SIZE - 1)) || (SERIAL_RX_SIZE > 256)
+#error "SERIAL_RX_SIZE must be a power of 2 up to 256"
+#endif
+
+/* the serial interrupts' contexts for DDS_LATENCY, after the program's own */
+#define SERIAL_CONTEXT_RX   4
+#define SERIAL_CONTEXT_UDRE 5
+
+/* serial_init()
+
+   Set up USART 0 for 'baud', 8 data bits, no parity and one stop bit, and
+   turn on the transmitter.
+*/
+void serial_init(uint32_t baud);
+
+/* serial_putchar(), serial_putstr(), serial_putstr_P()
+
+   Put a character, a string in RAM, or a string in flash in the buffer.  Only
+   waits if there isn't room for it.
+*/
+void serial_putchar(char c);
+void serial_putstr(const char *str);
+void serial_putstr_P(const char *str);
+
+/* serial_write()
+
+   Put 'length' bytes of binary data in the buffer, zeros included.  Only
+   waits if there isn't room for them.
+*/
+void serial_write(const uint8_t *data, uint8_t length);
+
+/* serial_tx_free()
+
+   How many bytes can be put in the buffer without waiting.  A program that
+   must not be held up checks this first and drops what doesn't fit.
+*/
+uint8_t serial_tx_free(void);
+
+/* serial_flush()
+
+   Wait until everything in the buffer has been sent and the last stop bit
+   has gone out, for example before going to sleep or changing the baud rate.
+*/
+void serial_flush(void);
+
+/* serial_tx_high_water(), serial_tx_reset_high_water()
+
+   The most bytes that have been waiting in the buffer since start up or the
+   last reset.  If it reaches SERIAL_TX_SIZE - 1 the buffer has filled up and
+   the program has had to wait.
+*/
+uint8_t serial_tx_high_water(void);
+void serial_tx_reset_high_water(void);
+
+/* serial_rx_enable()
+
+   Turn on the receiver and its interrupt.  Call it after serial_init().
+*/
+void serial_rx_enable(void);
+
+/* serial_available()
+
+   How many received bytes are waiting in the buffer.
+*/
+uint8_t serial_available(void);
+
+/* serial_getchar()
+
+   Take the oldest byte out of the buffer, waiting for one if it is empty.
+*/
+char serial_getchar(void);
+
+/* serial_rx_overruns()
+
+   The number of bytes thrown away since start up because the buffer was
+   full, or because the USART's own two byte buffer overflowed before the
+   interrupt got to it.  It stops at 255.
+*/
+uint8_t serial_rx_overruns(void);
+
+#endif /* SERIAL_H_ */
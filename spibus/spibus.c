@@ -0,0 +1,111 @@
+/*
+ * spibus.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Arbitration for a SPI bus shared by more than one device.  See spibus.h.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <util/atomic.h>
+#include "spibus.h"
+
+/* the SPI register settings for each owner */
+static uint8_t ownerSpcr[SPIBUS_MAX_OWNERS];
+static uint8_t ownerSpsr[SPIBUS_MAX_OWNERS];
+
+/* who holds the bus now, and whose settings are loaded in the SPI registers */
+static volatile uint8_t busOwner = SPIBUS_OWNER_NONE;
+static uint8_t busConfig = SPIBUS_OWNER_NONE;
+
+/* spibus_register()
+
+   Save the SPCR and SPSR settings used when 'owner' has the bus.
+*/
+void spibus_register(uint8_t owner, uint8_t spcr, uint8_t spsr)
+{
+  ownerSpcr[owner] = spcr;
+  ownerSpsr[owner] = spsr;
+
+/* force a reload the next time this owner gets the bus */
+  if(busConfig == owner)
+  {
+    busConfig = SPIBUS_OWNER_NONE;
+  }
+
+}/* end spibus_register() */
+
+/* spibus_acquire()
+
+   Try to take the bus for 'owner'.  Returns SPIBUS_OK if the bus was free (or
+   already held by 'owner'), SPIBUS_BUSY otherwise.
+*/
+uint8_t spibus_acquire(uint8_t owner)
+{
+  uint8_t result = SPIBUS_BUSY;
+
+/* test and set must not be split by an interrupt that also wants the bus */
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    if((busOwner == SPIBUS_OWNER_NONE) || (busOwner == owner))
+    {
+      busOwner = owner;
+      result = SPIBUS_OK;
+    }
+  }
+
+  if((result == SPIBUS_OK) && (busConfig != owner))
+  {
+    SPCR = ownerSpcr[owner];
+    SPSR = ownerSpsr[owner];
+    busConfig = owner;
+  }
+
+  return(result);
+
+}/* end spibus_acquire() */
+
+/* spibus_release()
+
+   Give the bus back.  Does nothing if 'owner' does not hold it.
+*/
+void spibus_release(uint8_t owner)
+{
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    if(busOwner == owner)
+    {
+      busOwner = SPIBUS_OWNER_NONE;
+    }
+  }
+
+}/* end spibus_release() */
+
+/* spibus_owner()
+
+   Returns the current owner of the bus.
+*/
+uint8_t spibus_owner(void)
+{
+  return(busOwner);
+
+}/* end spibus_owner() */
+
+/* spibus_transfer()
+
+   Send one byte and return the byte received at the same time.
+*/
+uint8_t spibus_transfer(uint8_t data)
+{
+  SPDR = data;
+  loop_until_bit_is_set(SPSR, SPIF);
+
+  return(SPDR);
+
+}/* end spibus_transfer() */
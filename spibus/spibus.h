@@ -0,0 +1,72 @@
+/*
+ * spibus.h
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Arbitration for a SPI bus shared by more than one device.  Each device on
+ * the bus (an owner) registers the SPCR/SPSR settings it needs, then wraps
+ * every transaction in spibus_acquire()/spibus_release().  While one owner
+ * holds the bus nobody else can get it, so a transfer (for example one page of
+ * display data) can never be broken up by another device's chip select.
+ *
+ * The SPI registers are reloaded only when the bus changes hands, so devices
+ * that need different clock rates (the SSD1306 runs at F_CPU/2, the ADXL345
+ * is limited to 5MHz) can share the bus without paying for the switch on
+ * every byte.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef SPIBUS_H_
+#define SPIBUS_H_
+
+#include <avr/io.h>
+
+/* Bus owners.  SPIBUS_OWNER_NONE means the bus is free. */
+#define SPIBUS_OWNER_NONE    0
+#define SPIBUS_OWNER_DISPLAY 1
+#define SPIBUS_OWNER_ACCEL   2
+#define SPIBUS_MAX_OWNERS    3
+
+/* Return values for spibus_acquire(). */
+#define SPIBUS_OK   0
+#define SPIBUS_BUSY 1
+
+/* spibus_register()
+
+   Save the SPCR and SPSR settings used when 'owner' has the bus.
+*/
+void spibus_register(uint8_t owner, uint8_t spcr, uint8_t spsr);
+
+/* spibus_acquire()
+
+   Try to take the bus for 'owner'.  Returns SPIBUS_OK if the bus was free (or
+   already held by 'owner'), SPIBUS_BUSY otherwise.  Never blocks, so it is
+   safe to call from an interrupt service routine.
+*/
+uint8_t spibus_acquire(uint8_t owner);
+
+/* spibus_release()
+
+   Give the bus back.  Does nothing if 'owner' does not hold it.
+*/
+void spibus_release(uint8_t owner);
+
+/* spibus_owner()
+
+   Returns the current owner of the bus, SPIBUS_OWNER_NONE if it is free.
+*/
+uint8_t spibus_owner(void);
+
+/* spibus_transfer()
+
+   Send one byte and return the byte received at the same time.  The caller
+   must hold the bus.
+*/
+uint8_t spibus_transfer(uint8_t data);
+
+#endif /* SPIBUS_H_ */
@@ -0,0 +1,99 @@
+/*
+ * telemetry.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Binary sensor records over the serial port.  See telemetry.h.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <util/crc16.h>
+#include "cobs/cobs.h"
+#include "serial/serial.h"
+#include "telemetry.h"
+
+#if COBS_ENCODED_MAX(TELEMETRY_RECORD_LENGTH) + 1 != TELEMETRY_FRAME_LENGTH
+#error "TELEMETRY_FRAME_LENGTH doesn't match the record"
+#endif
+
+/* the next sequence number and the records dropped */
+static uint16_t sequence;
+static uint16_t dropped;
+
+/* telemetry_put16()
+
+   Store a 16-bit value low byte first.
+*/
+static inline void telemetry_put16(uint8_t *dst, uint16_t value)
+{
+  dst[0] = (uint8_t)value;
+  dst[1] = (uint8_t)(value >> 8);
+
+}/* end telemetry_put16() */
+
+/* telemetry_init()
+
+   Start again.
+*/
+void telemetry_init(void)
+{
+  sequence = 0;
+  dropped = 0;
+
+}/* end telemetry_init() */
+
+/* telemetry_send()
+
+   Check for room first, so a record that won't fit costs almost nothing.
+*/
+uint8_t telemetry_send(uint8_t type, uint16_t time, const int16_t *xyz)
+{
+  uint8_t record[TELEMETRY_RECORD_LENGTH];
+  uint8_t frame[TELEMETRY_FRAME_LENGTH];
+  uint16_t crc = 0xffff;
+  uint8_t i, length;
+
+  if(serial_tx_free() < TELEMETRY_FRAME_LENGTH)
+  {
+    sequence++;
+    dropped++;
+    return(TELEMETRY_DROPPED);
+  }
+
+  record[0] = type;
+  telemetry_put16(&record[1], sequence++);
+  telemetry_put16(&record[3], time);
+  telemetry_put16(&record[5], (uint16_t)xyz[0]);
+  telemetry_put16(&record[7], (uint16_t)xyz[1]);
+  telemetry_put16(&record[9], (uint16_t)xyz[2]);
+
+  for(i = 0; i < TELEMETRY_RECORD_LENGTH - 2; i++)
+  {
+    crc = _crc_ccitt_update(crc, record[i]);
+  }
+  telemetry_put16(&record[11], crc);
+
+  length = cobs_encode(record, TELEMETRY_RECORD_LENGTH, frame);
+  frame[length++] = 0;
+
+  serial_write(frame, length);
+
+  return(TELEMETRY_OK);
+
+}/* end telemetry_send() */
+
+/* telemetry_dropped()
+
+   Returns the count.
+*/
+uint16_t telemetry_dropped(void)
+{
+  return(dropped);
+
+}/* end telemetry_dropped() */
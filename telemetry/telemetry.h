@@ -0,0 +1,72 @@
+/*
+ * telemetry.h
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Binary sensor records sent out the serial port, one for every sample, for
+ * logging on a PC with tools/telemetry-decode.c.  A record is 13 bytes, all
+ * values little endian:
+ *
+ *    0      type, TELEMETRY_ACCEL, TELEMETRY_GYRO or TELEMETRY_MAG
+ *    1, 2   sequence number, one more for every record, sent or not
+ *    3, 4   time the sample was taken, in ticks of the caller's timer
+ *    5..10  raw X, Y and Z
+ *    11, 12 CRC-16/CCITT of bytes 0 to 10 (avr-libc _crc_ccitt_update(),
+ *           starting from 0xffff)
+ *
+ * Each record is COBS encoded (cobs/cobs.h) and ends with a zero, 15 bytes in
+ * all.  At 1M baud that is over 6,000 records a second, enough for the
+ * accelerometer at 3200Hz with the gyroscope and magnetometer as well.  500k
+ * baud just carries the accelerometer alone.
+ *
+ * A record that doesn't fit in the serial transmit buffer is dropped rather
+ * than holding up the program, so the samples keep their timing.  Its
+ * sequence number is still used up, so the decoder sees the gap and counts
+ * it.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <avr/io.h>
+
+/* record types */
+#define TELEMETRY_ACCEL 1
+#define TELEMETRY_GYRO  2
+#define TELEMETRY_MAG   3
+
+/* a record before and after encoding, the frame with its ending zero */
+#define TELEMETRY_RECORD_LENGTH 13
+#define TELEMETRY_FRAME_LENGTH  15
+
+/* telemetry_send() return values */
+#define TELEMETRY_OK      0
+#define TELEMETRY_DROPPED 1
+
+/* telemetry_init()
+
+   Start the sequence numbers from 0 and clear the count of dropped records.
+   The serial port must already be set up with serial_init().
+*/
+void telemetry_init(void);
+
+/* telemetry_send()
+
+   Build, encode and queue a record of 'type' for the sample 'xyz' taken at
+   'time'.  Returns TELEMETRY_DROPPED if there wasn't room for it.
+*/
+uint8_t telemetry_send(uint8_t type, uint16_t time, const int16_t *xyz);
+
+/* telemetry_dropped()
+
+   The number of records dropped since telemetry_init().
+*/
+uint16_t telemetry_dropped(void);
+
+#endif /* TELEMETRY_H_ */
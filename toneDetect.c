@@ -0,0 +1,176 @@
+/*
+ * toneDetect.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Listens for the eight DTMF tones on the ADC input with a bank of Goertzel
+ * filters (see goertzel/goertzel.h), and sends the level of each tone down
+ * the serial port after every block of samples.
+ *
+ * The ADC runs free at F_CPU / 128, so it takes a sample every 13 ADC clocks,
+ * F_SAMPLE (9615) times a second, with nothing but the clock setting the
+ * pace.  The ADC interrupt puts each sample through all the bins.  After
+ * BLOCK_SAMPLES samples, 21ms, the interrupt swaps to a second set of bins
+ * and the main loop works out the levels from the first set and prints them,
+ * while the next block comes in.  If the main loop hasn't finished with a
+ * block by the time the next one is done, that block is thrown away and
+ * counted.
+ *
+ * Timer/Counter 1 counts CPU cycles, and the interrupt times its call to
+ * goertzel_add(), so each line ends with the cost of one sample through all
+ * the bins.  Divide by BIN_COUNT for the cost per bin per sample.
+ *
+ * Output, 115200 baud, one line per block, levels in ADC counts (a sine wave
+ * of amplitude 100 counts, 0.49V peak at AVCC = 5V, reads 100):
+ *
+ *    697,770,852,941,1209,1336,1477,1633,cycles,blocks lost
+ *
+ * pwmDDS.c or pwmVariableDDS.c make a test signal: one tone shows up in one
+ * bin, and in its neighbours only if it is within about 50Hz of them.
+ *
+ * Connections:
+ *    ADC0 (PC0), Arduino A0  - the signal, biased to AVCC / 2
+ *    TX (PD1), Arduino pin 1 - serial port
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include "serial/serial.h"
+#include "print/print.h"
+#include "goertzel/goertzel.h"
+
+/* The sample frequency in Hz, 16MHz / 128 / 13, rounded. */
+#define F_SAMPLE 9615
+
+/* Samples in a block.  The bins are F_SAMPLE / BLOCK_SAMPLES, 47Hz, wide,
+   narrower than the gaps between the DTMF tones. */
+#define BLOCK_SAMPLES 205
+
+/* The tones, low group then high group, and their bins.  There are two sets
+   of bins, one for the interrupt to fill while the main loop reads the
+   other. */
+#define DTMF_BINS \
+  { \
+    GOERTZEL_BIN(697, F_SAMPLE), GOERTZEL_BIN(770, F_SAMPLE), \
+    GOERTZEL_BIN(852, F_SAMPLE), GOERTZEL_BIN(941, F_SAMPLE), \
+    GOERTZEL_BIN(1209, F_SAMPLE), GOERTZEL_BIN(1336, F_SAMPLE), \
+    GOERTZEL_BIN(1477, F_SAMPLE), GOERTZEL_BIN(1633, F_SAMPLE) \
+  }
+#define BIN_COUNT 8
+
+const uint16_t FREQUENCIES[BIN_COUNT] PROGMEM =
+{
+  697, 770, 852, 941, 1209, 1336, 1477, 1633
+};
+
+Goertzel_Bin bins[2][BIN_COUNT] = {DTMF_BINS, DTMF_BINS};
+
+/* the set of bins the interrupt is filling, and the samples in it so far */
+volatile uint8_t active;
+volatile uint8_t sampleCount;
+
+/* set by the interrupt when the other set of bins holds a whole block,
+   cleared by the main loop when it has read them */
+volatile uint8_t blockReady;
+volatile uint16_t blocksLost;
+
+/* CPU cycles taken by goertzel_add() for the last sample */
+volatile uint16_t addCycles;
+
+/* This is the ADC Conversion Complete interrupt service routine.  The ADC is
+   free running, so it runs F_SAMPLE times a second. */
+ISR(ADC_vect)
+{
+  int16_t sample = ADC - 512;
+  uint16_t startCount = TCNT1;
+
+  goertzel_add(bins[active], BIN_COUNT, sample);
+  addCycles = TCNT1 - startCount;
+
+  if(++sampleCount == BLOCK_SAMPLES)
+  {
+    sampleCount = 0;
+
+    if(blockReady)
+    {
+      /* the main loop is still busy with the last block, start again */
+      goertzel_clear(bins[active], BIN_COUNT);
+      blocksLost++;
+    }
+    else
+    {
+      active ^= 1;
+      blockReady = 1;
+    }
+  }
+
+}/* end ISR(ADC_vect) */
+
+/* This is where it all happens. */
+int main(void)
+{
+  Goertzel_Bin *block;
+  uint16_t cycles, lost;
+  uint8_t n;
+
+  /* Set up Timer 1 to count CPU cycles, normal mode, no prescale. */
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);
+
+  /* Set up the ADC:
+     - AVCC reference, input ADC0, result right adjusted
+     - clocked by F_CPU / 128, 125kHz
+     - free running, interrupt after each conversion */
+  ADMUX = _BV(REFS0);
+  ADCSRB = 0; /* free running */
+  DIDR0 = _BV(ADC0D); /* ADC0 is analog only */
+  ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIE) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);
+
+  serial_init(115200);
+
+  /* enable the interrupt system */
+  sei();
+
+  /* start the first conversion, the rest follow on their own */
+  ADCSRA |= _BV(ADSC);
+
+  for(n = 0; n < BIN_COUNT; n++)
+  {
+    PRINT(&print_serial, pgm_read_word(&FREQUENCIES[n]), ",");
+  }
+  PRINT(&print_serial, PRINT_P("cycles,blocks lost\r\n"));
+
+  /* run around this loop for ever, printing the levels of each block */
+  while (1) 
+  {
+    while(!blockReady)
+    {
+    }
+
+    block = bins[active ^ 1];
+
+    cli();
+    cycles = addCycles;
+    lost = blocksLost;
+    sei();
+
+    for(n = 0; n < BIN_COUNT; n++)
+    {
+      PRINT(&print_serial, goertzel_level(&block[n], BLOCK_SAMPLES), ",");
+    }
+
+    /* goertzel_level() has cleared the bins, the interrupt can have them */
+    blockReady = 0;
+
+    PRINT(&print_serial, cycles, ",", lost, PRINT_P("\r\n"));
+
+  }/* end while(1) */
+
+}/* end main() */
@@ -0,0 +1,283 @@
+/*
+ * cordic-test.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Checks cordic/cordic.c and compass/compass.c on a PC against the maths
+ * library, for the accuracy cordic.h and compass.h promise.
+ *
+ *    atan2      - cordic_atan2() over a grid spanning the whole 16-bit input
+ *                 range, and every vector with both parts within +/-64,
+ *                 within 4 LSB
+ *    magnitude  - cordic_magnitude() over the same vectors, within 2 LSB
+ *    magnitude3 - cordic_magnitude3() over a 3D grid spanning the whole
+ *                 range, within 4 LSB
+ *    polar      - cordic_polar() gives the same as the two above
+ *    sincos     - cordic_sincos() for every binary angle, within 10 LSB of
+ *                 Q15
+ *    compass    - compass_heading() for headings all the way round, with
+ *                 the board rolled and pitched up to 60 degrees, on readings
+ *                 scaled like the ADXL345 (256 LSB/g) and the HMC5883 (1090
+ *                 LSB/gauss) and rounded to whole counts
+ *
+ * Build and run:
+ *
+ *    cc -O2 -I. -Itools/host -o cordic-test tools/cordic-test.c cordic/cordic.c compass/compass.c -lm
+ *    ./cordic-test
+ *
+ * tools/host has just enough of avr-libc for the maths modules.  Prints each
+ * check and exits with 1 if any failed.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "cordic/cordic.h"
+#include "compass/compass.h"
+#include "tools/host/check.h"
+
+/* binary angle LSBs in a radian */
+#define BINARY (32768.0 / M_PI)
+
+/* the grid steps through the 16-bit range */
+#define STEP_2D 37
+#define STEP_3D 521
+
+/* the earth's field, north and up, in gauss, and the sensors' scales */
+#define FIELD_NORTH 0.20
+#define FIELD_UP    -0.45
+#define ACCEL_LSB   256.0
+#define MAG_LSB     1090.0
+
+/* the allowed compass error, degrees */
+#define COMPASS_LIMIT 1.5
+
+/* angle_error()
+
+   How far a binary angle is from an angle in radians, in LSB, the long way
+   round the circle not counting.
+*/
+static double angle_error(int16_t angle, double exact)
+{
+  double error = fmod(angle - exact * BINARY, 65536.0);
+
+  if(error > 32768.0)
+  {
+    error -= 65536.0;
+  }
+  else if(error < -32768.0)
+  {
+    error += 65536.0;
+  }
+
+  return(fabs(error));
+
+}/* end angle_error() */
+
+/* worst_2d()
+
+   The worst atan2, magnitude and polar errors at one vector.
+*/
+static void worst_2d(int x, int y, double *angleWorst, double *lengthWorst, int *polarWrong)
+{
+  int16_t angle, polarAngle;
+  uint16_t length;
+  double error;
+
+  angle = cordic_atan2((int16_t)y, (int16_t)x);
+  length = cordic_magnitude((int16_t)x, (int16_t)y);
+
+  if((x != 0) || (y != 0))
+  {
+    error = angle_error(angle, atan2(y, x));
+    *angleWorst = (error > *angleWorst) ? error : *angleWorst;
+  }
+
+  error = fabs(length - hypot(x, y));
+  *lengthWorst = (error > *lengthWorst) ? error : *lengthWorst;
+
+  *polarWrong += (cordic_polar((int16_t)x, (int16_t)y, &polarAngle) != length) ||
+                 (polarAngle != angle);
+
+}/* end worst_2d() */
+
+static void test_2d(void)
+{
+  double angleWorst = 0.0, lengthWorst = 0.0;
+  int x, y, polarWrong = 0;
+  char detail[80];
+
+  for(x = -32768; x <= 32767; x += STEP_2D)
+  {
+    for(y = -32768; y <= 32767; y += STEP_2D)
+    {
+      worst_2d(x, y, &angleWorst, &lengthWorst, &polarWrong);
+    }
+  }
+
+/* the ends of the range and the axes */
+  for(x = -32768; x <= 32767; x += STEP_2D)
+  {
+    worst_2d(x, 0, &angleWorst, &lengthWorst, &polarWrong);
+    worst_2d(0, x, &angleWorst, &lengthWorst, &polarWrong);
+    worst_2d(x, 32767, &angleWorst, &lengthWorst, &polarWrong);
+    worst_2d(32767, x, &angleWorst, &lengthWorst, &polarWrong);
+  }
+
+/* short vectors, where the rounding of the inputs matters most */
+  for(x = -64; x <= 64; x++)
+  {
+    for(y = -64; y <= 64; y++)
+    {
+      worst_2d(x, y, &angleWorst, &lengthWorst, &polarWrong);
+    }
+  }
+
+  sprintf(detail, "worst %.2f LSB, %.4f degrees, limit 4 LSB",
+          angleWorst, angleWorst * 180.0 / 32768.0);
+  check(angleWorst <= 4.0, "atan2", detail);
+  sprintf(detail, "worst %.2f LSB, limit 2", lengthWorst);
+  check(lengthWorst <= 2.0, "magnitude", detail);
+  sprintf(detail, "%d vectors differ from atan2 and magnitude", polarWrong);
+  check(polarWrong == 0, "polar", detail);
+
+}/* end test_2d() */
+
+static void test_magnitude3(void)
+{
+  double exact, error, worst = 0.0;
+  int x, y, z;
+  char detail[80];
+
+  for(x = -32768; x <= 32767; x += STEP_3D)
+  {
+    for(y = -32768; y <= 32767; y += STEP_3D)
+    {
+      for(z = -32768; z <= 32767; z += STEP_3D)
+      {
+        exact = sqrt((double)x * x + (double)y * y + (double)z * z);
+        exact = (exact > 65535.0) ? 65535.0 : exact;
+        error = fabs(cordic_magnitude3((int16_t)x, (int16_t)y, (int16_t)z) - exact);
+        worst = (error > worst) ? error : worst;
+      }
+    }
+  }
+
+  sprintf(detail, "worst %.2f LSB, limit 4", worst);
+  check(worst <= 4.0, "magnitude3", detail);
+
+}/* end test_magnitude3() */
+
+static void test_sincos(void)
+{
+  int16_t sine, cosine;
+  double error, worst = 0.0;
+  long angle;
+  char detail[80];
+
+  for(angle = -32768; angle <= 32767; angle++)
+  {
+    cordic_sincos((int16_t)angle, &sine, &cosine);
+    error = fabs(sine - 32768.0 * sin(angle / BINARY));
+    worst = (error > worst) ? error : worst;
+    error = fabs(cosine - 32768.0 * cos(angle / BINARY));
+    worst = (error > worst) ? error : worst;
+  }
+
+  sprintf(detail, "worst %.2f LSB of Q15, limit 10", worst);
+  check(worst <= 10.0, "sincos", detail);
+
+}/* end test_sincos() */
+
+/* to_body()
+
+   A vector given north, west and up, as the sensors see it on a board
+   turned to 'heading' (clockwise from north), then pitched nose down by
+   'pitch' and rolled right wing down by 'roll', all in radians.  X forward,
+   Y left, Z up, as compass.h wants them.
+*/
+static void to_body(double heading, double pitch, double roll, const double *world, double *body)
+{
+  double yaw = -heading, x, y, z, t;
+
+/* undo the yaw, about Z */
+  x = cos(yaw) * world[0] + sin(yaw) * world[1];
+  y = -sin(yaw) * world[0] + cos(yaw) * world[1];
+  z = world[2];
+
+/* undo the pitch, about Y */
+  t = cos(pitch) * x - sin(pitch) * z;
+  z = sin(pitch) * x + cos(pitch) * z;
+  x = t;
+
+/* undo the roll, about X */
+  t = cos(roll) * y + sin(roll) * z;
+  z = -sin(roll) * y + cos(roll) * z;
+  y = t;
+
+  body[0] = x;
+  body[1] = y;
+  body[2] = z;
+
+}/* end to_body() */
+
+static void test_compass(void)
+{
+  static const double gravity[3] = {0.0, 0.0, 1.0};
+  static const double field[3] = {FIELD_NORTH, 0.0, FIELD_UP};
+  double accelBody[3], magBody[3], error, worst = 0.0, worstAt[3] = {0.0, 0.0, 0.0};
+  int16_t accel[3], mag[3];
+  int heading, pitch, roll, i;
+  char detail[100];
+
+  for(heading = 0; heading < 360; heading += 3)
+  {
+    for(pitch = -60; pitch <= 60; pitch += 5)
+    {
+      for(roll = -60; roll <= 60; roll += 5)
+      {
+        to_body(heading * M_PI / 180.0, pitch * M_PI / 180.0, roll * M_PI / 180.0,
+                gravity, accelBody);
+        to_body(heading * M_PI / 180.0, pitch * M_PI / 180.0, roll * M_PI / 180.0,
+                field, magBody);
+        for(i = 0; i < 3; i++)
+        {
+          accel[i] = (int16_t)lround(accelBody[i] * ACCEL_LSB);
+          mag[i] = (int16_t)lround(magBody[i] * MAG_LSB);
+        }
+
+        error = angle_error(compass_heading(accel, mag), heading * M_PI / 180.0) * 180.0 / 32768.0;
+        if(error > worst)
+        {
+          worst = error;
+          worstAt[0] = heading;
+          worstAt[1] = pitch;
+          worstAt[2] = roll;
+        }
+      }
+    }
+  }
+
+  sprintf(detail, "worst %.2f degrees at heading %.0f pitch %.0f roll %.0f, limit %.1f",
+          worst, worstAt[0], worstAt[1], worstAt[2], COMPASS_LIMIT);
+  check(worst <= COMPASS_LIMIT, "compass", detail);
+
+}/* end test_compass() */
+
+int main(void)
+{
+  test_2d();
+  test_magnitude3();
+  test_sincos();
+  test_compass();
+
+  return(check_status());
+
+}/* end main() */
@@ -0,0 +1,199 @@
+/*
+ * dds-snr.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Works out the signal to noise ratio of the sine waves made by pwmDDS.c
+ * (8-bit Timer 0 PWM, 256 entry table, 50kHz updates) and pwmHiResDDS.c
+ * (10-bit Timer 1 PWM, quarter wave table good to 10 bits of phase, 15,625Hz
+ * updates), on a PC.  It runs the same phase accumulator and table lookups as
+ * the two programs, sample by sample, and compares the PWM values with a
+ * perfect sine wave.
+ *
+ * For each output frequency, 65536 samples are taken, a whole number of turns
+ * of the 16-bit phase accumulator, and the best fitting sine wave at the
+ * frequency the accumulator really makes is taken away.  What is left is
+ * noise and distortion from rounding the amplitude and the phase, so the
+ * ratio is really SINAD.  Noise from the PWM itself (the ripple left by the
+ * output filter) isn't included.  ENOB, the effective number of bits, is
+ * (SINAD - 1.76) / 6.02.
+ *
+ * Build and run:
+ *
+ *    cc -O2 -o dds-snr tools/dds-snr.c -lm
+ *    ./dds-snr [frequency ...]
+ *
+ * The frequencies are in Hz, 100, 440, 1000, 2500 and 5000 if none are
+ * given.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+
+/* samples taken for each frequency, one whole turn of the accumulator */
+#define SAMPLES 65536
+
+/* the 8-bit path, as pwmDDS.c */
+#define F_UPDATE_8 50000
+
+/* the 10-bit path, as pwmHiResDDS.c with a 16MHz clock */
+#define PWM_BITS 10
+#define PWM_TOP ((1 << PWM_BITS) - 1)
+#define F_UPDATE_10 (16000000 / (PWM_TOP + 1))
+
+/* pwmDDS.c's table, copied from there */
+static const uint8_t SINE_TABLE[256] =
+{
+  128, 131, 134, 137, 140, 143, 146, 149, 152, 156, 159, 162, 165, 168, 171, 174,
+  176, 179, 182, 185, 188, 191, 193, 196, 199, 201, 204, 206, 209, 211, 213, 216,
+  218, 220, 222, 224, 226, 228, 230, 232, 234, 236, 237, 239, 240, 242, 243, 245,
+  246, 247, 248, 249, 250, 251, 252, 252, 253, 254, 254, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 254, 254, 253, 252, 252, 251, 250, 249, 248, 247,
+  246, 245, 243, 242, 240, 239, 237, 236, 234, 232, 230, 228, 226, 224, 222, 220,
+  218, 216, 213, 211, 209, 206, 204, 201, 199, 196, 193, 191, 188, 185, 182, 179,
+  176, 174, 171, 168, 165, 162, 159, 156, 152, 149, 146, 143, 140, 137, 134, 131,
+  127, 124, 121, 118, 115, 112, 109, 106, 103, 99, 96, 93, 90, 87, 84, 81,
+  79, 76, 73, 70, 67, 64, 62, 59, 56, 54, 51, 49, 46, 44, 42, 39,
+  37, 35, 33, 31, 29, 27, 25, 23, 21, 19, 18, 16, 15, 13, 12, 10,
+  9, 8, 7, 6, 5, 4, 3, 3, 2, 1, 1, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 1, 1, 2, 3, 3, 4, 5, 6, 7, 8,
+  9, 10, 12, 13, 15, 16, 18, 19, 21, 23, 25, 27, 29, 31, 33, 35,
+  37, 39, 42, 44, 46, 49, 51, 54, 56, 59, 62, 64, 67, 70, 73, 76,
+  79, 81, 84, 87, 90, 93, 96, 99, 103, 106, 109, 112, 115, 118, 121, 124
+};
+
+/* pwmHiResDDS.c's table, filled in by main() with the same formula */
+static uint16_t QUARTER_SINE_TABLE[257];
+
+/* sine()
+
+   Same as pwmHiResDDS.c.
+*/
+static int16_t sine(uint16_t phase)
+{
+  uint8_t quarter = phase >> 14;
+  uint16_t i = (phase >> 6) & 0xff;
+  int16_t value;
+
+  if(quarter & 1)
+  {
+    i = 256 - i;
+  }
+
+  value = (int16_t)QUARTER_SINE_TABLE[i];
+
+  if(quarter & 2)
+  {
+    value = -value;
+  }
+
+  return(value);
+
+}/* end sine() */
+
+/* sample_8(), sample_10()
+
+   One PWM value of each path for a phase, scaled so that full scale is 0 to
+   1.
+*/
+static double sample_8(uint16_t phase)
+{
+  return(SINE_TABLE[phase >> 8] / 256.0);
+
+}/* end sample_8() */
+
+static double sample_10(uint16_t phase)
+{
+  return(((PWM_TOP + 1) / 2 + (sine(phase) >> (16 - PWM_BITS))) / (double)(PWM_TOP + 1));
+
+}/* end sample_10() */
+
+/* sinad()
+
+   Run the accumulator for SAMPLES samples, fit a sine wave, an offset and a
+   cosine at the accumulator's frequency, and return the ratio of the sine
+   wave's power to what is left, in dB.  Over a whole turn of the accumulator
+   the sine, cosine and offset are orthogonal, so each is just a sum.
+*/
+static double sinad(double (*sample)(uint16_t), uint16_t phaseInc)
+{
+  static double x[SAMPLES];
+  double mean = 0.0, a = 0.0, b = 0.0, angle, signal, noise = 0.0, e;
+  uint16_t phase = 0;
+  long n;
+
+  for(n = 0; n < SAMPLES; n++)
+  {
+    phase += phaseInc;
+    x[n] = sample(phase);
+    mean += x[n];
+  }
+  mean /= SAMPLES;
+
+  for(n = 0; n < SAMPLES; n++)
+  {
+    angle = 2.0 * M_PI * (double)((uint16_t)((n + 1) * phaseInc)) / 65536.0;
+    a += (x[n] - mean) * sin(angle);
+    b += (x[n] - mean) * cos(angle);
+  }
+  a *= 2.0 / SAMPLES;
+  b *= 2.0 / SAMPLES;
+
+  for(n = 0; n < SAMPLES; n++)
+  {
+    angle = 2.0 * M_PI * (double)((uint16_t)((n + 1) * phaseInc)) / 65536.0;
+    e = x[n] - mean - a * sin(angle) - b * cos(angle);
+    noise += e * e;
+  }
+  noise /= SAMPLES;
+  signal = (a * a + b * b) / 2.0;
+
+  return(10.0 * log10(signal / noise));
+
+}/* end sinad() */
+
+int main(int argc, char *argv[])
+{
+  static const double defaults[] = {100, 440, 1000, 2500, 5000};
+  double frequency, snr8, snr10;
+  uint16_t inc8, inc10;
+  int i, count;
+
+  for(i = 0; i <= 256; i++)
+  {
+    QUARTER_SINE_TABLE[i] = (uint16_t)lround(32767.0 * sin(M_PI / 2.0 * i / 256.0));
+  }
+
+  count = (argc > 1) ? argc - 1 : (int)(sizeof(defaults) / sizeof(defaults[0]));
+
+  printf("    Hz   8-bit SINAD  ENOB   10-bit SINAD  ENOB   gain\n");
+  for(i = 0; i < count; i++)
+  {
+    frequency = (argc > 1) ? atof(argv[i + 1]) : defaults[i];
+
+  /* the phase increments, worked out the same way as the programs do */
+    inc8 = (uint16_t)(frequency * 65536 / F_UPDATE_8);
+    inc10 = (uint16_t)(frequency * 65536 / F_UPDATE_10);
+    if((inc8 == 0) || (inc10 == 0) || (inc10 >= 32768))
+    {
+      fprintf(stderr, "%g Hz is out of range\n", frequency);
+      continue;
+    }
+
+    snr8 = sinad(sample_8, inc8);
+    snr10 = sinad(sample_10, inc10);
+    printf("%6.0f   %8.1f dB  %4.1f   %9.1f dB  %4.1f  %+5.1f dB\n", frequency,
+           snr8, (snr8 - 1.76) / 6.02, snr10, (snr10 - 1.76) / 6.02, snr10 - snr8);
+  }
+
+  return(0);
+
+}/* end main() */
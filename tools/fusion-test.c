@@ -0,0 +1,405 @@
+/*
+ * fusion-test.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Checks fusion/fusion.c on a PC against Mahony's filter in double
+ * precision, the reference the fixed point code follows step for step.
+ *
+ * A made up flight: the board starts tilted and turned away from north while
+ * the filters start level and pointing north, then it swings about all three
+ * axes for two minutes.  The gyro, accelerometer and magnetometer readings
+ * are worked out from the true attitude, scaled like the ITG3205 (14.375
+ * LSB/deg/s), the ADXL345 (256 LSB/g) and the HMC5883 (1090 LSB/gauss),
+ * with noise and a gyro bias added, and rounded to whole counts.  Both
+ * filters get the same readings at 100Hz, with the gains sensors-ahrs.c
+ * uses.
+ *
+ *    quaternion - the fixed point attitude against the double one, as the
+ *                 angle between them, over the whole run
+ *    euler      - fusion_getEuler() against roll, pitch and yaw worked out
+ *                 from the double quaternion, for pitches up to 70 degrees
+ *    truth      - both against the true attitude, once they have settled
+ *    still      - held still for a minute, the fixed point attitude doesn't
+ *                 wander from the double one
+ *
+ * Build and run:
+ *
+ *    cc -O2 -I. -Itools/host -o fusion-test tools/fusion-test.c fusion/fusion.c cordic/cordic.c -lm
+ *    ./fusion-test
+ *
+ * tools/host has just enough of avr-libc for the maths modules.  Prints each
+ * check and exits with 1 if any failed.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "cordic/cordic.h"
+#include "fusion/fusion.h"
+#include "tools/host/check.h"
+
+/* as sensors-ahrs.c */
+#define RATE       100
+#define KP_SHIFT   6
+#define KI_SHIFT   16
+#define GYRO_LSB   14.375  /* per deg/s */
+#define ACCEL_LSB  256.0   /* per g */
+#define MAG_LSB    1090.0  /* per gauss */
+
+/* the earth's field, north and up, in gauss */
+#define FIELD_NORTH 0.20
+#define FIELD_UP    -0.45
+
+/* the allowed errors, degrees */
+#define QUATERNION_LIMIT 0.5
+#define EULER_LIMIT      0.5
+#define TRUTH_LIMIT      2.0
+
+/* the steepest pitch the Euler angles are compared at, degrees */
+#define EULER_PITCH 70.0
+
+/* seconds for the filters to find the true attitude from level */
+#define SETTLE 40
+
+#define DEGREES(radians) ((radians) * 180.0 / M_PI)
+
+/* gaussian()
+
+   Normally distributed noise, mean 0, standard deviation 1.
+*/
+static double gaussian(void)
+{
+  double u = (rand() + 1.0) / (RAND_MAX + 2.0);
+  double v = (rand() + 1.0) / (RAND_MAX + 2.0);
+
+  return(sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v));
+
+}/* end gaussian() */
+
+/* normalise()
+
+   Scale a quaternion or vector of 'n' elements to unit length.  Returns 0
+   if it is too short.
+*/
+static int normalise(double *v, int n)
+{
+  double length = 0.0;
+  int i;
+
+  for(i = 0; i < n; i++)
+  {
+    length += v[i] * v[i];
+  }
+  length = sqrt(length);
+  if(length == 0.0)
+  {
+    return(0);
+  }
+  for(i = 0; i < n; i++)
+  {
+    v[i] /= length;
+  }
+
+  return(1);
+
+}/* end normalise() */
+
+/* to_body()
+
+   Turn an earth frame vector into the body frame of attitude 'q', the
+   transpose of the rotation q describes.
+*/
+static void to_body(const double *q, const double *e, double *b)
+{
+  double q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3];
+
+  b[0] = (1 - 2 * (q2 * q2 + q3 * q3)) * e[0] + 2 * (q1 * q2 + q0 * q3) * e[1]
+       + 2 * (q1 * q3 - q0 * q2) * e[2];
+  b[1] = 2 * (q1 * q2 - q0 * q3) * e[0] + (1 - 2 * (q1 * q1 + q3 * q3)) * e[1]
+       + 2 * (q2 * q3 + q0 * q1) * e[2];
+  b[2] = 2 * (q1 * q3 + q0 * q2) * e[0] + 2 * (q2 * q3 - q0 * q1) * e[1]
+       + (1 - 2 * (q1 * q1 + q2 * q2)) * e[2];
+
+}/* end to_body() */
+
+/* rotate()
+
+   Turn attitude 'q' by the body rates 'w' (radians per second) for 'dt'
+   seconds.
+*/
+static void rotate(double *q, const double *w, double dt)
+{
+  double q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3];
+  double hx = w[0] * dt / 2, hy = w[1] * dt / 2, hz = w[2] * dt / 2;
+
+  q[0] += -q1 * hx - q2 * hy - q3 * hz;
+  q[1] += q0 * hx + q2 * hz - q3 * hy;
+  q[2] += q0 * hy - q1 * hz + q3 * hx;
+  q[3] += q0 * hz + q1 * hy - q2 * hx;
+  normalise(q, 4);
+
+}/* end rotate() */
+
+/* The double precision Mahony filter, as in Madgwick's reference code,
+   in the same units as fusion.c: the gyro rates as Q30 half-radians per
+   update become half-radians per update here. */
+static double mq[4] = {1.0, 0.0, 0.0, 0.0};
+static double mIntegral[3];
+
+static void mahony_update(const int16_t *gyro, const int16_t *accel, const int16_t *mag)
+{
+  const double scale = M_PI / 180.0 / GYRO_LSB / 2.0 / RATE;
+  double a[3], m[3], g[3], e[3], q0, q1, q2, q3;
+  double hx, hy, bx, bz, vx, vy, vz, wx, wy, wz;
+  int i;
+
+  for(i = 0; i < 3; i++)
+  {
+    g[i] = gyro[i] * scale;
+    a[i] = accel[i];
+    m[i] = mag[i];
+  }
+  q0 = mq[0];
+  q1 = mq[1];
+  q2 = mq[2];
+  q3 = mq[3];
+
+  if(normalise(a, 3))
+  {
+    vx = q1 * q3 - q0 * q2;
+    vy = q0 * q1 + q2 * q3;
+    vz = q0 * q0 - 0.5 + q3 * q3;
+    e[0] = a[1] * vz - a[2] * vy;
+    e[1] = a[2] * vx - a[0] * vz;
+    e[2] = a[0] * vy - a[1] * vx;
+
+    if(normalise(m, 3))
+    {
+      hx = 2.0 * (m[0] * (0.5 - q2 * q2 - q3 * q3) + m[1] * (q1 * q2 - q0 * q3) + m[2] * (q1 * q3 + q0 * q2));
+      hy = 2.0 * (m[0] * (q1 * q2 + q0 * q3) + m[1] * (0.5 - q1 * q1 - q3 * q3) + m[2] * (q2 * q3 - q0 * q1));
+      bx = sqrt(hx * hx + hy * hy);
+      bz = 2.0 * (m[0] * (q1 * q3 - q0 * q2) + m[1] * (q2 * q3 + q0 * q1) + m[2] * (0.5 - q1 * q1 - q2 * q2));
+      wx = bx * (0.5 - q2 * q2 - q3 * q3) + bz * (q1 * q3 - q0 * q2);
+      wy = bx * (q1 * q2 - q0 * q3) + bz * (q0 * q1 + q2 * q3);
+      wz = bx * (q0 * q2 + q1 * q3) + bz * (0.5 - q1 * q1 - q2 * q2);
+      e[0] += m[1] * wz - m[2] * wy;
+      e[1] += m[2] * wx - m[0] * wz;
+      e[2] += m[0] * wy - m[1] * wx;
+    }
+
+    for(i = 0; i < 3; i++)
+    {
+      mIntegral[i] += e[i] / (1L << KI_SHIFT);
+      g[i] += mIntegral[i] + e[i] / (1 << KP_SHIFT);
+    }
+  }
+
+  mq[0] += -q1 * g[0] - q2 * g[1] - q3 * g[2];
+  mq[1] += q0 * g[0] + q2 * g[2] - q3 * g[1];
+  mq[2] += q0 * g[1] - q1 * g[2] + q3 * g[0];
+  mq[3] += q0 * g[2] + q1 * g[1] - q2 * g[0];
+  normalise(mq, 4);
+
+}/* end mahony_update() */
+
+/* angle_between()
+
+   The angle, in degrees, of the rotation from one attitude to the other.
+   q and -q are the same attitude.  Both are made unit length first, the Q15
+   quaternion being a little off, and the angle comes from the lengths of
+   their difference and sum, which stays accurate for tiny angles where
+   acos() of their dot product doesn't.
+*/
+static double angle_between(const double *a, const double *b)
+{
+  double ua[4], ub[4], sign, difference = 0.0, sum = 0.0;
+  int i;
+
+  for(i = 0; i < 4; i++)
+  {
+    ua[i] = a[i];
+    ub[i] = b[i];
+  }
+  normalise(ua, 4);
+  normalise(ub, 4);
+
+  sign = (ua[0] * ub[0] + ua[1] * ub[1] + ua[2] * ub[2] + ua[3] * ub[3] < 0.0) ? -1.0 : 1.0;
+  for(i = 0; i < 4; i++)
+  {
+    difference += (ua[i] - sign * ub[i]) * (ua[i] - sign * ub[i]);
+    sum += (ua[i] + sign * ub[i]) * (ua[i] + sign * ub[i]);
+  }
+
+  return(DEGREES(4.0 * atan2(sqrt(difference), sqrt(sum))));
+
+}/* end angle_between() */
+
+/* fixed_quaternion()
+
+   fusion.c's attitude as doubles.
+*/
+static void fixed_quaternion(double *q)
+{
+  int16_t q15[4];
+  int i;
+
+  fusion_getQuaternion(q15);
+  for(i = 0; i < 4; i++)
+  {
+    q[i] = q15[i] / 32768.0;
+  }
+
+}/* end fixed_quaternion() */
+
+/* euler_error()
+
+   The largest difference, in degrees, between fusion_getEuler() and the
+   roll, pitch and yaw of the double quaternion.  Returns 0 with the pitch
+   beyond +/-EULER_PITCH, close to straight up or down, where roll and yaw
+   run into each other and a tiny change of attitude swings them wildly.
+*/
+static double euler_error(void)
+{
+  double q0 = mq[0], q1 = mq[1], q2 = mq[2], q3 = mq[3], expected[3], error, worst = 0.0;
+  int16_t euler[3];
+  int i;
+
+  expected[0] = atan2(q0 * q1 + q2 * q3, 0.5 - q1 * q1 - q2 * q2);
+  expected[1] = asin(2.0 * (q0 * q2 - q3 * q1));
+  expected[2] = atan2(q0 * q3 + q1 * q2, 0.5 - q2 * q2 - q3 * q3);
+  if(fabs(DEGREES(expected[1])) > EULER_PITCH)
+  {
+    return(0.0);
+  }
+
+  fusion_getEuler(euler);
+  for(i = 0; i < 3; i++)
+  {
+    error = fabs(remainder(euler[i] * 360.0 / 65536.0 - DEGREES(expected[i]), 360.0));
+    worst = (error > worst) ? error : worst;
+  }
+
+  return(worst);
+
+}/* end euler_error() */
+
+/* sensors()
+
+   The raw readings for the true attitude 'q' turning at 'w' radians per
+   second, with noise and a gyro bias.
+*/
+static void sensors(const double *q, const double *w, int16_t *gyro, int16_t *accel, int16_t *mag)
+{
+  static const double bias[3] = {3.0, -2.0, 1.5};/* counts */
+  static const double up[3] = {0.0, 0.0, 1.0};
+  static const double field[3] = {FIELD_NORTH, 0.0, FIELD_UP};
+  double a[3], m[3];
+  int i;
+
+  to_body(q, up, a);
+  to_body(q, field, m);
+  for(i = 0; i < 3; i++)
+  {
+    gyro[i] = (int16_t)lround(DEGREES(w[i]) * GYRO_LSB + bias[i] + gaussian());
+    accel[i] = (int16_t)lround(a[i] * ACCEL_LSB + 2.0 * gaussian());
+    mag[i] = (int16_t)lround(m[i] * MAG_LSB + 2.0 * gaussian());
+  }
+
+}/* end sensors() */
+
+int main(void)
+{
+  /* the true attitude: 30 degrees of roll, 20 of pitch, yaw 100 */
+  double truth[4] = {1.0, 0.0, 0.0, 0.0}, fixed[4], w[3], start[3];
+  double quaternionWorst = 0.0, eulerWorst = 0.0, fixedTruth = 0.0, doubleTruth = 0.0;
+  double stillWorst = 0.0, error;
+  int16_t gyro[3], accel[3], mag[3];
+  char detail[100];
+  long n;
+  int i;
+
+  start[0] = 0.0;
+  start[1] = 0.0;
+  start[2] = 100.0 * M_PI / 180.0;
+  rotate(truth, start, 1.0);
+  start[0] = 30.0 * M_PI / 180.0;
+  start[1] = 20.0 * M_PI / 180.0;
+  start[2] = 0.0;
+  for(i = 0; i < 2; i++)
+  {
+    w[0] = (i == 0) ? start[0] : 0.0;
+    w[1] = (i == 1) ? start[1] : 0.0;
+    w[2] = 0.0;
+    rotate(truth, w, 1.0);
+  }
+
+  fusion_init(FUSION_GYRO_SCALE(GYRO_LSB, RATE), KP_SHIFT, KI_SHIFT);
+  srand(1);
+
+  /* two minutes of swinging, up to nearly straight up and down */
+  for(n = 0; n < 120L * RATE; n++)
+  {
+    double t = (double)n / RATE;
+
+    w[0] = 1.2 * sin(2.0 * M_PI * 0.13 * t);
+    w[1] = 0.5 * sin(2.0 * M_PI * 0.21 * t + 1.0);
+    w[2] = 0.9 * sin(2.0 * M_PI * 0.07 * t + 2.0);
+
+    /* the truth moves in ten smaller steps between samples */
+    for(i = 0; i < 10; i++)
+    {
+      rotate(truth, w, 0.1 / RATE);
+    }
+    sensors(truth, w, gyro, accel, mag);
+
+    fusion_update(gyro, accel, mag);
+    mahony_update(gyro, accel, mag);
+
+    fixed_quaternion(fixed);
+    error = angle_between(fixed, mq);
+    quaternionWorst = (error > quaternionWorst) ? error : quaternionWorst;
+    error = euler_error();
+    eulerWorst = (error > eulerWorst) ? error : eulerWorst;
+
+    if(n >= (long)SETTLE * RATE)
+    {
+      error = angle_between(fixed, truth);
+      fixedTruth = (error > fixedTruth) ? error : fixedTruth;
+      error = angle_between(mq, truth);
+      doubleTruth = (error > doubleTruth) ? error : doubleTruth;
+    }
+  }
+
+  /* a minute held still */
+  w[0] = w[1] = w[2] = 0.0;
+  for(n = 0; n < 60L * RATE; n++)
+  {
+    sensors(truth, w, gyro, accel, mag);
+    fusion_update(gyro, accel, mag);
+    mahony_update(gyro, accel, mag);
+    fixed_quaternion(fixed);
+    error = angle_between(fixed, mq);
+    stillWorst = (error > stillWorst) ? error : stillWorst;
+  }
+
+  sprintf(detail, "worst %.3f degrees apart, limit %.1f", quaternionWorst, QUATERNION_LIMIT);
+  check(quaternionWorst < QUATERNION_LIMIT, "quaternion", detail);
+  sprintf(detail, "worst %.3f degrees apart, limit %.1f", eulerWorst, EULER_LIMIT);
+  check(eulerWorst < EULER_LIMIT, "euler", detail);
+  sprintf(detail, "fixed %.2f, double %.2f degrees from the truth, limit %.1f",
+          fixedTruth, doubleTruth, TRUTH_LIMIT);
+  check((fixedTruth < TRUTH_LIMIT) && (doubleTruth < TRUTH_LIMIT), "truth", detail);
+  sprintf(detail, "worst %.3f degrees apart, limit %.1f", stillWorst, QUATERNION_LIMIT);
+  check(stillWorst < QUATERNION_LIMIT, "still", detail);
+
+  return(check_status());
+
+}/* end main() */
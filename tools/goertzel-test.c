@@ -0,0 +1,300 @@
+/*
+ * goertzel-test.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Checks goertzel/goertzel.c on a PC, against made up signals, the way
+ * toneDetect.c uses it: 10-bit samples less 512, 9615 samples a second,
+ * blocks of 205, the eight DTMF tones.
+ *
+ *    coefficients - GOERTZEL_BIN() against the maths library, for every
+ *                   whole frequency from 1Hz to F_SAMPLE / 2
+ *    accuracy     - sine waves of many frequencies, amplitudes and phases,
+ *                   each level against a Goertzel filter in floating point
+ *    tones        - a tone on each bin reads its amplitude
+ *    DTMF         - all sixteen keys, two tones with noise on top, give the
+ *                   right row and column as the loudest bins
+ *    range        - full scale square waves in long blocks, near 0 and
+ *                   F_SAMPLE / 2, the worst case for the states, don't
+ *                   overflow
+ *
+ * Build and run:
+ *
+ *    cc -O2 -I. -o goertzel-test tools/goertzel-test.c goertzel/goertzel.c -lm
+ *    ./goertzel-test
+ *
+ * Prints each check and exits with 1 if any failed.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "goertzel/goertzel.h"
+#include "tools/host/check.h"
+
+/* as toneDetect.c */
+#define F_SAMPLE      9615
+#define BLOCK_SAMPLES 205
+#define BIN_COUNT     8
+
+static const int FREQUENCIES[BIN_COUNT] =
+{
+  697, 770, 852, 941, 1209, 1336, 1477, 1633
+};
+
+/* the longest block made up */
+#define MAX_SAMPLES 4000
+
+static int16_t samples[MAX_SAMPLES];
+/* make_tone()
+
+   'count' samples of a sine wave, rounded, clipped to the 10-bit ADC's
+   range.  Adds to what is in samples[] if 'add' is set.
+*/
+static void make_tone(double frequency, double amplitude, double phase, int count, int add)
+{
+  double x;
+  int n;
+
+  for(n = 0; n < count; n++)
+  {
+    x = amplitude * sin(2.0 * M_PI * frequency * n / F_SAMPLE + phase);
+    if(add)
+    {
+      x += samples[n];
+    }
+    x = floor(x + 0.5);
+    samples[n] = (int16_t)((x > 511) ? 511 : ((x < -512) ? -512 : x));
+  }
+
+}/* end make_tone() */
+
+/* level_fixed()
+
+   The level of one bin over the first 'count' samples, by goertzel.c.
+*/
+static double level_fixed(Goertzel_Bin bin, int count)
+{
+  int n;
+
+  for(n = 0; n < count; n++)
+  {
+    goertzel_add(&bin, 1, samples[n]);
+  }
+
+  return(goertzel_level(&bin, (uint16_t)count));
+
+}/* end level_fixed() */
+
+/* level_double()
+
+   The same in floating point, with the bin's rounded coefficients, so only
+   the fixed point arithmetic is being checked.  (Close to 0 and
+   F_SAMPLE / 2 the rounded cosine tunes the bin a Hz or so away from the
+   frequency asked for, the cosine changing little with frequency there.)
+*/
+static double level_double(Goertzel_Bin bin, int count)
+{
+  double c = bin.cos / 16384.0;
+  double s, s1 = 0.0, s2 = 0.0;
+  int n;
+
+  for(n = 0; n < count; n++)
+  {
+    s = samples[n] + 2.0 * c * s1 - s2;
+    s2 = s1;
+    s1 = s;
+  }
+
+  return(2.0 * hypot(s1 - c * s2, bin.sin / 16384.0 * s2) / count);
+
+}/* end level_double() */
+
+/* a bin for any frequency, the macro working at run time */
+static Goertzel_Bin make_bin(double frequency)
+{
+  Goertzel_Bin bin = GOERTZEL_BIN(frequency, F_SAMPLE);
+
+  return(bin);
+
+}/* end make_bin() */
+
+static void test_coefficients(void)
+{
+  Goertzel_Bin bin;
+  double w;
+  int f, worst = 0, error, count = 0;
+  char detail[80];
+
+  for(f = 1; f <= F_SAMPLE / 2; f++)
+  {
+    bin = make_bin(f);
+    w = 2.0 * M_PI * f / F_SAMPLE;
+    error = abs(bin.cos - (int)lround(16384.0 * cos(w)));
+    error += abs(bin.sin - (int)lround(16384.0 * sin(w)));
+    worst = (error > worst) ? error : worst;
+    count += (error != 0);
+  }
+
+/* the series is good to 2e-7, so the rounding can only differ from the
+   maths library's when a value is that close to halfway */
+  sprintf(detail, "%d of %d rounded differently, worst by %d LSB of Q14",
+          count, F_SAMPLE / 2, worst);
+  check(worst <= 1, "coefficients", detail);
+
+}/* end test_coefficients() */
+
+static void test_accuracy(void)
+{
+  double frequency, amplitude, fixed, exact, error;
+  int i, count = 0;
+  char detail[80];
+
+  srand(1);
+  for(i = 0; i < 2000; i++)
+  {
+    frequency = 50.0 + rand() % (F_SAMPLE / 2 - 100);
+    amplitude = 1.0 + rand() % 511;
+    make_tone(frequency + rand() % 100 / 50.0 - 1.0, amplitude, rand() % 628 / 100.0,
+              BLOCK_SAMPLES, 0);
+    fixed = level_fixed(make_bin(frequency), BLOCK_SAMPLES);
+    exact = level_double(make_bin(frequency), BLOCK_SAMPLES);
+
+  /* the level is rounded to a whole count, allow that and 0.5% */
+    error = fabs(fixed - exact) - 0.5;
+    error = (error > 0.0) ? error / (amplitude / 200.0) : 0.0;
+    count += (error > 1.0);
+  }
+
+  sprintf(detail, "%d of 2000 off by more than 0.5%% + 1/2 count", count);
+  check(count == 0, "accuracy", detail);
+
+}/* end test_accuracy() */
+
+static void test_tones(void)
+{
+  double level, worst = 0.0;
+  int i, amplitude;
+  char detail[80];
+
+  for(i = 0; i < BIN_COUNT; i++)
+  {
+    for(amplitude = 10; amplitude <= 500; amplitude *= 7)
+    {
+      make_tone(FREQUENCIES[i], amplitude, 1.0, BLOCK_SAMPLES, 0);
+      level = level_fixed(make_bin(FREQUENCIES[i]), BLOCK_SAMPLES);
+      level = fabs(level - amplitude) / amplitude;
+      worst = (level > worst) ? level : worst;
+    }
+  }
+
+  sprintf(detail, "worst error %.1f%% of the amplitude", worst * 100.0);
+  check(worst < 0.05, "tones", detail);
+
+}/* end test_tones() */
+
+static void test_dtmf(void)
+{
+  Goertzel_Bin bins[BIN_COUNT];
+  double low, high, worst = 1.0;
+  uint16_t level[BIN_COUNT];
+  int row, column, i, n, best[2], wrong = 0;
+  char detail[80];
+
+  srand(2);
+  for(row = 0; row < 4; row++)
+  {
+    for(column = 0; column < 4; column++)
+    {
+      make_tone(FREQUENCIES[row], 150, 0.3, BLOCK_SAMPLES, 0);
+      make_tone(FREQUENCIES[4 + column], 200, 2.0, BLOCK_SAMPLES, 1);
+      for(n = 0; n < BLOCK_SAMPLES; n++)
+      {
+        samples[n] += rand() % 101 - 50;
+      }
+
+      for(i = 0; i < BIN_COUNT; i++)
+      {
+        bins[i] = make_bin(FREQUENCIES[i]);
+      }
+      for(n = 0; n < BLOCK_SAMPLES; n++)
+      {
+        goertzel_add(bins, BIN_COUNT, samples[n]);
+      }
+      for(i = 0; i < BIN_COUNT; i++)
+      {
+        level[i] = goertzel_level(&bins[i], BLOCK_SAMPLES);
+      }
+
+    /* the loudest of each group, and how far ahead of the next it is */
+      best[0] = 0;
+      best[1] = 4;
+      for(i = 0; i < BIN_COUNT; i++)
+      {
+        if(level[i] > level[best[i / 4]])
+        {
+          best[i / 4] = i;
+        }
+      }
+      wrong += (best[0] != row) || (best[1] != 4 + column);
+
+      for(i = 0; i < BIN_COUNT; i++)
+      {
+        if(i != best[i / 4])
+        {
+          low = level[i];
+          high = level[best[i / 4]];
+          worst = (high / low < worst || worst == 1.0) ? high / low : worst;
+        }
+      }
+    }
+  }
+
+  sprintf(detail, "%d of 16 keys wrong, loudest bins at least %.1f times the rest",
+          wrong, worst);
+  check(wrong == 0, "DTMF", detail);
+
+}/* end test_dtmf() */
+
+static void test_range(void)
+{
+  static const double frequencies[] = {F_SAMPLE / 200.0, F_SAMPLE / 2.0 - F_SAMPLE / 200.0};
+  double fixed, exact, worst = 0.0;
+  int i, n;
+  char detail[80];
+
+  for(i = 0; i < 2; i++)
+  {
+    make_tone(frequencies[i], 1000.0, 0.0, MAX_SAMPLES, 0);
+    for(n = 0; n < MAX_SAMPLES; n++)
+    {
+      samples[n] = (samples[n] < 0) ? -512 : 511;
+    }
+    fixed = level_fixed(make_bin(frequencies[i]), MAX_SAMPLES);
+    exact = level_double(make_bin(frequencies[i]), MAX_SAMPLES);
+    worst = (fabs(fixed - exact) / exact > worst) ? fabs(fixed - exact) / exact : worst;
+  }
+
+  sprintf(detail, "worst error %.2f%% over %d samples", worst * 100.0, MAX_SAMPLES);
+  check(worst < 0.01, "range", detail);
+
+}/* end test_range() */
+
+int main(void)
+{
+  test_coefficients();
+  test_accuracy();
+  test_tones();
+  test_dtmf();
+  test_range();
+
+  return(check_status());
+
+}/* end main() */
@@ -0,0 +1,23 @@
+/*
+ * io.h
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Just enough of avr-libc's <avr/io.h> to build the maths modules (cordic,
+ * fusion, compass) on a PC for the tests in tools/.  Only the integer types;
+ * a module that touches a register won't build with this, which is the
+ * point.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef HOST_AVR_IO_H_
+#define HOST_AVR_IO_H_
+
+#include <stdint.h>
+
+#endif /* HOST_AVR_IO_H_ */
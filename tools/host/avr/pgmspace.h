@@ -0,0 +1,26 @@
+/*
+ * pgmspace.h
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * avr-libc's <avr/pgmspace.h> for the tests in tools/, see io.h.  A PC has
+ * one address space, so data "in flash" is just const data.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef HOST_AVR_PGMSPACE_H_
+#define HOST_AVR_PGMSPACE_H_
+
+#include <stdint.h>
+
+#define PROGMEM
+#define PSTR(str) (str)
+#define pgm_read_byte(address) (*(const uint8_t *)(address))
+#define pgm_read_word(address) (*(const uint16_t *)(address))
+
+#endif /* HOST_AVR_PGMSPACE_H_ */
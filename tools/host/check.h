@@ -0,0 +1,49 @@
+/*
+ * check.h
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Reporting for the tests in tools/: each check prints one line, its name,
+ * pass or FAIL and what it measured, and main() returns check_status() so
+ * the test exits with 1 if any failed.  Only for a test's own .c file, the
+ * counter is static.
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef HOST_CHECK_H_
+#define HOST_CHECK_H_
+
+#include <stdio.h>
+
+static int checkFailures;
+
+/* check()
+
+   Print one result and count it if it failed.
+*/
+static void check(int ok, const char *name, const char *detail)
+{
+  printf("%-14s %s  %s\n", name, ok ? "pass" : "FAIL", detail);
+  if(!ok)
+  {
+    checkFailures++;
+  }
+
+}/* end check() */
+
+/* check_status()
+
+   The exit status: 0 if every check passed, 1 if any failed.
+*/
+static int check_status(void)
+{
+  return(checkFailures != 0);
+
+}/* end check_status() */
+
+#endif /* HOST_CHECK_H_ */
@@ -0,0 +1,75 @@
+#!/bin/sh
+#
+# ramreport.sh
+#
+# Created: 2026-10-19
+# Author : agent
+#
+# Lists the RAM used by a program when it is built, to see which parts of it
+# take up the 2k of SRAM.  memdiag/memdiag.h reports what is used while it
+# runs.
+#
+#    tools/ramreport.sh program.elf [file.o ...]
+#
+# For the program it prints the size of .data, .bss and .noinit, then every
+# variable in RAM, biggest first, with its section.  For each object file
+# given it prints the RAM its variables take, biggest first, so each module
+# (serial, display, recorder, ...) can be tracked.  Static variables are
+# counted along with global ones.
+#
+# It needs avr-size and avr-nm, from the same toolchain as avr-gcc.  Set NM
+# and SIZE to use others.
+#
+# This file is free software; you can redistribute it and/or modify
+# it under the terms of either the GNU General Public License version 3
+# or the GNU Lesser General Public License version 3, both as
+# published by the Free Software Foundation.
+#
+
+NM=${NM:-avr-nm}
+SIZE=${SIZE:-avr-size}
+
+if [ $# -lt 1 ]; then
+  echo "usage: $0 program.elf [file.o ...]" >&2
+  exit 1
+fi
+
+elf=$1
+shift
+
+# the sections in RAM
+echo "section      bytes"
+$SIZE -A "$elf" | awk '
+  $1 == ".data" || $1 == ".bss" || $1 == ".noinit" {
+    printf "%-10s %7d\n", $1, $2
+    total += $2
+  }
+  END {
+    printf "%-10s %7d of 2048, the rest is for the heap and stack\n", "total", total
+  }'
+
+# Every variable in RAM.  nm gives the address, size, type and name, in
+# decimal; types b, B are .bss (and .noinit), d, D are .data.  The address is
+# in the data space at 0x800000 (8388608) and up, which keeps out anything
+# with the same letters in flash.
+echo
+echo "  bytes  section  variable"
+$NM -S -t d --size-sort -r "$elf" | awk '
+  NF == 4 && $3 ~ /^[bBdD]$/ && $1 + 0 >= 8388608 {
+    printf "%7d  %-7s  %s\n", $2 + 0, ($3 ~ /[bB]/) ? ".bss" : ".data", $4
+  }'
+
+# the variables in each object file, tentative definitions (C) included
+if [ $# -gt 0 ]; then
+  echo
+  echo "  bytes  object"
+  for obj in "$@"; do
+    $NM -S -t d "$obj" | awk -v obj="$obj" '
+      NF == 4 && $3 ~ /^[bBdDC]$/ {
+        total += $2 + 0
+      }
+      END {
+        printf "%7d  %s\n", total, obj
+      }'
+  done | sort -rn
+fi
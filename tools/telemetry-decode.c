@@ -0,0 +1,361 @@
+/*
+ * telemetry-decode.c
+ *
+ * Created: 2026-10-19
+ * Author : agent
+ *
+ * Decodes the binary sensor records sent by telemetry/telemetry.h, for
+ * Linux.  Reads from a serial port, or from a file of bytes captured
+ * earlier, and writes one line of CSV per record to standard output:
+ *
+ *    type,seq,time_us,x,y,z
+ *
+ * where type is accel, gyro or mag, and time_us counts up from the first
+ * record (the 16-bit timestamps are unwrapped, which needs a record at least
+ * every 32ms at the default tick).  With -B the records are written in
+ * binary instead, 18 bytes each, little endian:
+ *
+ *    uint64 time_ns, uint16 seq, uint8 type, uint8 0, int16 x, y, z
+ *
+ * Records lost on the board (sequence numbers skipped) and frames that
+ * arrived damaged (bad length or CRC) are counted and reported on standard
+ * error when the input ends or on Ctrl-C.
+ *
+ * Build and run:
+ *
+ *    cc -O2 -o telemetry-decode tools/telemetry-decode.c
+ *    ./telemetry-decode -b 1000000 /dev/ttyUSB0 > capture.csv
+ *
+ * Options:
+ *    -b baud   serial port speed, 115200, 230400, 500000 or 1000000
+ *              (default 1000000), ignored for files
+ *    -t ns     length of a timestamp tick in ns (default 500, Timer 1 at
+ *              F_CPU/8 on a 16MHz board)
+ *    -B        write binary records instead of CSV
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License version 3
+ * or the GNU Lesser General Public License version 3, both as
+ * published by the Free Software Foundation.
+ */
+
+#include <fcntl.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+/* must match telemetry/telemetry.h */
+#define TELEMETRY_ACCEL 1
+#define TELEMETRY_GYRO  2
+#define TELEMETRY_MAG   3
+#define TELEMETRY_RECORD_LENGTH 13
+
+/* longer frames than this can't be records, they are noise */
+#define FRAME_MAX 64
+
+/* counts for the report */
+static unsigned long records, perType[4], dropped, badFrames;
+static volatile sig_atomic_t stop;
+
+/* crc_ccitt_update()
+
+   The same CRC as avr-libc's _crc_ccitt_update().
+*/
+static uint16_t crc_ccitt_update(uint16_t crc, uint8_t data)
+{
+  data ^= (uint8_t)crc;
+  data ^= (uint8_t)(data << 4);
+
+  return((uint16_t)((((uint16_t)data << 8) | (crc >> 8)) ^ (uint8_t)(data >> 4) ^ ((uint16_t)data << 3)));
+
+}/* end crc_ccitt_update() */
+
+/* cobs_decode()
+
+   Decode a frame, without its ending zero, into 'dst'.  Returns the decoded
+   length, or -1 if the frame is damaged.
+*/
+static int cobs_decode(const uint8_t *src, int length, uint8_t *dst)
+{
+  int in = 0, out = 0, i;
+  uint8_t code;
+
+  while(in < length)
+  {
+    code = src[in++];
+    if((code == 0) || (in + code - 1 > length))
+    {
+      return(-1);
+    }
+    for(i = 1; i < code; i++)
+    {
+      dst[out++] = src[in++];
+    }
+    if((code < 0xff) && (in < length))
+    {
+      dst[out++] = 0;
+    }
+  }
+
+  return(out);
+
+}/* end cobs_decode() */
+
+/* get16()
+
+   A little endian 16-bit value.
+*/
+static uint16_t get16(const uint8_t *src)
+{
+  return((uint16_t)(src[0] | (src[1] << 8)));
+
+}/* end get16() */
+
+/* put_le()
+
+   Write the low 'length' bytes of 'value' little endian.
+*/
+static void put_le(uint64_t value, int length)
+{
+  while(length-- > 0)
+  {
+    putchar((int)(value & 0xff));
+    value >>= 8;
+  }
+
+}/* end put_le() */
+
+/* handle_frame()
+
+   Check and decode a frame, count any gap in the sequence numbers, and write
+   out the record.
+*/
+static void handle_frame(const uint8_t *frame, int length, unsigned tickNs, int binary)
+{
+  static const char *const typeNames[4] = {"?", "accel", "gyro", "mag"};
+  static int started;
+  static uint16_t lastSeq, lastTime;
+  static uint64_t ticks;
+  uint8_t record[FRAME_MAX];
+  uint16_t crc = 0xffff, seq, time, gap;
+  uint64_t timeNs;
+  int i;
+
+  if((cobs_decode(frame, length, record) != TELEMETRY_RECORD_LENGTH) ||
+     (record[0] < TELEMETRY_ACCEL) || (record[0] > TELEMETRY_MAG))
+  {
+    badFrames++;
+    return;
+  }
+  for(i = 0; i < TELEMETRY_RECORD_LENGTH - 2; i++)
+  {
+    crc = crc_ccitt_update(crc, record[i]);
+  }
+  if(crc != get16(&record[11]))
+  {
+    badFrames++;
+    return;
+  }
+
+  seq = get16(&record[1]);
+  time = get16(&record[3]);
+  if(started)
+  {
+    gap = (uint16_t)(seq - lastSeq - 1);
+    if(gap < 0x8000)
+    {
+      dropped += gap;
+    }
+    ticks += (uint16_t)(time - lastTime);
+  }
+  started = 1;
+  lastSeq = seq;
+  lastTime = time;
+
+  records++;
+  perType[record[0]]++;
+  timeNs = ticks * tickNs;
+
+  if(binary)
+  {
+    put_le(timeNs, 8);
+    put_le(seq, 2);
+    put_le(record[0], 1);
+    put_le(0, 1);
+    for(i = 5; i < 11; i++)
+    {
+      putchar(record[i]);
+    }
+  }
+  else
+  {
+    printf("%s,%u,%llu.%03llu,%d,%d,%d\n", typeNames[record[0]], seq,
+           (unsigned long long)(timeNs / 1000), (unsigned long long)(timeNs % 1000),
+           (int16_t)get16(&record[5]), (int16_t)get16(&record[7]), (int16_t)get16(&record[9]));
+  }
+
+}/* end handle_frame() */
+
+/* open_port()
+
+   Set a serial port to raw mode at 'baud'.  Returns -1 if the speed isn't one
+   of the supported ones or the port can't be set.
+*/
+static int open_port(int fd, long baud)
+{
+  struct termios tty;
+  speed_t speed;
+
+  switch(baud)
+  {
+    case 115200:
+      speed = B115200;
+      break;
+
+    case 230400:
+      speed = B230400;
+      break;
+
+    case 500000:
+      speed = B500000;
+      break;
+
+    case 1000000:
+      speed = B1000000;
+      break;
+
+    default:
+      return(-1);
+
+  }/* end switch(baud) */
+
+  if(tcgetattr(fd, &tty) != 0)
+  {
+    return(-1);
+  }
+  cfmakeraw(&tty);
+  cfsetispeed(&tty, speed);
+  cfsetospeed(&tty, speed);
+  tty.c_cc[VMIN] = 1;
+  tty.c_cc[VTIME] = 0;
+  if(tcsetattr(fd, TCSANOW, &tty) != 0)
+  {
+    return(-1);
+  }
+  tcflush(fd, TCIFLUSH);
+
+  return(0);
+
+}/* end open_port() */
+
+/* on_signal()
+
+   Ctrl-C, finish up and report.
+*/
+static void on_signal(int signal)
+{
+  (void)signal;
+  stop = 1;
+
+}/* end on_signal() */
+
+int main(int argc, char **argv)
+{
+  uint8_t buf[4096], frame[FRAME_MAX];
+  unsigned tickNs = 500;
+  long baud = 1000000;
+  int binary = 0, synced = 0, length = 0;
+  int opt, fd;
+  ssize_t count, i;
+  struct sigaction action;
+
+  while((opt = getopt(argc, argv, "b:t:B")) != -1)
+  {
+    switch(opt)
+    {
+      case 'b':
+        baud = strtol(optarg, NULL, 10);
+        break;
+
+      case 't':
+        tickNs = (unsigned)strtoul(optarg, NULL, 10);
+        break;
+
+      case 'B':
+        binary = 1;
+        break;
+
+      default:
+        fprintf(stderr, "usage: %s [-b baud] [-t tick_ns] [-B] port_or_file\n", argv[0]);
+        return(2);
+
+    }/* end switch(opt) */
+  }
+  if(optind != argc - 1)
+  {
+    fprintf(stderr, "usage: %s [-b baud] [-t tick_ns] [-B] port_or_file\n", argv[0]);
+    return(2);
+  }
+
+  fd = open(argv[optind], O_RDONLY | O_NOCTTY);
+  if(fd < 0)
+  {
+    perror(argv[optind]);
+    return(1);
+  }
+  if(isatty(fd) && (open_port(fd, baud) != 0))
+  {
+    fprintf(stderr, "%s: can't set %ld baud\n", argv[optind], baud);
+    return(1);
+  }
+
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = on_signal;
+  sigaction(SIGINT, &action, NULL);
+  sigaction(SIGTERM, &action, NULL);
+
+/* Split the input at the zeros.  Everything before the first zero is the
+   tail of a frame already under way, so it is thrown away. */
+  while(!stop && ((count = read(fd, buf, sizeof(buf))) > 0))
+  {
+    for(i = 0; i < count; i++)
+    {
+      if(buf[i] == 0)
+      {
+        if(synced && (length > 0))
+        {
+          handle_frame(frame, length, tickNs, binary);
+        }
+        synced = 1;
+        length = 0;
+      }
+      else if(length < FRAME_MAX)
+      {
+        frame[length++] = buf[i];
+      }
+      else
+      {
+        if(synced)
+        {
+          badFrames++;
+        }
+        synced = 0;
+        length = 0;
+      }
+    }
+  }
+
+  fflush(stdout);
+  fprintf(stderr, "%lu records (accel %lu, gyro %lu, mag %lu), %lu dropped, %lu damaged\n",
+          records, perType[TELEMETRY_ACCEL], perType[TELEMETRY_GYRO], perType[TELEMETRY_MAG],
+          dropped, badFrames);
+
+  close(fd);
+
+  return(0);
+
+}/* end main() */
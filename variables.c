@@ -15,8 +15,10 @@
  */ 
 
 #include <avr/io.h>
-#include <stdlib.h> /* for ltoa() and sizeof() */
-#include "uart/uart.h"
+#include <avr/interrupt.h>
+#include "serial/serial.h"
+#include "print/print.h"
+#include "memdiag/memdiag.h"
 
 /* Function prototypes */
 void initialize(void);
@@ -24,7 +26,6 @@ void lengths(void);
 void print_int(int arg);
 
 /* Variables */
-char tempStr[10];/* string to hold variables converted to ASCII */
 int global_a = 765, global_b = 4357;
 char c;
 short d;
@@ -84,6 +85,14 @@ int main(void)
   result = add(global_a, global_b);
   print_int(result);
 
+/* show how much of the transmit buffer was used */
+  PRINT(&print_serial, PRINT_P("TX buffer high water: "), serial_tx_high_water(),
+        PRINT_P(" of "), SERIAL_TX_SIZE - 1, PRINT_P("\r\n"));
+
+/* show where the RAM has gone, and how close the stack came to the
+   variables */
+  memdiag_report(&print_serial);
+
 /* wait here forever */
   while (1) 
   {
@@ -97,7 +106,8 @@ int main(void)
  */
 void initialize(void)
 {
-  uart_init(115200, USART_CHAR_SZ_EIGHT, USART_PARITY_NONE, USART_STOP_BIT_ONE);
+  serial_init(115200);
+  sei();
 
 }/* end initialize() */
 
@@ -107,35 +117,12 @@ void initialize(void)
  */
 void lengths(void)
 {
-  ltoa(sizeof(c), tempStr, 10);
-  uart_putstr("Length of char: ");
-  uart_putstr(tempStr);
-  uart_putstr("\r\n");
-
-  ltoa(sizeof(global_b), tempStr, 10);
-  uart_putstr("Length of int: ");
-  uart_putstr(tempStr);
-  uart_putstr("\r\n");
-
-  ltoa(sizeof(d), tempStr, 10);
-  uart_putstr("Length of short: ");
-  uart_putstr(tempStr);
-  uart_putstr("\r\n");
-
-  ltoa(sizeof(e), tempStr, 10);
-  uart_putstr("Length of long: ");
-  uart_putstr(tempStr);
-  uart_putstr("\r\n");
-
-  ltoa(sizeof(f), tempStr, 10);
-  uart_putstr("Length of float: ");
-  uart_putstr(tempStr);
-  uart_putstr("\r\n");
-
-  ltoa(sizeof(g), tempStr, 10);
-  uart_putstr("Length of double: ");
-  uart_putstr(tempStr);
-  uart_putstr("\r\n");
+  PRINT(&print_serial, PRINT_P("Length of char: "), (unsigned)sizeof(c), PRINT_P("\r\n"));
+  PRINT(&print_serial, PRINT_P("Length of int: "), (unsigned)sizeof(global_b), PRINT_P("\r\n"));
+  PRINT(&print_serial, PRINT_P("Length of short: "), (unsigned)sizeof(d), PRINT_P("\r\n"));
+  PRINT(&print_serial, PRINT_P("Length of long: "), (unsigned)sizeof(e), PRINT_P("\r\n"));
+  PRINT(&print_serial, PRINT_P("Length of float: "), (unsigned)sizeof(f), PRINT_P("\r\n"));
+  PRINT(&print_serial, PRINT_P("Length of double: "), (unsigned)sizeof(g), PRINT_P("\r\n"));
 
 }/* end lengths() */
 
@@ -146,10 +133,6 @@ void lengths(void)
  */
 void print_int(int arg)
 {
-  char str[10];
-
-  ltoa(arg, str, 10);
-  uart_putstr(str);
-  uart_putstr("\r\n");
+  PRINT(&print_serial, arg, PRINT_P("\r\n"));
 
 }/* end print_int() */